@@ -0,0 +1,112 @@
+#ifndef WEST_BENCH_BENCHMARK_HPP
+#define WEST_BENCH_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// NOTE: This header replaces the global operator new, so that allocations can be counted. It must
+//       only be included by the source file of a benchmark executable.
+
+namespace west::bench
+{
+	inline size_t allocation_count = 0;
+
+	struct result
+	{
+		std::string_view name;
+		size_t iterations;
+		double ns_per_op;
+		double bytes_per_second;
+		double allocations_per_op;
+	};
+
+	// Writes `res` as one line of JSON to stdout
+	inline void report(result const& res)
+	{
+		printf("{\"name\":\"%.*s\",\"iterations\":%zu,\"ns_per_op\":%.3f,\"bytes_per_second\":%.6g,"
+			"\"allocations_per_op\":%.3f}\n",
+			static_cast<int>(std::size(res.name)),
+			std::data(res.name),
+			res.iterations,
+			res.ns_per_op,
+			res.bytes_per_second,
+			res.allocations_per_op);
+		fflush(stdout);
+	}
+
+	// Prevents the compiler from removing a computation whose result is not used
+	template<class T>
+	inline void do_not_optimize(T const& value)
+	{ asm volatile("" : : "r,m"(value) : "memory"); }
+
+	// Minimum time to run each benchmark. Can be changed through WEST_BENCH_MIN_TIME_MS.
+	inline std::chrono::nanoseconds min_time()
+	{
+		if(auto const val = getenv("WEST_BENCH_MIN_TIME_MS"); val != nullptr)
+		{ return std::chrono::milliseconds{strtoll(val, nullptr, 10)}; }
+		return std::chrono::milliseconds{200};
+	}
+
+	// Calls `f` repeatedly, and doubles the number of calls until the run takes at least min_time().
+	// One call to `f` performs `ops_per_call` operations. `bytes_per_op` is the number of bytes
+	// processed by one operation, or zero if throughput is not meaningful.
+	template<class Func>
+	result run(std::string_view name, size_t bytes_per_op, size_t ops_per_call, Func&& f)
+	{
+		auto const min_duration = min_time();
+		size_t iterations = 1;
+		while(true)
+		{
+			auto const allocations_before = allocation_count;
+			auto const t0 = std::chrono::steady_clock::now();
+			for(size_t k = 0; k != iterations; ++k)
+			{ f(); }
+			auto const t1 = std::chrono::steady_clock::now();
+			auto const allocations = allocation_count - allocations_before;
+
+			if(t1 - t0 >= min_duration || iterations >= (static_cast<size_t>(1) << 40))
+			{
+				auto const ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+				auto const n = static_cast<double>(iterations)*static_cast<double>(ops_per_call);
+				result const ret{
+					.name = name,
+					.iterations = iterations*ops_per_call,
+					.ns_per_op = ns/n,
+					.bytes_per_second = static_cast<double>(bytes_per_op)*n/(ns*1.0e-9),
+					.allocations_per_op = static_cast<double>(allocations)/n
+				};
+				report(ret);
+				return ret;
+			}
+			iterations *= 2;
+		}
+	}
+
+	template<class Func>
+	result run(std::string_view name, size_t bytes_per_op, Func&& f)
+	{ return run(name, bytes_per_op, 1, std::forward<Func>(f)); }
+}
+
+// NOTE: GCC does not know that the global operator new has been replaced
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(size_t size)
+{
+	++west::bench::allocation_count;
+	if(auto const ret = malloc(size); ret != nullptr)
+	{ return ret; }
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{ free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept
+{ free(ptr); }
+
+#endif
@@ -5,8 +5,12 @@
 #include "lib/http_request_handler.hpp"
 #include "lib/http_session_factory.hpp"
 #include "lib/http_server.hpp"
+#include "lib/http_session_counters.hpp"
+#include "lib/admin_service.hpp"
+#include "lib/io_uring_event_monitor.hpp"
 
 #include <string>
+#include <string_view>
 
 namespace
 {
@@ -153,66 +157,32 @@ namespace
 		std::string m_response_body;
 		std::string::iterator m_read_offset;
 	};
-
-	enum class adm_session_status{keep_connection, close_connection};
-
-	constexpr bool is_session_terminated(adm_session_status status)
-	{ return status == adm_session_status::close_connection; }
-
-	template<class CallbackRegistry>
-	struct adm_request_handler
-	{
-		west::io::inet_connection connection;
-		CallbackRegistry registry;
-
-		auto socket_is_ready()
-		{
-			std::array<char, 65536> read_buffer{};
-			auto res = connection.read(read_buffer);
-			if(res.bytes_read == 0)
-			{
-				switch(res.ec)
-				{
-					case west::io::operation_result::operation_would_block:
-						return adm_session_status::keep_connection;
-					case west::io::operation_result::completed:
-						return adm_session_status::close_connection;
-					case west::io::operation_result::error:
-						return adm_session_status::close_connection;
-				}
-			}
-			else
-			{
-				if(std::string_view{std::data(read_buffer), res.bytes_read} == "shutdown")
-				{ registry.clear(); }
-			}
-
-			return adm_session_status::keep_connection;
-		}
-
-		auto socket_is_idle()
-		{ return adm_session_status::keep_connection; }
-	};
-
-	template<class CallbackRegistry>
-	struct adm_session_factory
-	{
-		auto create_session(west::io::inet_connection&& connection)
-		{ return adm_request_handler{std::move(connection), registry}; }
-
-		CallbackRegistry registry;
-	};
 }
 
-template<>
-struct west::session_state_mapper<adm_session_status>
+template<class EventMonitor>
+void serve(west::io::inet_server_socket&& http, west::io::inet_server_socket&& adm)
 {
-	constexpr auto operator()(adm_session_status) const
-	{ return io::listen_on::read_is_possible; }
-};
+	west::basic_service_registry<EventMonitor> services{};
+	services.enable_loop_metrics();
+	west::http::session_factory<echo_http_request, west::http::session_counters_handle> http_sessions{};
+	west::stats_report stats{services};
+	stats.add_http_service("http", http_sessions.instrumentation.get(), http_sessions.buffers.get());
+
+	services.enroll(std::move(http), std::move(http_sessions))
+ 		.enroll(std::move(adm), west::admin_session_factory{services.fd_callback_registry(), std::ref(stats)})
+		.process_events();
+}
 
-int main()
+int main(int argc, char** argv)
 {
+	// NOTE: The backend can be selected, to compare the pollers under the same load
+	std::string_view const backend = argc > 1? std::string_view{argv[1]} : std::string_view{"--backend=epoll"};
+	if(backend != "--backend=epoll" && backend != "--backend=io_uring")
+	{
+		fprintf(stderr, "Usage: %s [--backend=epoll|io_uring]\n", argv[0]);
+		return 1;
+	}
+
 	west::io::inet_address address{"127.0.0.1"};
 	west::io::inet_server_socket http{
 		address,
@@ -233,8 +203,8 @@ int main()
 	);
 	fflush(stdout);
 
-	west::service_registry services{};
-	enroll_http_service<echo_http_request>(services, std::move(http))
- 		.enroll(std::move(adm), adm_session_factory{services.fd_callback_registry()})
-		.process_events();
+	if(backend == "--backend=io_uring")
+	{ serve<west::io::io_uring_event_monitor>(std::move(http), std::move(adm)); }
+	else
+	{ serve<west::io::fd_event_monitor>(std::move(http), std::move(adm)); }
 }
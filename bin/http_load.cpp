@@ -0,0 +1,708 @@
+//@	{"target":{"name": "http_load.o"}}
+
+#include "lib/io_inet_server_socket.hpp"
+#include "lib/io_fd_event_monitor.hpp"
+#include "lib/http_message_header.hpp"
+#include "lib/latency_histogram.hpp"
+#include "lib/utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	using clock_type = std::chrono::steady_clock;
+
+	struct options
+	{
+		west::io::inet_address address{"127.0.0.1"};
+		uint16_t port{0};
+		size_t connections{16};
+
+		// Total number of requests per second. Zero means closed-loop, where each connection sends
+		// a new request as soon as a response has been received.
+		double rate{0.0};
+
+		// Number of requests each connection keeps in flight in closed-loop mode
+		size_t pipeline{1};
+
+		std::chrono::milliseconds duration{10000};
+		std::string target{"/"};
+		size_t header_padding{0};
+		size_t body_size{0};
+
+		// Admin port of the server. If set, the stats of the server are read before and after the
+		// run, to report the system calls made by its poller per request.
+		uint16_t admin_port{0};
+	};
+
+	void print_usage(char const* argv0)
+	{
+		fprintf(stderr, "Usage: %s --port=<port> [--address=127.0.0.1] [--connections=16] [--rate=0]\n"
+			"    [--pipeline=1] [--duration-ms=10000] [--target=/] [--header-padding=0] [--body-size=0]\n"
+			"    [--admin-port=<port>]\n\n"
+			"With --rate=0, requests are sent as fast as possible (closed-loop). Otherwise, requests\n"
+			"are sent at a fixed total rate (open-loop), and latency is measured from the time a request\n"
+			"should have been sent.\n\n"
+			"With --admin-port, the stats command of the server is used to report the system calls\n"
+			"made by the event loop of the server, per request.\n",
+			argv0);
+	}
+
+	template<class T>
+	T parse_number(std::string_view name, std::string_view value)
+	{
+		auto const ret = west::to_number<T>(value);
+		if(!ret.has_value())
+		{ throw std::runtime_error{std::string{"Bad value for "}.append(name)}; }
+		return *ret;
+	}
+
+	options parse_options(int argc, char** argv)
+	{
+		options ret{};
+		for(int k = 1; k != argc; ++k)
+		{
+			std::string_view const arg{argv[k]};
+			auto const eq = arg.find('=');
+			if(!arg.starts_with("--") || eq == std::string_view::npos)
+			{ throw std::runtime_error{std::string{"Bad argument "}.append(arg)}; }
+
+			auto const name = arg.substr(2, eq - 2);
+			auto const value = arg.substr(eq + 1);
+			if(name == "address")
+			{ ret.address = west::io::inet_address{std::string{value}.c_str()}; }
+			else
+			if(name == "port")
+			{ ret.port = parse_number<uint16_t>(name, value); }
+			else
+			if(name == "connections")
+			{ ret.connections = parse_number<size_t>(name, value); }
+			else
+			if(name == "rate")
+			{ ret.rate = parse_number<double>(name, value); }
+			else
+			if(name == "pipeline")
+			{ ret.pipeline = parse_number<size_t>(name, value); }
+			else
+			if(name == "duration-ms")
+			{ ret.duration = std::chrono::milliseconds{parse_number<int64_t>(name, value)}; }
+			else
+			if(name == "target")
+			{ ret.target = value; }
+			else
+			if(name == "header-padding")
+			{ ret.header_padding = parse_number<size_t>(name, value); }
+			else
+			if(name == "body-size")
+			{ ret.body_size = parse_number<size_t>(name, value); }
+			else
+			if(name == "admin-port")
+			{ ret.admin_port = parse_number<uint16_t>(name, value); }
+			else
+			{ throw std::runtime_error{std::string{"Unknown option "}.append(name)}; }
+		}
+
+		if(ret.port == 0 || ret.connections == 0 || ret.pipeline == 0 || ret.rate < 0.0)
+		{ throw std::runtime_error{"Bad options"}; }
+
+		return ret;
+	}
+
+	std::string make_request(options const& opts)
+	{
+		std::string ret{opts.body_size == 0? "GET " : "POST "};
+		ret.append(opts.target)
+			.append(" HTTP/1.1\r\nHost: ")
+			.append(west::io::to_string(opts.address))
+			.append(":")
+			.append(std::to_string(opts.port))
+			.append("\r\n");
+
+		if(opts.header_padding != 0)
+		{ ret.append("X-Padding: ").append(opts.header_padding, 'a').append("\r\n"); }
+
+		if(opts.body_size != 0)
+		{ ret.append("Content-Length: ").append(std::to_string(opts.body_size)).append("\r\n"); }
+
+		ret.append("\r\n").append(opts.body_size, 'x');
+		return ret;
+	}
+
+	std::string_view trim(std::string_view str)
+	{
+		while(!str.empty() && (str.front() == ' ' || str.front() == '\t'))
+		{ str.remove_prefix(1); }
+		while(!str.empty() && (str.back() == ' ' || str.back() == '\t'))
+		{ str.remove_suffix(1); }
+		return str;
+	}
+
+	struct response_info
+	{
+		int status;
+		bool close;
+	};
+
+	// NOTE: Only handles responses with a content-length, which is what west sends unless the
+	//       request handler asks for a chunked response
+	class response_reader
+	{
+	public:
+		enum class result{more_data_needed, completed, bad_response};
+
+		// Consumes bytes from `input` until a response has been completed, or all input has been
+		// used
+		result consume(std::string_view& input)
+		{
+			if(m_body_bytes_left.has_value())
+			{ return consume_body(input); }
+
+			auto const search_from = std::size(m_header) < 3? 0 : std::size(m_header) - 3;
+			m_header.append(input);
+			auto const end = m_header.find("\r\n\r\n", search_from);
+			if(end == std::string::npos)
+			{
+				input = std::string_view{};
+				return std::size(m_header) > max_header_size? result::bad_response : result::more_data_needed;
+			}
+
+			auto const header_size = end + 4;
+			input.remove_prefix(header_size - (std::size(m_header) - std::size(input)));
+			if(!parse_header(std::string_view{m_header}.substr(0, header_size)))
+			{ return result::bad_response; }
+			m_header.clear();
+
+			return consume_body(input);
+		}
+
+		response_info const& response() const
+		{ return m_response; }
+
+	private:
+		static constexpr size_t max_header_size = 65536;
+
+		result consume_body(std::string_view& input)
+		{
+			auto const n = std::min(*m_body_bytes_left, std::size(input));
+			input.remove_prefix(n);
+			*m_body_bytes_left -= n;
+			if(*m_body_bytes_left != 0)
+			{ return result::more_data_needed; }
+
+			m_body_bytes_left.reset();
+			return result::completed;
+		}
+
+		bool parse_header(std::string_view header)
+		{
+			auto const status_line_end = header.find("\r\n");
+			auto const status_line = header.substr(0, status_line_end);
+			if(!status_line.starts_with("HTTP/1.") || std::size(status_line) < 12)
+			{ return false; }
+
+			auto const status = west::to_number<int>(status_line.substr(9, 3));
+			if(!status.has_value())
+			{ return false; }
+
+			m_response = response_info{*status, false};
+			size_t content_length = 0;
+			header.remove_prefix(status_line_end + 2);
+			while(!header.starts_with("\r\n"))
+			{
+				auto const line_end = header.find("\r\n");
+				auto const line = header.substr(0, line_end);
+				header.remove_prefix(line_end + 2);
+
+				auto const colon = line.find(':');
+				if(colon == std::string_view::npos)
+				{ return false; }
+
+				auto const name = line.substr(0, colon);
+				auto const value = trim(line.substr(colon + 1));
+				if(west::http::iequals(name, "content-length"))
+				{
+					auto const length = west::to_number<size_t>(value);
+					if(!length.has_value())
+					{ return false; }
+					content_length = *length;
+				}
+				else
+				if(west::http::iequals(name, "transfer-encoding"))
+				{ return false; }
+				else
+				if(west::http::iequals(name, "connection") && west::http::iequals(value, "close"))
+				{ m_response.close = true; }
+			}
+
+			m_body_bytes_left = content_length;
+			return true;
+		}
+
+		std::string m_header;
+		std::optional<size_t> m_body_bytes_left;
+		response_info m_response{};
+	};
+
+	struct load_stats
+	{
+		west::latency_histogram latency;
+		size_t responses{0};
+
+		// Responses with a status other than 2xx, and responses that could not be parsed
+		size_t errors{0};
+		size_t reconnects{0};
+		size_t bytes_sent{0};
+		size_t bytes_received{0};
+	};
+
+	class client_connection
+	{
+	public:
+		explicit client_connection(options const& opts, std::string_view request, load_stats& stats):
+			m_opts{&opts},
+			m_request{request},
+			m_stats{&stats},
+			m_write_offset{0}
+		{}
+
+		template<class Registry>
+		void connect(Registry& registry)
+		{
+			m_connection.emplace(west::io::connect_to(m_opts->address, m_opts->port), m_opts->address, m_opts->port);
+			m_connection->set_non_blocking();
+			registry.add(m_connection->fd(), west::io::fd_event_listener_ref{*this},
+				west::io::listen_on::readwrite_edge_triggered);
+		}
+
+		// Queues a request that should have been sent at `start_time`
+		template<class Registry>
+		void send_request(Registry& registry, clock_type::time_point start_time)
+		{
+			m_unsent.push_back(start_time);
+			if(m_connection.has_value())
+			{ write_requests(registry); }
+		}
+
+		template<class Registry>
+		void fd_is_ready(Registry registry, west::io::fd_ref)
+		{
+			if(!read_responses(registry))
+			{ return; }
+			write_requests(registry);
+		}
+
+		template<class Registry>
+		void fd_is_idle(Registry, west::io::fd_ref)
+		{ }
+
+		size_t requests_in_flight() const
+		{ return std::size(m_unsent) + std::size(m_in_flight); }
+
+		// Takes the connections that have been replaced. They must be kept open until the event
+		// monitor has removed them, so their fds are not reused before that.
+		std::vector<west::io::inet_connection> take_retired_connections()
+		{ return std::move(m_retired); }
+
+	private:
+		template<class Registry>
+		void write_requests(Registry& registry)
+		{
+			while(!m_unsent.empty())
+			{
+				auto const res = m_connection->write(m_request.substr(m_write_offset));
+				m_write_offset += res.bytes_written;
+				m_stats->bytes_sent += res.bytes_written;
+				if(m_write_offset == std::size(m_request))
+				{
+					m_in_flight.push_back(m_unsent.front());
+					m_unsent.pop_front();
+					m_write_offset = 0;
+				}
+
+				if(res.ec == west::io::operation_result::operation_would_block)
+				{ return; }
+
+				if(res.ec == west::io::operation_result::error)
+				{
+					reconnect(registry);
+					return;
+				}
+			}
+		}
+
+		template<class Registry>
+		bool read_responses(Registry& registry)
+		{
+			while(true)
+			{
+				auto const res = m_connection->read(m_buffer);
+				if(res.ec == west::io::operation_result::operation_would_block)
+				{ return true; }
+
+				if(res.ec == west::io::operation_result::error || res.bytes_read == 0)
+				{
+					reconnect(registry);
+					return false;
+				}
+
+				m_stats->bytes_received += res.bytes_read;
+				std::string_view input{std::data(m_buffer), res.bytes_read};
+				while(!input.empty())
+				{
+					switch(m_reader.consume(input))
+					{
+						case response_reader::result::more_data_needed:
+							break;
+
+						case response_reader::result::completed:
+							if(!response_completed(registry))
+							{ return false; }
+							break;
+
+						case response_reader::result::bad_response:
+							++m_stats->errors;
+							reconnect(registry);
+							return false;
+					}
+				}
+			}
+		}
+
+		template<class Registry>
+		bool response_completed(Registry& registry)
+		{
+			if(m_in_flight.empty())
+			{
+				++m_stats->errors;
+				reconnect(registry);
+				return false;
+			}
+
+			auto const now = clock_type::now();
+			auto const latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_in_flight.front());
+			m_in_flight.pop_front();
+			m_stats->latency.record(static_cast<uint64_t>(std::max(latency.count(), int64_t{0})));
+			++m_stats->responses;
+
+			auto const& response = m_reader.response();
+			if(response.status < 200 || response.status >= 300)
+			{ ++m_stats->errors; }
+
+			if(m_opts->rate == 0.0)
+			{ m_unsent.push_back(now); }
+
+			if(response.close)
+			{
+				reconnect(registry);
+				return false;
+			}
+
+			return true;
+		}
+
+		// NOTE: Requests that were sent on the old connection, but did not get a response, are sent
+		//       again on the new connection. They keep their original start time. This happens when
+		//       the server closes a connection with pipelined requests that it has not answered, so
+		//       it is not counted as an error.
+		template<class Registry>
+		void reconnect(Registry& registry)
+		{
+			++m_stats->reconnects;
+			registry.remove(m_connection->fd());
+			m_retired.push_back(std::move(*m_connection));
+			m_connection.reset();
+
+			m_in_flight.insert(std::end(m_in_flight), std::begin(m_unsent), std::end(m_unsent));
+			m_unsent = std::move(m_in_flight);
+			m_in_flight.clear();
+			m_write_offset = 0;
+			m_reader = response_reader{};
+
+			connect(registry);
+			write_requests(registry);
+		}
+
+		options const* m_opts;
+		std::string_view m_request;
+		load_stats* m_stats;
+		std::optional<west::io::inet_connection> m_connection;
+		std::vector<west::io::inet_connection> m_retired;
+		std::deque<clock_type::time_point> m_unsent;
+		std::deque<clock_type::time_point> m_in_flight;
+		size_t m_write_offset;
+		response_reader m_reader;
+		std::array<char, 65536> m_buffer;
+	};
+
+	// NOTE: In open-loop mode, the timer fires often enough to dispatch requests on time, and
+	//       requests are given start times on a fixed schedule. Requests that could not be sent on
+	//       time still count from their scheduled start time, so a slow server is not hidden by the
+	//       client waiting for it (coordinated omission). In closed-loop mode, the timer only ends
+	//       the run.
+	class load_timer
+	{
+	public:
+		explicit load_timer(options const& opts,
+			std::vector<std::unique_ptr<client_connection>>& connections):
+			m_fd{west::io::create_timer_fd(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)},
+			m_rate{opts.rate},
+			m_connections{&connections},
+			m_requests_sent{0},
+			m_next_connection{0}
+		{
+			auto const interval = opts.rate == 0.0?
+				std::chrono::nanoseconds{opts.duration}:
+				std::max(std::chrono::nanoseconds{static_cast<int64_t>(1.0e9/opts.rate)},
+					std::chrono::nanoseconds{min_interval});
+			auto const to_timespec = [](std::chrono::nanoseconds val) {
+				return timespec{
+					.tv_sec = static_cast<time_t>(val.count()/1000000000),
+					.tv_nsec = static_cast<long>(val.count()%1000000000)
+				};
+			};
+
+			// NOTE: In open-loop mode, the first request is due immediately. The run starts when the
+			//       timer is armed, so the time spent opening connections is not counted as latency.
+			itimerspec const spec{
+				.it_interval = to_timespec(interval),
+				.it_value = to_timespec(opts.rate == 0.0? interval : std::chrono::nanoseconds{1})
+			};
+			m_start_time = clock_type::now();
+			m_end_time = m_start_time + opts.duration;
+			if(::timerfd_settime(m_fd.get(), 0, &spec, nullptr) == -1)
+			{ throw west::system_error{"Failed to arm timer", errno}; }
+		}
+
+		clock_type::time_point start_time() const
+		{ return m_start_time; }
+
+		template<class Registry>
+		void fd_is_ready(Registry registry, west::io::fd_ref)
+		{
+			uint64_t expirations{};
+			if(::read(m_fd.get(), &expirations, sizeof(expirations)) == -1)
+			{ return; }
+
+			auto const now = clock_type::now();
+			if(now >= m_end_time)
+			{
+				registry.clear();
+				return;
+			}
+
+			if(m_rate == 0.0)
+			{ return; }
+
+			auto const elapsed = std::chrono::duration<double>(now - m_start_time).count();
+			auto const requests_due = static_cast<size_t>(elapsed*m_rate) + 1;
+			auto& connections = *m_connections;
+			while(m_requests_sent < requests_due)
+			{
+				auto const start_time = m_start_time
+					+ std::chrono::duration_cast<clock_type::duration>(
+						std::chrono::duration<double>(static_cast<double>(m_requests_sent)/m_rate));
+				connections[m_next_connection]->send_request(registry, start_time);
+				m_next_connection = (m_next_connection + 1)%std::size(connections);
+				++m_requests_sent;
+			}
+		}
+
+		template<class Registry>
+		void fd_is_idle(Registry, west::io::fd_ref)
+		{ }
+
+		west::io::fd_ref fd() const
+		{ return m_fd.get(); }
+
+	private:
+		static constexpr std::chrono::microseconds min_interval{50};
+
+		west::io::fd_owner m_fd;
+		double m_rate;
+		std::vector<std::unique_ptr<client_connection>>* m_connections;
+		clock_type::time_point m_start_time;
+		clock_type::time_point m_end_time;
+		size_t m_requests_sent;
+		size_t m_next_connection;
+	};
+
+	struct server_stats
+	{
+		size_t poller_syscalls;
+		size_t requests_completed;
+	};
+
+	// Returns the value of the first numeric field `name` in `json`
+	size_t get_json_number(std::string_view json, std::string_view name)
+	{
+		auto const key = std::string{"\""}.append(name).append("\":");
+		auto const pos = json.find(key);
+		if(pos == std::string_view::npos)
+		{ throw std::runtime_error{std::string{"The server did not report "}.append(name)}; }
+
+		auto const value = json.substr(pos + std::size(key));
+		return parse_number<size_t>(name, value.substr(0, value.find_first_not_of("0123456789")));
+	}
+
+	// NOTE: The poller system calls caused by the admin connection itself are included. This is
+	//       negligible for runs of more than a few requests.
+	server_stats fetch_server_stats(options const& opts)
+	{
+		auto const socket = west::io::connect_to(opts.address, opts.admin_port);
+		std::string_view const command{"stats\n"};
+		if(::write(socket.get(), std::data(command), std::size(command)) != std::ssize(command))
+		{ throw west::system_error{"Failed to send stats command", errno}; }
+
+		std::string response;
+		std::array<char, 4096> buffer{};
+		while(response.find('\n') == std::string::npos)
+		{
+			auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+			if(n <= 0)
+			{ throw std::runtime_error{"Failed to read server stats"}; }
+			response.append(std::data(buffer), static_cast<size_t>(n));
+		}
+
+		return server_stats{
+			.poller_syscalls = get_json_number(response, "poller_syscalls"),
+			.requests_completed = get_json_number(response, "requests_completed")
+		};
+	}
+
+	void print_report(options const& opts,
+		load_stats const& stats,
+		clock_type::duration elapsed,
+		size_t incomplete,
+		std::optional<double> server_syscalls_per_request)
+	{
+		auto const seconds = std::chrono::duration<double>(elapsed).count();
+		auto const& latency = stats.latency;
+		printf("{\"mode\":\"%s\",\"connections\":%zu,\"duration_s\":%.3f,\"responses\":%zu,"
+			"\"errors\":%zu,\"reconnects\":%zu,\"incomplete\":%zu,\"requests_per_second\":%.1f,"
+			"\"bytes_sent\":%zu,\"bytes_received\":%zu,"
+			"\"latency_ns\":{\"min\":%lu,\"mean\":%.0f,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,"
+			"\"p99.9\":%lu,\"p99.99\":%lu,\"max\":%lu}",
+			opts.rate == 0.0? "closed-loop" : "open-loop",
+			opts.connections,
+			seconds,
+			stats.responses,
+			stats.errors,
+			stats.reconnects,
+			incomplete,
+			static_cast<double>(stats.responses)/seconds,
+			stats.bytes_sent,
+			stats.bytes_received,
+			latency.min(),
+			latency.mean(),
+			latency.value_at_percentile(50.0),
+			latency.value_at_percentile(90.0),
+			latency.value_at_percentile(99.0),
+			latency.value_at_percentile(99.9),
+			latency.value_at_percentile(99.99),
+			latency.max());
+
+		if(server_syscalls_per_request.has_value())
+		{ printf(",\"server_poller_syscalls_per_request\":%.3f", *server_syscalls_per_request); }
+		printf("}\n");
+		fflush(stdout);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::optional<options> opts;
+	try
+	{ opts = parse_options(argc, argv); }
+	catch(std::exception const& err)
+	{
+		fprintf(stderr, "%s\n\n", err.what());
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::optional<server_stats> server_stats_at_start;
+	try
+	{
+		if(opts->admin_port != 0)
+		{ server_stats_at_start = fetch_server_stats(*opts); }
+	}
+	catch(std::exception const& err)
+	{
+		fprintf(stderr, "%s\n", err.what());
+		return 1;
+	}
+
+	auto const request = make_request(*opts);
+	load_stats stats{};
+	west::io::fd_event_monitor monitor{};
+	auto registry = monitor.fd_callback_registry();
+	std::vector<std::unique_ptr<client_connection>> connections;
+	clock_type::time_point start_time{};
+	try
+	{
+		for(size_t k = 0; k != opts->connections; ++k)
+		{
+			connections.push_back(std::make_unique<client_connection>(*opts, request, stats));
+			connections.back()->connect(registry);
+		}
+
+		load_timer timer{*opts, connections};
+		start_time = timer.start_time();
+		registry.add(timer.fd(), west::io::fd_event_listener_ref{timer}, west::io::listen_on::read_is_possible);
+
+		if(opts->rate == 0.0)
+		{
+			for(auto& item : connections)
+			{
+				for(size_t k = 0; k != opts->pipeline; ++k)
+				{ item->send_request(registry, start_time); }
+			}
+		}
+
+		while(monitor.wait_for_and_dispatch_events())
+		{
+			for(auto& item : connections)
+			{ item->take_retired_connections(); }
+		}
+	}
+	catch(std::exception const& err)
+	{
+		fprintf(stderr, "%s\n", err.what());
+		return 1;
+	}
+
+	auto const elapsed = clock_type::now() - start_time;
+	size_t incomplete = 0;
+	for(auto const& item : connections)
+	{ incomplete += item->requests_in_flight(); }
+
+	std::optional<double> server_syscalls_per_request;
+	if(server_stats_at_start.has_value())
+	{
+		try
+		{
+			auto const server_stats_at_end = fetch_server_stats(*opts);
+			auto const requests = server_stats_at_end.requests_completed - server_stats_at_start->requests_completed;
+			auto const syscalls = server_stats_at_end.poller_syscalls - server_stats_at_start->poller_syscalls;
+			server_syscalls_per_request = requests != 0?
+				static_cast<double>(syscalls)/static_cast<double>(requests) : 0.0;
+		}
+		catch(std::exception const& err)
+		{
+			fprintf(stderr, "%s\n", err.what());
+			return 1;
+		}
+	}
+
+	print_report(*opts, stats, elapsed, incomplete, server_syscalls_per_request);
+	return stats.errors == 0? 0 : 2;
+}
@@ -0,0 +1,409 @@
+#ifndef WEST_ADMIN_SERVICE_HPP
+#define WEST_ADMIN_SERVICE_HPP
+
+#include "./service_registry.hpp"
+#include "./http_session_counters.hpp"
+#include "./http_request_processor.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace west
+{
+	enum class admin_command{shutdown, stats, unknown};
+
+	// Surrounding whitespace is ignored, so commands may be terminated by a newline
+	constexpr admin_command parse_admin_command(std::string_view str)
+	{
+		auto const is_space = [](char ch) {
+			return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+		};
+		while(!str.empty() && is_space(str.front()))
+		{ str.remove_prefix(1); }
+		while(!str.empty() && is_space(str.back()))
+		{ str.remove_suffix(1); }
+
+		if(str == "shutdown")
+		{ return admin_command::shutdown; }
+		else
+		if(str == "stats")
+		{ return admin_command::stats; }
+
+		return admin_command::unknown;
+	}
+
+	// Appends `value` to `str` as a JSON string, with quotes, escaping quotes, backslashes, and
+	// control characters
+	inline void append_json_string(std::string& str, std::string_view value)
+	{
+		str.push_back('"');
+		for(auto ch : value)
+		{
+			switch(ch)
+			{
+				case '"':
+					str.append("\\\"");
+					break;
+				case '\\':
+					str.append("\\\\");
+					break;
+				case '\n':
+					str.append("\\n");
+					break;
+				case '\r':
+					str.append("\\r");
+					break;
+				case '\t':
+					str.append("\\t");
+					break;
+				default:
+					if(static_cast<unsigned char>(ch) < 0x20)
+					{
+						std::array<char, 7> buffer{};
+						std::snprintf(std::data(buffer), std::size(buffer), "\\u%04x", static_cast<unsigned int>(ch));
+						str.append(std::data(buffer), 6);
+					}
+					else
+					{ str.push_back(ch); }
+			}
+		}
+		str.push_back('"');
+	}
+
+	// NOTE: Produces the response to the stats command, as a single line of JSON. Rates, and the
+	//       busy fraction of the event loop, are computed over the time since the previous report.
+	//       The report must be used from the thread that runs the registry.
+	template<class EventMonitor>
+	class stats_report
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		explicit stats_report(basic_service_registry<EventMonitor> const& registry):
+			m_registry{registry},
+			m_start{clock::now()},
+			m_prev_time{m_start},
+			m_prev_service{registry.stats()},
+			m_prev_loop{registry.event_monitor().stats()}
+		{}
+
+		// Adds the counters of an http service. Either pointer may be null.
+		stats_report& add_http_service(std::string name,
+			std::shared_ptr<http::session_counters const> counters,
+			std::shared_ptr<http::session_buffer_pool const> buffers)
+		{
+			m_http_services.push_back(http_service{std::move(name), std::move(counters), std::move(buffers)});
+			return *this;
+		}
+
+		std::string operator()()
+		{
+			auto const now = clock::now();
+			auto const elapsed = std::chrono::duration<double>(now - m_prev_time).count();
+			auto const& service = m_registry.get().stats();
+			auto const& loop = m_registry.get().event_monitor().stats();
+
+			std::string ret{"{"};
+			append(ret, "\"uptime_s\":%.3f", std::chrono::duration<double>(now - m_start).count());
+
+			append(ret, ",\"connections\":{\"open\":%zu,\"accepted\":%zu,\"closed\":%zu,\"idle_reaps\":%zu"
+				",\"accept_pauses\":%zu,\"accepts_per_s\":%.3f}",
+				service.open_connections(),
+				service.connections_accepted,
+				service.connections_closed,
+				service.idle_reaps,
+				service.accept_pauses,
+				rate(service.connections_accepted - m_prev_service.connections_accepted, elapsed));
+
+			auto const iterations = loop.iterations - m_prev_loop.iterations;
+			auto const busy_time = std::chrono::duration<double>(loop.busy_time - m_prev_loop.busy_time).count();
+			append(ret, ",\"event_loop\":{\"listeners\":%zu,\"iterations\":%zu,\"events\":%zu,\"idle_events\":%zu"
+				",\"mean_busy_time_us\":%.3f,\"max_busy_time_us\":%.3f,\"busy_fraction\":%.4f}",
+				m_registry.get().event_monitor().listener_count(),
+				loop.iterations,
+				loop.events,
+				loop.idle_events,
+				iterations != 0? 1.0e6*busy_time/static_cast<double>(iterations) : 0.0,
+				to_us(loop.max_busy_time),
+				elapsed > 0.0? busy_time/elapsed : 0.0);
+
+			if constexpr(requires{ m_registry.get().event_monitor().poller().syscall_count(); })
+			{ append(ret, ",\"poller_syscalls\":%zu", m_registry.get().event_monitor().poller().syscall_count()); }
+
+			if constexpr(requires{ m_registry.get().event_monitor().loop_metrics(); })
+			{
+				if(auto const metrics = m_registry.get().event_monitor().loop_metrics(); metrics != nullptr)
+				{ append(ret, *metrics); }
+			}
+
+			ret.append(",\"http\":[");
+			for(size_t k = 0; k != std::size(m_http_services); ++k)
+			{
+				if(k != 0)
+				{ ret.append(","); }
+				append(ret, m_http_services[k]);
+			}
+			ret.append("]}\n");
+
+			m_prev_time = now;
+			m_prev_service = service;
+			m_prev_loop = loop;
+			return ret;
+		}
+
+	private:
+		struct http_service
+		{
+			std::string name;
+			std::shared_ptr<http::session_counters const> counters;
+			std::shared_ptr<http::session_buffer_pool const> buffers;
+		};
+
+		template<class... Args>
+		static void append(std::string& str, char const* format, Args... args)
+		{
+			std::array<char, 512> buffer{};
+			auto const n = std::snprintf(std::data(buffer), std::size(buffer), format, args...);
+			str.append(std::data(buffer), std::min(static_cast<size_t>(n), std::size(buffer) - 1));
+		}
+
+		static void append(std::string& str, http_service const& item)
+		{
+			str.append("{\"name\":");
+			append_json_string(str, item.name);
+			if(item.counters != nullptr)
+			{
+				auto const& counters = *item.counters;
+				append(str, ",\"open_sessions\":%zu,\"requests_completed\":%zu,\"bytes_read\":%zu,\"bytes_written\":%zu",
+					counters.open_sessions(),
+					counters.requests_completed,
+					counters.bytes_read,
+					counters.bytes_written);
+
+				str.append(",\"sessions_in_state\":{");
+				for(size_t k = 0; k != http::request_state_count; ++k)
+				{ append(str, "%s\"%s\":%zu", k != 0? "," : "", http::request_state_names[k], counters.sessions_in_state[k]); }
+
+				// NOTE: A header is never rejected with the status `completed`, so it is skipped
+				str.append("},\"header_errors\":{");
+				for(size_t k = 1; k != http::req_header_parser_error_code_count; ++k)
+				{
+					append(str, "%s\"%s\":%zu",
+						k != 1? "," : "",
+						to_string(static_cast<http::req_header_parser_error_code>(k)),
+						counters.header_errors[k]);
+				}
+				str.append("}");
+			}
+
+			if(item.buffers != nullptr)
+			{
+				auto const stats = item.buffers->stats();
+				append(str, ",\"buffers\":{\"in_use\":%zu,\"idle\":%zu,\"hits\":%zu,\"misses\":%zu}",
+					stats.buffers_in_use,
+					stats.buffers_idle,
+					stats.hits,
+					stats.misses);
+			}
+			str.append("}");
+		}
+
+		template<unsigned int SubBucketBits>
+		static void append(std::string& str, char const* name, basic_latency_histogram<SubBucketBits> const& item, double scale)
+		{
+			append(str, "\"%s\":{\"count\":%zu,\"mean\":%.3f,\"p50\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+				name,
+				static_cast<size_t>(item.count()),
+				scale*item.mean(),
+				scale*static_cast<double>(item.value_at_percentile(50.0)),
+				scale*static_cast<double>(item.value_at_percentile(99.0)),
+				scale*static_cast<double>(item.max()));
+		}
+
+		// NOTE: Times are reported in microseconds, and cover the time since the metrics were enabled
+		static void append(std::string& str, io::event_loop_metrics const& metrics)
+		{
+			str.append(",\"loop_metrics\":{");
+			append(str, "wait_time_us", metrics.wait_time_ns, 1.0e-3);
+			str.append(",");
+			append(str, "dispatch_time_us", metrics.dispatch_time_ns, 1.0e-3);
+			str.append(",");
+			append(str, "callback_time_us", metrics.callback_time_ns, 1.0e-3);
+			str.append(",");
+			append(str, "events_per_wakeup", metrics.events_per_wakeup, 1.0);
+
+			auto const& slow_callbacks = metrics.slow_callbacks;
+			append(str, ",\"slow_callbacks\":{\"threshold_us\":%.3f,\"count\":%zu,\"recent\":[",
+				to_us(slow_callbacks.threshold()),
+				slow_callbacks.total_count());
+			auto const recent = slow_callbacks.recent();
+			for(size_t k = 0; k != std::size(recent); ++k)
+			{
+				auto const& item = recent[k];
+				append(str, "%s{\"fd\":%d,\"callback\":\"%s\",\"duration_us\":%.3f,\"listener\":",
+					k != 0? "," : "",
+					item.fd.value,
+					to_string(item.kind),
+					to_us(item.duration));
+				append_json_string(str, io::listener_type_name(item));
+				str.append("}");
+			}
+			str.append("]}}");
+		}
+
+		static double to_us(clock::duration d)
+		{ return std::chrono::duration<double, std::micro>(d).count(); }
+
+		static double rate(size_t count, double elapsed)
+		{ return elapsed > 0.0? static_cast<double>(count)/elapsed : 0.0; }
+
+		std::reference_wrapper<basic_service_registry<EventMonitor> const> m_registry;
+		clock::time_point m_start;
+		clock::time_point m_prev_time;
+		service_statistics m_prev_service;
+		typename EventMonitor::statistics m_prev_loop;
+		std::vector<http_service> m_http_services;
+	};
+
+	enum class admin_session_status{read_command, write_response, close_connection};
+
+	constexpr bool is_session_terminated(admin_session_status status)
+	{ return status == admin_session_status::close_connection; }
+
+	// NOTE: Every newline-separated command in a read is executed. A command split across two reads
+	//       is not recognized. The response to the stats command is written before the next command
+	//       is read.
+	template<io::socket Connection, class CallbackRegistry, class StatsReport>
+	class admin_session
+	{
+	public:
+		explicit admin_session(Connection&& connection, CallbackRegistry registry, StatsReport& stats):
+			m_connection{std::move(connection)},
+			m_registry{registry},
+			m_stats{stats}
+		{}
+
+		admin_session_status socket_is_ready()
+		{
+			while(true)
+			{
+				if(auto const status = flush_output(); status != admin_session_status::read_command)
+				{ return status; }
+
+				std::array<char, 4096> read_buffer{};
+				auto const res = m_connection.read(read_buffer);
+				if(res.bytes_read == 0)
+				{
+					switch(res.ec)
+					{
+						case io::operation_result::operation_would_block:
+							return admin_session_status::read_command;
+						case io::operation_result::completed:
+							return admin_session_status::close_connection;
+						case io::operation_result::error:
+							return admin_session_status::close_connection;
+					}
+				}
+
+				std::string_view commands{std::data(read_buffer), res.bytes_read};
+				while(!commands.empty())
+				{
+					auto const end = commands.find('\n');
+					execute(commands.substr(0, end));
+					commands.remove_prefix(end == std::string_view::npos? std::size(commands) : end + 1);
+				}
+			}
+		}
+
+		admin_session_status socket_is_idle()
+		{ return std::empty(m_output)? admin_session_status::read_command : admin_session_status::write_response; }
+
+		auto& connection()
+		{ return m_connection; }
+
+	private:
+		void execute(std::string_view command)
+		{
+			if(command.find_first_not_of(" \t\r") == std::string_view::npos)
+			{ return; }
+
+			switch(parse_admin_command(command))
+			{
+				case admin_command::shutdown:
+					m_registry.clear();
+					break;
+
+				case admin_command::stats:
+					m_output.append(m_stats.get()());
+					break;
+
+				case admin_command::unknown:
+					m_output.append("Unknown command\n");
+					break;
+			}
+		}
+
+		admin_session_status flush_output()
+		{
+			while(m_output_offset != std::size(m_output))
+			{
+				auto const res = m_connection.write(std::span{std::data(m_output) + m_output_offset,
+					std::size(m_output) - m_output_offset});
+				m_output_offset += res.bytes_written;
+				if(res.bytes_written == 0)
+				{
+					switch(res.ec)
+					{
+						case io::operation_result::operation_would_block:
+							return admin_session_status::write_response;
+						case io::operation_result::completed:
+							return admin_session_status::close_connection;
+						case io::operation_result::error:
+							return admin_session_status::close_connection;
+					}
+				}
+			}
+
+			m_output.clear();
+			m_output_offset = 0;
+			return admin_session_status::read_command;
+		}
+
+		Connection m_connection;
+		CallbackRegistry m_registry;
+		std::reference_wrapper<StatsReport> m_stats;
+		std::string m_output;
+		size_t m_output_offset{0};
+	};
+
+	// NOTE: The stats report is shared by all admin sessions, and must outlive them
+	template<class CallbackRegistry, class StatsReport>
+	struct admin_session_factory
+	{
+		CallbackRegistry registry;
+		std::reference_wrapper<StatsReport> stats;
+
+		template<io::socket Connection>
+		auto create_session(Connection&& connection)
+		{ return admin_session<Connection, CallbackRegistry, StatsReport>{std::move(connection), registry, stats.get()}; }
+	};
+}
+
+template<>
+struct west::session_state_mapper<west::admin_session_status>
+{
+	constexpr auto operator()(admin_session_status status) const
+	{
+		return status == admin_session_status::write_response?
+			io::listen_on::write_is_possible : io::listen_on::read_is_possible;
+	}
+};
+
+#endif
@@ -0,0 +1,184 @@
+//@	{"target":{"name":"admin_service.test"}}
+
+#include "./admin_service.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <algorithm>
+#include <string>
+
+TESTCASE(west_admin_service_parse_admin_command)
+{
+	EXPECT_EQ(west::parse_admin_command("shutdown"), west::admin_command::shutdown);
+	EXPECT_EQ(west::parse_admin_command("stats\n"), west::admin_command::stats);
+	EXPECT_EQ(west::parse_admin_command("  stats \r\n"), west::admin_command::stats);
+	EXPECT_EQ(west::parse_admin_command("stat"), west::admin_command::unknown);
+	EXPECT_EQ(west::parse_admin_command(""), west::admin_command::unknown);
+}
+
+namespace
+{
+	struct fake_socket
+	{
+		west::io::read_result read(std::span<char> buffer)
+		{
+			if(input.empty())
+			{
+				return west::io::read_result{
+					0,
+					closed? west::io::operation_result::completed : west::io::operation_result::operation_would_block
+				};
+			}
+
+			auto const n = std::min(std::size(buffer), std::size(input));
+			std::copy_n(std::begin(input), n, std::begin(buffer));
+			input.erase(0, n);
+			return west::io::read_result{n, west::io::operation_result::completed};
+		}
+
+		west::io::write_result write(std::span<char const> buffer)
+		{
+			auto const n = std::min(std::size(buffer), max_write_size);
+			if(n == 0)
+			{ return west::io::write_result{0, west::io::operation_result::operation_would_block}; }
+
+			output.append(std::data(buffer), n);
+			return west::io::write_result{n, west::io::operation_result::completed};
+		}
+
+		void stop_reading()
+		{}
+
+		std::string input;
+		std::string output;
+		size_t max_write_size{65536};
+		bool closed{false};
+	};
+
+	struct callback_registry
+	{
+		void clear()
+		{ ++clear_calls.get(); }
+
+		std::reference_wrapper<size_t> clear_calls;
+	};
+
+	struct stats_report
+	{
+		std::string operator()()
+		{
+			++calls;
+			return "{\"calls\":" + std::to_string(calls) + "}\n";
+		}
+
+		size_t calls{0};
+	};
+}
+
+TESTCASE(west_admin_service_session_executes_commands)
+{
+	size_t clear_calls = 0;
+	stats_report stats;
+	west::admin_session_factory factory{callback_registry{clear_calls}, std::ref(stats)};
+
+	auto session = factory.create_session(fake_socket{});
+	session.connection().input = "stats\nfoo\nstats\n";
+	EXPECT_EQ(session.socket_is_ready(), west::admin_session_status::read_command);
+	EXPECT_EQ(session.connection().output, "{\"calls\":1}\nUnknown command\n{\"calls\":2}\n");
+	EXPECT_EQ(clear_calls, 0);
+
+	session.connection().input = "shutdown";
+	EXPECT_EQ(session.socket_is_ready(), west::admin_session_status::read_command);
+	EXPECT_EQ(clear_calls, 1);
+
+	session.connection().closed = true;
+	EXPECT_EQ(session.socket_is_ready(), west::admin_session_status::close_connection);
+}
+
+TESTCASE(west_admin_service_session_waits_for_writable_socket)
+{
+	size_t clear_calls = 0;
+	stats_report stats;
+	west::admin_session_factory factory{callback_registry{clear_calls}, std::ref(stats)};
+
+	auto session = factory.create_session(fake_socket{});
+	session.connection().input = "stats\n";
+	session.connection().max_write_size = 0;
+	EXPECT_EQ(session.socket_is_ready(), west::admin_session_status::write_response);
+	EXPECT_EQ(session.socket_is_idle(), west::admin_session_status::write_response);
+	EXPECT_EQ(west::session_state_mapper<west::admin_session_status>{}(west::admin_session_status::write_response),
+		west::io::listen_on::write_is_possible);
+
+	// Commands are not read until the response has been written
+	session.connection().input = "stats\n";
+	session.connection().max_write_size = 4;
+	EXPECT_EQ(session.socket_is_ready(), west::admin_session_status::read_command);
+	EXPECT_EQ(session.connection().output, "{\"calls\":1}\n{\"calls\":2}\n");
+}
+
+TESTCASE(west_admin_service_stats_report)
+{
+	west::service_registry registry{};
+	auto const counters = std::make_shared<west::http::session_counters>();
+	counters->bytes_read = 123;
+	counters->header_errors[static_cast<size_t>(west::http::req_header_parser_error_code::bad_field_name)] = 2;
+	auto const buffers = std::make_shared<west::http::session_buffer_pool>();
+	auto buffer = buffers->acquire();
+
+	west::stats_report report{registry};
+	report.add_http_service("http", counters, buffers);
+	auto const str = report();
+
+	EXPECT_EQ(str.starts_with("{\"uptime_s\":"), true);
+	EXPECT_EQ(str.ends_with("}\n"), true);
+	EXPECT_EQ(std::ranges::count(str, '\n'), 1);
+	EXPECT_EQ(std::ranges::count(str, '{'), std::ranges::count(str, '}'));
+	EXPECT_NE(str.find("\"connections\":{\"open\":0,\"accepted\":0,\"closed\":0,\"idle_reaps\":0,\"accept_pauses\":0,"),
+		std::string::npos);
+	EXPECT_NE(str.find("\"event_loop\":{\"listeners\":0,"), std::string::npos);
+	EXPECT_NE(str.find("\"name\":\"http\""), std::string::npos);
+	EXPECT_NE(str.find("\"bytes_read\":123"), std::string::npos);
+	EXPECT_NE(str.find("\"read_request_header\":0"), std::string::npos);
+	EXPECT_NE(str.find("\"Bad field name\":2"), std::string::npos);
+	EXPECT_NE(str.find("\"buffers\":{\"in_use\":1,\"idle\":0,\"hits\":0,\"misses\":1}"), std::string::npos);
+}
+
+TESTCASE(west_admin_service_append_json_string)
+{
+	auto const to_json = [](std::string_view value) {
+		std::string ret;
+		west::append_json_string(ret, value);
+		return ret;
+	};
+
+	EXPECT_EQ(to_json(""), "\"\"");
+	EXPECT_EQ(to_json("http"), "\"http\"");
+	EXPECT_EQ(to_json("say \"hi\""), "\"say \\\"hi\\\"\"");
+	EXPECT_EQ(to_json("C:\\west"), "\"C:\\\\west\"");
+	EXPECT_EQ(to_json("a\tb\r\n"), "\"a\\tb\\r\\n\"");
+	EXPECT_EQ(to_json(std::string_view{"\x01\x1f", 2}), "\"\\u0001\\u001f\"");
+	EXPECT_EQ(to_json("v\xc3\xa4st"), "\"v\xc3\xa4st\"");
+}
+
+TESTCASE(west_admin_service_stats_report_escapes_service_name)
+{
+	west::service_registry registry{};
+	west::stats_report report{registry};
+	report.add_http_service("the \"main\" \\ service", nullptr, nullptr);
+	auto const str = report();
+	EXPECT_NE(str.find("\"http\":[{\"name\":\"the \\\"main\\\" \\\\ service\"}]"), std::string::npos);
+}
+
+TESTCASE(west_admin_service_stats_report_loop_metrics)
+{
+	west::service_registry registry{};
+	west::stats_report report{registry};
+	EXPECT_EQ(report().find("\"loop_metrics\""), std::string::npos);
+
+	registry.enable_loop_metrics(std::chrono::milliseconds{1});
+	auto const str = report();
+	EXPECT_EQ(std::ranges::count(str, '{'), std::ranges::count(str, '}'));
+	EXPECT_NE(str.find("\"loop_metrics\":{\"wait_time_us\":{\"count\":0,"), std::string::npos);
+	EXPECT_NE(str.find("\"slow_callbacks\":{\"threshold_us\":1000.000,\"count\":0,\"recent\":[]}"),
+		std::string::npos);
+}
@@ -0,0 +1,106 @@
+#ifndef WEST_BUFFER_POOL_HPP
+#define WEST_BUFFER_POOL_HPP
+
+#include "./per_loop_shared.hpp"
+
+#include <memory>
+#include <vector>
+#include <cassert>
+
+namespace west
+{
+	// NOTE: Not thread-safe. Use one pool per event loop.
+	template<class Buffer>
+	class buffer_pool
+	{
+	public:
+		struct statistics
+		{
+			size_t hits;
+			size_t misses;
+			size_t buffers_in_use;
+			size_t buffers_idle;
+
+			constexpr bool operator==(statistics const&) const = default;
+			constexpr bool operator!=(statistics const&) const = default;
+		};
+
+		class deleter
+		{
+		public:
+			deleter() = default;
+
+			explicit deleter(buffer_pool& pool):m_pool{&pool}{}
+
+			void operator()(Buffer* buffer) const
+			{ m_pool->release(buffer); }
+
+		private:
+			buffer_pool* m_pool{nullptr};
+		};
+
+		using buffer_ptr = std::unique_ptr<Buffer, deleter>;
+
+		explicit buffer_pool(size_t max_idle_buffers = 1024):
+			m_max_idle_buffers{max_idle_buffers},
+			m_stats{}
+		{}
+
+		buffer_pool(buffer_pool const&) = delete;
+		buffer_pool& operator=(buffer_pool const&) = delete;
+
+		~buffer_pool()
+		{ assert(m_stats.buffers_in_use == 0); }
+
+		[[nodiscard]] buffer_ptr acquire()
+		{
+			++m_stats.buffers_in_use;
+			if(m_idle.empty())
+			{
+				++m_stats.misses;
+				return buffer_ptr{std::make_unique_for_overwrite<Buffer>().release(), deleter{*this}};
+			}
+
+			++m_stats.hits;
+			auto ret = std::move(m_idle.back());
+			m_idle.pop_back();
+			--m_stats.buffers_idle;
+			return buffer_ptr{ret.release(), deleter{*this}};
+		}
+
+		[[nodiscard]] statistics stats() const
+		{ return m_stats; }
+
+		[[nodiscard]] size_t max_idle_buffers() const
+		{ return m_max_idle_buffers; }
+
+	private:
+		void release(Buffer* buffer)
+		{
+			std::unique_ptr<Buffer> item{buffer};
+			--m_stats.buffers_in_use;
+			if(std::size(m_idle) < m_max_idle_buffers)
+			{
+				m_idle.push_back(std::move(item));
+				++m_stats.buffers_idle;
+			}
+		}
+
+		size_t m_max_idle_buffers;
+		statistics m_stats;
+		std::vector<std::unique_ptr<Buffer>> m_idle;
+	};
+
+	// NOTE: A copy refers to a new, empty pool, so every event loop in a sharded_service_registry
+	//       gets its own pool. See per_loop_shared.
+	template<class Buffer>
+	class buffer_pool_handle:public per_loop_shared<buffer_pool<Buffer>, size_t>
+	{
+	public:
+		explicit buffer_pool_handle(size_t max_idle_buffers = 1024):
+			per_loop_shared<buffer_pool<Buffer>, size_t>{max_idle_buffers}
+		{}
+	};
+}
+
+#endif
@@ -0,0 +1,56 @@
+//@	{"target":{"name":"buffer_pool.test"}}
+
+#include "./buffer_pool.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <array>
+
+using test_buffer = std::array<char, 16>;
+
+TESTCASE(west_buffer_pool_acquire_and_release)
+{
+	west::buffer_pool<test_buffer> pool{1};
+	EXPECT_EQ(pool.stats(), (west::buffer_pool<test_buffer>::statistics{0, 0, 0, 0}));
+
+	{
+		auto a = pool.acquire();
+		auto b = pool.acquire();
+		EXPECT_NE(a.get(), b.get());
+		EXPECT_EQ(pool.stats(), (west::buffer_pool<test_buffer>::statistics{0, 2, 2, 0}));
+	}
+
+	// Only one buffer is kept
+	EXPECT_EQ(pool.stats(), (west::buffer_pool<test_buffer>::statistics{0, 2, 0, 1}));
+
+	{
+		auto a = pool.acquire();
+		EXPECT_EQ(pool.stats(), (west::buffer_pool<test_buffer>::statistics{1, 2, 1, 0}));
+	}
+	EXPECT_EQ(pool.stats(), (west::buffer_pool<test_buffer>::statistics{1, 2, 0, 1}));
+}
+
+TESTCASE(west_buffer_pool_handle_copy_creates_new_pool)
+{
+	west::buffer_pool_handle<test_buffer> a{4};
+	auto buffer = a->acquire();
+
+	auto b = a;
+	EXPECT_NE(a.get(), b.get());
+	EXPECT_EQ(b->max_idle_buffers(), 4);
+	EXPECT_EQ(b->stats().buffers_in_use, 0);
+	EXPECT_EQ(a->stats().buffers_in_use, 1);
+
+	auto c = std::move(a);
+	EXPECT_EQ(c->stats().buffers_in_use, 1);
+	buffer.reset();
+	EXPECT_EQ(c->stats().buffers_in_use, 0);
+
+	// The moved-from handle can still be copied
+	auto d = a;
+	EXPECT_NE(d.get(), nullptr);
+	EXPECT_EQ(d->max_idle_buffers(), 4);
+
+	b = a;
+	EXPECT_EQ(b->max_idle_buffers(), 4);
+}
@@ -0,0 +1,39 @@
+//@	{"target":{"name":"http_char_scanner.bench"}}
+
+#include "./http_char_scanner.hpp"
+
+#include "bench/benchmark.hpp"
+
+#include <array>
+#include <random>
+#include <string>
+
+int main()
+{
+	// NOTE: A long field value, similar to a cookie, that is scanned to the end
+	std::string data(1024*1024, 'a');
+	std::mt19937 rng{5678};
+	for(auto& item : data)
+	{ item = static_cast<char>(' ' + static_cast<char>(rng() % 95)); }
+	data.back() = '\r';
+
+	constexpr std::array<west::http::char_scanner_isa, 3> all_isas{
+		west::http::char_scanner_isa::scalar,
+		west::http::char_scanner_isa::sse42,
+		west::http::char_scanner_isa::avx2
+	};
+
+	for(auto isa : all_isas)
+	{
+		if(!west::http::detail::is_supported(isa))
+		{ continue; }
+
+		auto const scanner = west::http::detail::get_char_scanner(isa);
+		auto const begin = std::data(data);
+		auto const end = begin + std::size(data);
+		auto const name = std::string{"char_scanner/field_value/"}.append(to_string(isa));
+		west::bench::run(name, std::size(data), [scanner, begin, end](){
+			west::bench::do_not_optimize(scanner(west::http::field_value_chars, begin, end));
+		});
+	}
+}
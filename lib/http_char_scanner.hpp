@@ -0,0 +1,215 @@
+#ifndef WEST_HTTP_CHAR_SCANNER_HPP
+#define WEST_HTTP_CHAR_SCANNER_HPP
+
+#include "./http_message_header.hpp"
+
+#include <array>
+#include <cstdint>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WEST_HTTP_CHAR_SCANNER_HAS_X86 1
+#endif
+
+namespace west::http
+{
+	// NOTE: A char_class is stored both as a 256 entry table for the scalar scanner, and as two
+	//       16 entry tables indexed by the low and high nibble of a byte, for the SIMD scanners.
+	//       Bit h of lo_nibble[l] is set if the byte h*16 + l is not in the class. Bytes with the
+	//       high bit set are either all in the class or all outside the class.
+	struct char_class
+	{
+		template<class Predicate>
+		constexpr explicit char_class(Predicate pred, bool high_bit_in_class_):
+			is_member{},
+			lo_nibble{},
+			hi_nibble{},
+			high_bit_in_class{high_bit_in_class_}
+		{
+			for(size_t k = 0; k != 128; ++k)
+			{
+				auto const ch = static_cast<char>(k);
+				is_member[k] = pred(ch);
+				if(!is_member[k])
+				{ lo_nibble[k & 0xf] |= static_cast<uint8_t>(1u << (k >> 4)); }
+			}
+
+			for(size_t k = 128; k != 256; ++k)
+			{ is_member[k] = high_bit_in_class; }
+
+			for(size_t k = 0; k != 8; ++k)
+			{ hi_nibble[k] = static_cast<uint8_t>(1u << k); }
+		}
+
+		std::array<bool, 256> is_member;
+		alignas(16) std::array<uint8_t, 16> lo_nibble;
+		alignas(16) std::array<uint8_t, 16> hi_nibble;
+		bool high_bit_in_class;
+	};
+
+	inline constexpr char_class token_chars{[](char ch){ return is_token_char(ch); }, false};
+
+	inline constexpr char_class request_target_chars{[](char ch){
+		return !is_not_printable(ch);
+	}, true};
+
+	inline constexpr char_class field_value_chars{[](char ch){
+		return !is_not_printable(ch) || is_strict_whitespace(ch);
+	}, true};
+
+	enum class char_scanner_isa{scalar, sse42, avx2};
+
+	constexpr char const* to_string(char_scanner_isa isa)
+	{
+		switch(isa)
+		{
+			case char_scanner_isa::scalar:
+				return "scalar";
+			case char_scanner_isa::sse42:
+				return "sse4.2";
+			case char_scanner_isa::avx2:
+				return "avx2";
+		}
+		__builtin_unreachable();
+	}
+
+	namespace detail
+	{
+		inline char const* find_first_not_of_scalar(char_class const& cc, char const* begin, char const* end)
+		{
+			while(begin != end && cc.is_member[static_cast<uint8_t>(*begin)])
+			{ ++begin; }
+			return begin;
+		}
+
+#ifdef WEST_HTTP_CHAR_SCANNER_HAS_X86
+		__attribute__((target("sse4.2")))
+		inline char const* find_first_not_of_sse42(char_class const& cc, char const* begin, char const* end)
+		{
+			auto const lo_table = _mm_load_si128(reinterpret_cast<__m128i const*>(std::data(cc.lo_nibble)));
+			auto const hi_table = _mm_load_si128(reinterpret_cast<__m128i const*>(std::data(cc.hi_nibble)));
+			auto const nibble_mask = _mm_set1_epi8(0x0f);
+			auto const zero = _mm_setzero_si128();
+			while(end - begin >= 16)
+			{
+				auto const data = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin));
+				auto const lo = _mm_and_si128(data, nibble_mask);
+				auto const hi = _mm_and_si128(_mm_srli_epi16(data, 4), nibble_mask);
+				auto const not_member = _mm_and_si128(_mm_shuffle_epi8(lo_table, lo), _mm_shuffle_epi8(hi_table, hi));
+				auto mask = static_cast<uint32_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(not_member, zero))) & 0xffffu;
+				if(!cc.high_bit_in_class)
+				{ mask |= static_cast<uint32_t>(_mm_movemask_epi8(data)); }
+
+				if(mask != 0)
+				{ return begin + std::countr_zero(mask); }
+				begin += 16;
+			}
+			return find_first_not_of_scalar(cc, begin, end);
+		}
+
+		__attribute__((target("avx2")))
+		inline char const* find_first_not_of_avx2(char_class const& cc, char const* begin, char const* end)
+		{
+			auto const lo_table = _mm256_broadcastsi128_si256(
+				_mm_load_si128(reinterpret_cast<__m128i const*>(std::data(cc.lo_nibble))));
+			auto const hi_table = _mm256_broadcastsi128_si256(
+				_mm_load_si128(reinterpret_cast<__m128i const*>(std::data(cc.hi_nibble))));
+			auto const nibble_mask = _mm256_set1_epi8(0x0f);
+			auto const zero = _mm256_setzero_si256();
+			while(end - begin >= 32)
+			{
+				auto const data = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(begin));
+				auto const lo = _mm256_and_si256(data, nibble_mask);
+				auto const hi = _mm256_and_si256(_mm256_srli_epi16(data, 4), nibble_mask);
+				auto const not_member = _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo),
+					_mm256_shuffle_epi8(hi_table, hi));
+				auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(not_member, zero)));
+				if(!cc.high_bit_in_class)
+				{ mask |= static_cast<uint32_t>(_mm256_movemask_epi8(data)); }
+
+				if(mask != 0)
+				{ return begin + std::countr_zero(mask); }
+				begin += 32;
+			}
+			return find_first_not_of_sse42(cc, begin, end);
+		}
+#endif
+
+		using char_scanner = char const* (*)(char_class const&, char const*, char const*);
+
+		inline bool is_supported(char_scanner_isa isa)
+		{
+			switch(isa)
+			{
+				case char_scanner_isa::scalar:
+					return true;
+#ifdef WEST_HTTP_CHAR_SCANNER_HAS_X86
+				case char_scanner_isa::sse42:
+					return __builtin_cpu_supports("sse4.2");
+				case char_scanner_isa::avx2:
+					return __builtin_cpu_supports("avx2");
+#else
+				case char_scanner_isa::sse42:
+				case char_scanner_isa::avx2:
+					return false;
+#endif
+			}
+			__builtin_unreachable();
+		}
+
+		inline char_scanner get_char_scanner(char_scanner_isa isa)
+		{
+			switch(isa)
+			{
+				case char_scanner_isa::scalar:
+					return find_first_not_of_scalar;
+#ifdef WEST_HTTP_CHAR_SCANNER_HAS_X86
+				case char_scanner_isa::sse42:
+					return find_first_not_of_sse42;
+				case char_scanner_isa::avx2:
+					return find_first_not_of_avx2;
+#else
+				case char_scanner_isa::sse42:
+				case char_scanner_isa::avx2:
+					return find_first_not_of_scalar;
+#endif
+			}
+			__builtin_unreachable();
+		}
+
+		inline char_scanner_isa select_char_scanner_isa()
+		{
+#ifdef WEST_HTTP_CHAR_SCANNER_HAS_X86
+			// NOTE: Required since this function may be called during static initialization
+			__builtin_cpu_init();
+#endif
+			if(is_supported(char_scanner_isa::avx2))
+			{ return char_scanner_isa::avx2; }
+
+			if(is_supported(char_scanner_isa::sse42))
+			{ return char_scanner_isa::sse42; }
+
+			return char_scanner_isa::scalar;
+		}
+	}
+
+	inline char_scanner_isa selected_char_scanner_isa()
+	{
+		static auto const ret = detail::select_char_scanner_isa();
+		return ret;
+	}
+
+	// Returns a pointer to the first char in [begin, end) that is not in `cc`, or end
+	inline char const* find_first_not_of(char_class const& cc, char const* begin, char const* end)
+	{
+		// NOTE: Short runs are common, and not worth the indirect call
+		if(end - begin < 16)
+		{ return detail::find_first_not_of_scalar(cc, begin, end); }
+
+		static auto const scanner = detail::get_char_scanner(selected_char_scanner_isa());
+		return scanner(cc, begin, end);
+	}
+}
+
+#endif
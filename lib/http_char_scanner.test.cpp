@@ -0,0 +1,107 @@
+//@	{"target":{"name":"http_char_scanner.test"}}
+
+#include "./http_char_scanner.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace
+{
+	constexpr std::array<west::http::char_scanner_isa, 3> all_isas{
+		west::http::char_scanner_isa::scalar,
+		west::http::char_scanner_isa::sse42,
+		west::http::char_scanner_isa::avx2
+	};
+
+	std::string make_random_data(size_t size, std::mt19937& rng)
+	{
+		std::uniform_int_distribution<int> byte_dist{0, 255};
+		std::string ret(size, '\0');
+		for(auto& item : ret)
+		{ item = static_cast<char>(byte_dist(rng)); }
+		return ret;
+	}
+}
+
+TESTCASE(west_http_char_class_matches_predicates)
+{
+	for(size_t k = 0; k != 256; ++k)
+	{
+		auto const ch = static_cast<char>(k);
+		EXPECT_EQ(west::http::token_chars.is_member[k], west::http::is_token_char(ch));
+		EXPECT_EQ(west::http::request_target_chars.is_member[k], !west::http::is_not_printable(ch));
+		EXPECT_EQ(west::http::field_value_chars.is_member[k],
+			!west::http::is_not_printable(ch) || west::http::is_strict_whitespace(ch));
+	}
+}
+
+TESTCASE(west_http_char_scanner_scalar_is_always_supported)
+{
+	EXPECT_EQ(west::http::detail::is_supported(west::http::char_scanner_isa::scalar), true);
+	EXPECT_EQ(west::http::detail::is_supported(west::http::selected_char_scanner_isa()), true);
+}
+
+TESTCASE(west_http_char_scanner_all_isas_agree_with_scalar)
+{
+	std::mt19937 rng{1234};
+	std::array<west::http::char_class const*, 3> const classes{
+		&west::http::token_chars,
+		&west::http::request_target_chars,
+		&west::http::field_value_chars
+	};
+
+	for(auto isa : all_isas)
+	{
+		if(!west::http::detail::is_supported(isa))
+		{
+			fprintf(stderr, "Skipping %s, not supported by this cpu\n", to_string(isa));
+			continue;
+		}
+
+		auto const scanner = west::http::detail::get_char_scanner(isa);
+		for(size_t trial = 0; trial != 64; ++trial)
+		{
+			// Mostly members with sparse non-members, so that long runs are tested too
+			auto data = make_random_data(100, rng);
+			for(auto& item : data)
+			{
+				if(rng() % 16 != 0)
+				{ item = 'a' + static_cast<char>(rng() % 26); }
+			}
+
+			auto const begin = std::data(data);
+			auto const end = begin + std::size(data);
+			for(auto cc : classes)
+			{
+				for(size_t offset = 0; offset != std::size(data); ++offset)
+				{
+					EXPECT_EQ(scanner(*cc, begin + offset, end),
+						west::http::detail::find_first_not_of_scalar(*cc, begin + offset, end));
+				}
+			}
+		}
+	}
+}
+
+TESTCASE(west_http_char_scanner_stops_at_high_bit_bytes)
+{
+	for(auto isa : all_isas)
+	{
+		if(!west::http::detail::is_supported(isa))
+		{ continue; }
+
+		auto const scanner = west::http::detail::get_char_scanner(isa);
+		for(size_t pos = 0; pos != 64; ++pos)
+		{
+			std::string data(64, 'x');
+			data[pos] = static_cast<char>(0xc3);
+			auto const begin = std::data(data);
+			auto const end = begin + std::size(data);
+			EXPECT_EQ(scanner(west::http::token_chars, begin, end), begin + pos);
+			EXPECT_EQ(scanner(west::http::field_value_chars, begin, end), end);
+		}
+	}
+}
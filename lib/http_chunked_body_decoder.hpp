@@ -0,0 +1,249 @@
+#ifndef WEST_HTTP_CHUNKED_BODY_DECODER_HPP
+#define WEST_HTTP_CHUNKED_BODY_DECODER_HPP
+
+#include <algorithm>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <cassert>
+
+namespace west::http
+{
+	enum class chunked_decoder_error_code
+	{
+		completed,
+		more_data_needed,
+		bad_chunk_size,
+		chunk_size_line_too_long,
+		expected_linefeed,
+		trailer_too_long
+	};
+
+	constexpr char const* to_string(chunked_decoder_error_code ec)
+	{
+		switch(ec)
+		{
+			case chunked_decoder_error_code::completed:
+				return "Completed";
+
+			case chunked_decoder_error_code::more_data_needed:
+				return "Chunked body truncated";
+
+			case chunked_decoder_error_code::bad_chunk_size:
+				return "Bad chunk size";
+
+			case chunked_decoder_error_code::chunk_size_line_too_long:
+				return "Chunk size line too long";
+
+			case chunked_decoder_error_code::expected_linefeed:
+				return "Expected linefeed";
+
+			case chunked_decoder_error_code::trailer_too_long:
+				return "Trailer too long";
+		}
+
+		__builtin_unreachable();
+	}
+
+	struct chunked_decoder_limits
+	{
+		// Maximum length of a chunk size line, including chunk extensions
+		size_t max_chunk_size_line_length{1024};
+
+		// Maximum total size of all trailer fields. Trailer fields are ignored.
+		size_t max_trailer_size{8192};
+	};
+
+	struct chunked_decode_result
+	{
+		// Number of framing bytes that were consumed from the input, before `payload`
+		size_t framing_bytes;
+
+		// Chunk data that directly follows the framing bytes. It is not consumed until
+		// consume_payload is called.
+		std::span<char const> payload;
+
+		chunked_decoder_error_code ec;
+	};
+
+	// NOTE: Decodes a chunked body incrementally. The decoder never copies chunk data. Instead,
+	//       decode returns the part of the input that contains chunk data, and the caller reports how
+	//       much of it was used through consume_payload. Chunk extensions and trailer fields are
+	//       skipped.
+	class chunked_body_decoder
+	{
+	public:
+		explicit chunked_body_decoder(chunked_decoder_limits const& limits = chunked_decoder_limits{}):
+			m_limits{limits},
+			m_state{state::chunk_size},
+			m_chunk_size{0},
+			m_line_length{0},
+			m_trailer_size{0}
+		{}
+
+		inline chunked_decode_result decode(std::span<char const> input);
+
+		void consume_payload(size_t n)
+		{
+			assert(m_state == state::chunk_data && n <= m_chunk_size);
+			m_chunk_size -= n;
+			if(m_chunk_size == 0)
+			{ m_state = state::chunk_data_cr; }
+		}
+
+		[[nodiscard]] bool is_completed() const
+		{ return m_state == state::completed; }
+
+		// Returns the number of bytes left in the current chunk
+		[[nodiscard]] size_t chunk_bytes_left() const
+		{ return m_state == state::chunk_data? m_chunk_size : 0; }
+
+	private:
+		enum class state
+		{
+			chunk_size,
+			chunk_extension,
+			chunk_size_lf,
+			chunk_data,
+			chunk_data_cr,
+			chunk_data_lf,
+			trailer_line_start,
+			trailer_line,
+			trailer_line_lf,
+			last_lf,
+			completed
+		};
+
+		static constexpr int hex_value(char ch)
+		{
+			if(ch >= '0' && ch <= '9')
+			{ return ch - '0'; }
+			if(ch >= 'a' && ch <= 'f')
+			{ return ch - 'a' + 10; }
+			if(ch >= 'A' && ch <= 'F')
+			{ return ch - 'A' + 10; }
+			return -1;
+		}
+
+		chunked_decoder_limits m_limits;
+		state m_state;
+		size_t m_chunk_size;
+		size_t m_line_length;
+		size_t m_trailer_size;
+	};
+}
+
+west::http::chunked_decode_result west::http::chunked_body_decoder::decode(std::span<char const> input)
+{
+	auto ptr = std::data(input);
+	auto const end = ptr + std::size(input);
+	auto make_result = [&input, &ptr](chunked_decoder_error_code ec, std::span<char const> payload = {}) {
+		return chunked_decode_result{static_cast<size_t>(ptr - std::data(input)), payload, ec};
+	};
+
+	while(ptr != end)
+	{
+		auto const ch = *ptr;
+		switch(m_state)
+		{
+			case state::chunk_size:
+				if(auto const val = hex_value(ch); val != -1)
+				{
+					if(m_chunk_size > (std::numeric_limits<size_t>::max() >> 4))
+					{ return make_result(chunked_decoder_error_code::bad_chunk_size); }
+					m_chunk_size = 16*m_chunk_size + static_cast<size_t>(val);
+				}
+				else
+				{
+					if(m_line_length == 0)
+					{ return make_result(chunked_decoder_error_code::bad_chunk_size); }
+
+					if(ch == '\r')
+					{ m_state = state::chunk_size_lf; }
+					else
+					if(ch == ';' || ch == ' ' || ch == '\t')
+					{ m_state = state::chunk_extension; }
+					else
+					{ return make_result(chunked_decoder_error_code::bad_chunk_size); }
+				}
+				++m_line_length;
+				break;
+
+			case state::chunk_extension:
+				if(ch == '\r')
+				{ m_state = state::chunk_size_lf; }
+				++m_line_length;
+				break;
+
+			case state::chunk_size_lf:
+				if(ch != '\n')
+				{ return make_result(chunked_decoder_error_code::expected_linefeed); }
+				m_line_length = 0;
+				m_state = m_chunk_size == 0? state::trailer_line_start : state::chunk_data;
+				break;
+
+			case state::chunk_data:
+			{
+				auto const n = std::min(static_cast<size_t>(end - ptr), m_chunk_size);
+				return make_result(chunked_decoder_error_code::more_data_needed, std::span{ptr, n});
+			}
+
+			case state::chunk_data_cr:
+				if(ch != '\r')
+				{ return make_result(chunked_decoder_error_code::expected_linefeed); }
+				m_state = state::chunk_data_lf;
+				break;
+
+			case state::chunk_data_lf:
+				if(ch != '\n')
+				{ return make_result(chunked_decoder_error_code::expected_linefeed); }
+				m_state = state::chunk_size;
+				break;
+
+			case state::trailer_line_start:
+				if(ch == '\r')
+				{ m_state = state::last_lf; }
+				else
+				{ m_state = state::trailer_line; }
+				++m_trailer_size;
+				break;
+
+			case state::trailer_line:
+				if(ch == '\r')
+				{ m_state = state::trailer_line_lf; }
+				++m_trailer_size;
+				break;
+
+			case state::trailer_line_lf:
+				if(ch != '\n')
+				{ return make_result(chunked_decoder_error_code::expected_linefeed); }
+				m_state = state::trailer_line_start;
+				++m_trailer_size;
+				break;
+
+			case state::last_lf:
+				if(ch != '\n')
+				{ return make_result(chunked_decoder_error_code::expected_linefeed); }
+				m_state = state::completed;
+				++ptr;
+				return make_result(chunked_decoder_error_code::completed);
+
+			case state::completed:
+				return make_result(chunked_decoder_error_code::completed);
+		}
+
+		if(m_line_length > m_limits.max_chunk_size_line_length)
+		{ return make_result(chunked_decoder_error_code::chunk_size_line_too_long); }
+
+		if(m_trailer_size > m_limits.max_trailer_size)
+		{ return make_result(chunked_decoder_error_code::trailer_too_long); }
+
+		++ptr;
+	}
+
+	return make_result(m_state == state::completed?
+		chunked_decoder_error_code::completed : chunked_decoder_error_code::more_data_needed);
+}
+
+#endif
@@ -0,0 +1,163 @@
+//@	{"target":{"name":"http_chunked_body_decoder.test"}}
+
+#include "./http_chunked_body_decoder.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace
+{
+	struct decode_all_result
+	{
+		std::string payload;
+		west::http::chunked_decoder_error_code ec;
+		size_t bytes_left;
+	};
+
+	// Feeds `input` to the decoder in pieces of at most `piece_size` bytes, and consumes at most
+	// `max_consume` payload bytes per call, as a request handler may do
+	decode_all_result decode_all(west::http::chunked_body_decoder& decoder,
+		std::string_view input,
+		size_t piece_size,
+		size_t max_consume = static_cast<size_t>(-1))
+	{
+		decode_all_result ret{};
+		std::string buffer;
+		while(true)
+		{
+			if(std::empty(buffer))
+			{
+				if(std::empty(input))
+				{
+					ret.ec = west::http::chunked_decoder_error_code::more_data_needed;
+					return ret;
+				}
+				auto const n = std::min(piece_size, std::size(input));
+				buffer = input.substr(0, n);
+				input.remove_prefix(n);
+			}
+
+			auto const res = decoder.decode(buffer);
+			auto const n = std::min(std::size(res.payload), max_consume);
+			ret.payload.append(std::data(res.payload), n);
+			buffer.erase(0, res.framing_bytes + n);
+			if(res.ec != west::http::chunked_decoder_error_code::more_data_needed)
+			{
+				ret.ec = res.ec;
+				ret.bytes_left = std::size(buffer) + std::size(input);
+				return ret;
+			}
+
+			if(n != 0)
+			{ decoder.consume_payload(n); }
+		}
+	}
+
+	constexpr std::string_view chunked_body{"7\r\n"
+"Mozilla\r\n"
+"9;name=value\r\n"
+"Developer\r\n"
+"0000007\r\n"
+"Network\r\n"
+"0\r\n"
+"Expires: Wed, 21 Oct 2015 07:28:00 GMT\r\n"
+"\r\n"};
+}
+
+TESTCASE(west_http_chunked_body_decoder_decode_complete_body)
+{
+	for(size_t piece_size = 1; piece_size != std::size(chunked_body) + 1; ++piece_size)
+	{
+		west::http::chunked_body_decoder decoder;
+		auto const res = decode_all(decoder, std::string{chunked_body}.append("GET"), piece_size, 3);
+		EXPECT_EQ(res.ec, west::http::chunked_decoder_error_code::completed);
+		EXPECT_EQ(res.payload, "MozillaDeveloperNetwork");
+		EXPECT_EQ(decoder.is_completed(), true);
+
+		// Data after the body belongs to the next request
+		EXPECT_EQ(res.bytes_left, 3);
+	}
+}
+
+TESTCASE(west_http_chunked_body_decoder_payload_is_not_copied)
+{
+	west::http::chunked_body_decoder decoder;
+	std::string_view input{"a\r\n0123456789\r\n0\r\n\r\n"};
+	auto const res = decoder.decode(input);
+	EXPECT_EQ(res.ec, west::http::chunked_decoder_error_code::more_data_needed);
+	EXPECT_EQ(res.framing_bytes, 3);
+	EXPECT_EQ(std::data(res.payload), std::data(input) + 3);
+	EXPECT_EQ(std::size(res.payload), 10);
+	EXPECT_EQ(decoder.chunk_bytes_left(), 10);
+
+	decoder.consume_payload(4);
+	EXPECT_EQ(decoder.chunk_bytes_left(), 6);
+}
+
+TESTCASE(west_http_chunked_body_decoder_truncated_body)
+{
+	west::http::chunked_body_decoder decoder;
+	auto const res = decode_all(decoder, "5\r\nHello\r\n", 4);
+	EXPECT_EQ(res.ec, west::http::chunked_decoder_error_code::more_data_needed);
+	EXPECT_EQ(res.payload, "Hello");
+	EXPECT_EQ(decoder.is_completed(), false);
+}
+
+TESTCASE(west_http_chunked_body_decoder_bad_input)
+{
+	struct testcase
+	{
+		std::string_view input;
+		west::http::chunked_decoder_error_code expected_ec;
+	};
+
+	std::array<testcase, 6> const testcases{
+		testcase{"\r\n", west::http::chunked_decoder_error_code::bad_chunk_size},
+		testcase{"x\r\n", west::http::chunked_decoder_error_code::bad_chunk_size},
+		testcase{"5x\r\n", west::http::chunked_decoder_error_code::bad_chunk_size},
+		testcase{"10000000000000000\r\n", west::http::chunked_decoder_error_code::bad_chunk_size},
+		testcase{"5\rHello", west::http::chunked_decoder_error_code::expected_linefeed},
+		testcase{"5\r\nHelloX\r\n", west::http::chunked_decoder_error_code::expected_linefeed}
+	};
+
+	for(auto const& item : testcases)
+	{
+		west::http::chunked_body_decoder decoder;
+		auto const res = decode_all(decoder, item.input, 2);
+		EXPECT_EQ(res.ec, item.expected_ec);
+	}
+}
+
+TESTCASE(west_http_chunked_body_decoder_limits)
+{
+	west::http::chunked_decoder_limits const limits{
+		.max_chunk_size_line_length = 16,
+		.max_trailer_size = 24
+	};
+
+	{
+		west::http::chunked_body_decoder decoder{limits};
+		auto const res = decode_all(decoder, "5;a=bcdefghijklmnop\r\nHello\r\n0\r\n\r\n", 7);
+		EXPECT_EQ(res.ec, west::http::chunked_decoder_error_code::chunk_size_line_too_long);
+	}
+
+	{
+		west::http::chunked_body_decoder decoder{limits};
+		auto const res = decode_all(decoder, "5;a=b\r\nHello\r\n0\r\n\r\n", 7);
+		EXPECT_EQ(res.ec, west::http::chunked_decoder_error_code::completed);
+	}
+
+	{
+		west::http::chunked_body_decoder decoder{limits};
+		auto const res = decode_all(decoder, "0\r\nA: 0123456789\r\nB: 0123456789\r\n\r\n", 7);
+		EXPECT_EQ(res.ec, west::http::chunked_decoder_error_code::trailer_too_long);
+	}
+
+	{
+		west::http::chunked_body_decoder decoder{limits};
+		auto const res = decode_all(decoder, "0\r\nA: 0123456789\r\n\r\n", 7);
+		EXPECT_EQ(res.ec, west::http::chunked_decoder_error_code::completed);
+	}
+}
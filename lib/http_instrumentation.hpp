@@ -0,0 +1,141 @@
+#ifndef WEST_HTTP_INSTRUMENTATION_HPP
+#define WEST_HTTP_INSTRUMENTATION_HPP
+
+#include "./http_request_state_transitions.hpp"
+#include "./io_counting_socket.hpp"
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace west::http
+{
+	template<class T>
+	struct request_state_name{};
+
+	template<>
+	struct request_state_name<read_request_header>
+	{ static constexpr char const* value = "read_request_header"; };
+
+	template<>
+	struct request_state_name<write_interim_response>
+	{ static constexpr char const* value = "write_interim_response"; };
+
+	template<>
+	struct request_state_name<read_request_body>
+	{ static constexpr char const* value = "read_request_body"; };
+
+	template<>
+	struct request_state_name<read_request_chunked_body>
+	{ static constexpr char const* value = "read_request_chunked_body"; };
+
+	template<>
+	struct request_state_name<write_response_header>
+	{ static constexpr char const* value = "write_response_header"; };
+
+	template<>
+	struct request_state_name<write_response_body>
+	{ static constexpr char const* value = "write_response_body"; };
+
+	template<>
+	struct request_state_name<wait_for_data>
+	{ static constexpr char const* value = "wait_for_data"; };
+
+	inline constexpr size_t request_state_count = std::variant_size_v<request_state_holder>;
+
+	namespace detail
+	{
+		template<class T, class Variant>
+		struct variant_index{};
+
+		template<class T, class... Types>
+		struct variant_index<T, std::variant<Types...>>
+		{
+			static constexpr size_t value = [](){
+				constexpr std::array<bool, sizeof...(Types)> matches{std::is_same_v<T, Types>...};
+				return static_cast<size_t>(std::ranges::find(matches, true) - std::begin(matches));
+			}();
+		};
+
+		template<size_t... I>
+		constexpr auto make_request_state_names(std::index_sequence<I...>)
+		{
+			return std::array<char const*, sizeof...(I)>{
+				request_state_name<std::variant_alternative_t<I, request_state_holder>>::value...
+			};
+		}
+	}
+
+	// Index of state `T` in request_state_holder
+	template<class T>
+	inline constexpr size_t request_state_index = detail::variant_index<T, request_state_holder>::value;
+
+	// Names of the states in request_state_holder, by index
+	inline constexpr auto request_state_names =
+		detail::make_request_state_names(std::make_index_sequence<request_state_count>{});
+
+	// NOTE: An instrumentation policy is stored in the session factory, and is copied once per
+	//       event loop. create_recorder is called for every session, and the recorder is notified by
+	//       the request processor:
+	//
+	//       * state_completed, when the session leaves a state, either because the state has
+	//         completed, or because it is replaced by an error response. `io` holds the socket calls
+	//         made, and bytes moved, while in that state.
+	//       * request_started, when the first data of a request has arrived on a keep-alive
+	//         connection. The first request on a connection starts when the recorder is created.
+	//       * request_completed, when the response has been written
+	//
+	//       If `enabled` is false, the hooks are never called, and the socket is not wrapped in a
+	//       counting_socket, so the policy has no cost.
+	template<class T>
+	concept request_recorder = requires(T x, size_t state_index, io::io_counters const& io)
+	{
+		{ T::enabled } -> std::convertible_to<bool>;
+		{ x.state_completed(state_index, io) } -> std::same_as<void>;
+		{ x.request_started() } -> std::same_as<void>;
+		{ x.request_completed() } -> std::same_as<void>;
+	};
+
+	// NOTE: A recorder may also provide the following hooks, which are only called if present:
+	//
+	//       * state_entered, when the session has entered a new state, after state_completed
+	//       * header_rejected, when a request header could not be parsed. A header that is too
+	//         large is reported as req_header_parser_error_code::more_data_needed.
+	template<request_recorder Recorder>
+	void notify_state_entered(Recorder& recorder, size_t state_index)
+	{
+		if constexpr(requires{ recorder.state_entered(state_index); })
+		{ recorder.state_entered(state_index); }
+	}
+
+	template<request_recorder Recorder>
+	void notify_header_rejected(Recorder& recorder, req_header_parser_error_code ec)
+	{
+		if constexpr(requires{ recorder.header_rejected(ec); })
+		{ recorder.header_rejected(ec); }
+	}
+
+	struct no_instrumentation
+	{
+		static constexpr bool enabled = false;
+
+		no_instrumentation create_recorder() const
+		{ return no_instrumentation{}; }
+
+		void state_completed(size_t, io::io_counters const&)
+		{ }
+
+		void request_started()
+		{ }
+
+		void request_completed()
+		{ }
+	};
+
+	template<class Socket, request_recorder Recorder>
+	using instrumented_socket_t = std::conditional_t<Recorder::enabled, io::counting_socket<Socket>, Socket>;
+}
+
+#endif
@@ -0,0 +1,86 @@
+//@	{"target":{"name":"http_message_header.bench"}}
+
+#include "./http_message_header.hpp"
+
+#include "bench/benchmark.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+	using field = std::pair<std::string_view, std::string_view>;
+
+	// NOTE: A typical request header has mostly known fields, while requests passing through a
+	//       proxy or an API gateway carry many extension fields
+	constexpr std::array known_fields{
+		field{"Host", "www.example.com"},
+		field{"User-Agent", "Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/111.0"},
+		field{"Accept", "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8"},
+		field{"Accept-Language", "sv-SE,sv;q=0.8,en-US;q=0.5,en;q=0.3"},
+		field{"Accept-Encoding", "gzip, deflate, br"},
+		field{"Connection", "keep-alive"},
+		field{"Content-Type", "application/json"},
+		field{"Content-Length", "348"}
+	};
+
+	constexpr std::array unknown_fields{
+		field{"X-Request-Id", "0f8fad5b-d9cb-469f-a165-70867728950e"},
+		field{"X-Forwarded-For", "203.0.113.195, 70.41.3.18"},
+		field{"X-Forwarded-Proto", "https"},
+		field{"X-Forwarded-Host", "api.example.com"},
+		field{"Traceparent", "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01"},
+		field{"Idempotency-Key", "5f2b7a1c-3e4d-4c8b-9a6f-2d1e0c9b8a7f"},
+		field{"Sec-Fetch-Dest", "script"},
+		field{"Sec-Fetch-Mode", "no-cors"}
+	};
+
+	template<size_t N>
+	size_t bytes_in(std::array<field, N> const& fields)
+	{
+		size_t ret = 0;
+		for(auto const& item : fields)
+		{ ret += std::size(item.first) + std::size(item.second); }
+		return ret;
+	}
+
+	template<size_t N>
+	west::http::field_map make_field_map(std::array<field, N> const& fields)
+	{
+		west::http::field_map ret;
+		for(auto const& item : fields)
+		{ ret.append(std::string{item.first}, std::string{item.second}); }
+		return ret;
+	}
+}
+
+int main()
+{
+	west::bench::run("field_map/append/known", bytes_in(known_fields), [](){
+		west::bench::do_not_optimize(make_field_map(known_fields));
+	});
+
+	west::bench::run("field_map/append/unknown", bytes_in(unknown_fields), [](){
+		west::bench::do_not_optimize(make_field_map(unknown_fields));
+	});
+
+	auto const fields = make_field_map(known_fields);
+	west::bench::run("field_map/find/known_field_id", 0, [&fields](){
+		west::bench::do_not_optimize(fields.find(west::http::known_field::content_length));
+	});
+
+	west::bench::run("field_map/find/known_field_name", 0, [&fields](){
+		west::bench::do_not_optimize(fields.find("content-length"));
+	});
+
+	auto const extension_fields = make_field_map(unknown_fields);
+	west::bench::run("field_map/find/unknown_field_name", 0, [&extension_fields](){
+		west::bench::do_not_optimize(extension_fields.find("sec-fetch-mode"));
+	});
+
+	west::bench::run("field_map/find/missing_field_name", 0, [&extension_fields](){
+		west::bench::do_not_optimize(extension_fields.find("x-not-present"));
+	});
+}
@@ -2,9 +2,10 @@
 #define WEST_HTTP_MESSAGE_HEADER_HPP
 
 #include "./utils.hpp"
+#include "./small_vector.hpp"
 
 #include <string>
-#include <map>
+#include <array>
 #include <cstdint>
 #include <optional>
 #include <algorithm>
@@ -103,6 +104,28 @@ namespace west::http
 		http_version_not_supported = 505
 	};
 
+	inline constexpr std::array all_statuses{
+		status::ok, status::created, status::accepted, status::non_authoritative_information,
+		status::no_content, status::reset_content, status::partial_content,
+
+		status::multiple_choices, status::moved_permanently, status::found, status::see_other,
+		status::not_modified, status::temporary_redirect, status::permanent_redirect,
+
+		status::bad_request, status::unauthorized, status::payment_required, status::forbidden,
+		status::not_found, status::method_not_allowed, status::not_acceptable,
+		status::proxy_authentication_required, status::request_timeout, status::conflict, status::gone,
+		status::length_required, status::precondition_failed, status::request_entity_too_large,
+		status::request_uri_too_long, status::unsupported_media_type,
+		status::requested_range_not_satisfiable, status::expectation_failed, status::i_am_a_teapot,
+		status::misdirected_request, status::unprocessable_content, status::failed_dependency,
+		status::too_early, status::upgrade_required, status::precondition_required,
+		status::too_many_requests, status::request_header_fields_too_large,
+		status::unavailable_for_legal_reasons,
+
+		status::internal_server_error, status::not_implemented, status::bad_gateway,
+		status::service_unavailable, status::gateway_timeout, status::http_version_not_supported
+	};
+
 	constexpr bool is_client_error(status val)
 	{
 		using underlying_type = std::underlying_type_t<status>;
@@ -341,9 +364,139 @@ namespace west::http
 		std::string m_value;
 	};
 
+	// NOTE: Well-known field names are resolved once, when a field_name is created, so that lookups
+	//       of these fields only need to compare the id
+	enum class known_field:uint8_t
+	{
+		unknown,
+		accept,
+		accept_encoding,
+		accept_language,
+		connection,
+		content_length,
+		content_type,
+		cookie,
+		date,
+		expect,
+		host,
+		keep_alive,
+		server,
+		transfer_encoding,
+		user_agent
+	};
+
+	constexpr char const* to_string(known_field id)
+	{
+		switch(id)
+		{
+			case known_field::unknown:
+				return "";
+			case known_field::accept:
+				return "Accept";
+			case known_field::accept_encoding:
+				return "Accept-Encoding";
+			case known_field::accept_language:
+				return "Accept-Language";
+			case known_field::connection:
+				return "Connection";
+			case known_field::content_length:
+				return "Content-Length";
+			case known_field::content_type:
+				return "Content-Type";
+			case known_field::cookie:
+				return "Cookie";
+			case known_field::date:
+				return "Date";
+			case known_field::expect:
+				return "Expect";
+			case known_field::host:
+				return "Host";
+			case known_field::keep_alive:
+				return "Keep-Alive";
+			case known_field::server:
+				return "Server";
+			case known_field::transfer_encoding:
+				return "Transfer-Encoding";
+			case known_field::user_agent:
+				return "User-Agent";
+		}
+		__builtin_unreachable();
+	}
+
+	constexpr bool iequals(std::string_view a, std::string_view b)
+	{
+		if(std::size(a) != std::size(b))
+		{ return false; }
+
+		for(size_t k = 0; k != std::size(a); ++k)
+		{
+			auto const x = (a[k] >= 'A' && a[k] <= 'Z')? a[k] + ('a' - 'A') : a[k];
+			auto const y = (b[k] >= 'A' && b[k] <= 'Z')? b[k] + ('a' - 'A') : b[k];
+			if(x != y)
+			{ return false; }
+		}
+		return true;
+	}
+
+	constexpr known_field to_known_field(std::string_view name)
+	{
+		auto const match = [name](known_field id) {
+			return iequals(name, to_string(id))? id : known_field::unknown;
+		};
+
+		// NOTE: The length separates most names, so at most two comparisons are needed
+		switch(std::size(name))
+		{
+			case 4:
+				return name[0] == 'd' || name[0] == 'D'? match(known_field::date) : match(known_field::host);
+			case 6:
+				switch(name[0])
+				{
+					case 'a':
+					case 'A':
+						return match(known_field::accept);
+					case 'c':
+					case 'C':
+						return match(known_field::cookie);
+					case 'e':
+					case 'E':
+						return match(known_field::expect);
+					default:
+						return match(known_field::server);
+				}
+			case 10:
+				switch(name[0])
+				{
+					case 'c':
+					case 'C':
+						return match(known_field::connection);
+					case 'k':
+					case 'K':
+						return match(known_field::keep_alive);
+					default:
+						return match(known_field::user_agent);
+				}
+			case 12:
+				return match(known_field::content_type);
+			case 14:
+				return match(known_field::content_length);
+			case 15:
+				if(auto const ret = match(known_field::accept_encoding); ret != known_field::unknown)
+				{ return ret; }
+				return match(known_field::accept_language);
+			case 17:
+				return match(known_field::transfer_encoding);
+			default:
+				return known_field::unknown;
+		}
+	}
+
 	class field_name
 	{
 	public:
+		// NOTE: A default constructed field_name is empty, and is only used as a placeholder
+		field_name():m_id{known_field::unknown}{}
+
 		static std::optional<field_name> create(std::string&& str)
 		{
 			if(!is_token(str))
@@ -370,10 +523,15 @@ namespace west::http
 
 		auto const& value() const { return m_value; }
 
+		known_field id() const { return m_id; }
+
 	private:
-		explicit field_name() = default;
-		explicit field_name(std::string&& string):m_value{std::move(string)}{}
+		explicit field_name(std::string&& string):
+			m_value{std::move(string)},
+			m_id{to_known_field(m_value)}
+		{}
 		std::string m_value;
+		known_field m_id;
 	};
 
 	class field_value
@@ -410,23 +568,37 @@ namespace west::http
 
 		auto const& value() const { return m_value; }
 
+		std::string take() && { return std::move(m_value); }
+
 	private:
 		explicit field_value(std::string&& string):m_value{std::move(string)}{}
 		std::string m_value;
 	};
 
+	// NOTE: Fields are stored in a flat array, in the order they were first appended. Typical
+	//       headers have few fields, so a linear search is faster than a tree lookup.
+	//
+	//       Up to 8 fields are stored inline. That covers the requests of curl (3 fields), wget
+	//       (5) and most API clients, as well as the responses written by west. Browser requests
+	//       (12 or more) move to the heap once.
 	class field_map
 	{
 	public:
+		using value_type = std::pair<field_name, std::string>;
+
 		field_map& append(field_name&& key, field_value const& value)
-		{
-			// TODO: In first case, we should be able to move value, but we still need to append
-			//       `value` if `key` already exists
-			auto ip = m_fields.emplace(std::move(key), value.value());
-			if(ip.second)
-			{ return *this; }
+		{ return append(std::move(key), field_value{value}); }
 
-			auto& val = ip.first->second;
+		field_map& append(field_name&& key, field_value&& value)
+		{
+			auto const i = find_entry(key);
+			if(i == std::end(m_fields))
+			{
+				m_fields.emplace_back(std::move(key), std::move(value).take());
+				return *this;
+			}
+
+			auto& val = i->second;
 			if(value.value().size() != 0)
 			{ val.append(", ").append(value.value()); }
 			return *this;
@@ -439,7 +611,7 @@ namespace west::http
 			if(!validated_key || !validated_value)
 			{ throw std::runtime_error{"Tried to write an invalid field name or field value to a HTTP header"}; }
 
-			return append(std::move(*validated_key), *validated_value);
+			return append(std::move(*validated_key), std::move(*validated_value));
 		}
 
 		auto begin() const
@@ -448,28 +620,123 @@ namespace west::http
 		auto end() const
 		{ return std::end(m_fields); }
 
+		auto find(known_field id) const
+		{
+			return std::ranges::find_if(m_fields, [id](auto const& item) {
+				return item.first.id() == id;
+			});
+		}
+
 		auto find(std::string_view field_name) const
-		{ return m_fields.find(field_name); }
+		{
+			if(auto const id = to_known_field(field_name); id != known_field::unknown)
+			{ return find(id); }
+
+			return std::ranges::find_if(m_fields, [field_name](auto const& item) {
+				return item.first.id() == known_field::unknown && item.first == field_name;
+			});
+		}
 
 		[[nodiscard]] bool empty() const
 		{ return m_fields.empty(); }
 
+		[[nodiscard]] size_t size() const
+		{ return std::size(m_fields); }
+
+		bool contains(known_field id) const
+		{ return find(id) != end(); }
+
 		bool contains(std::string_view field_name) const
-		{ return m_fields.contains(field_name); }
+		{ return find(field_name) != end(); }
+
+		// Removes the field `id`, if present
+		void erase(known_field id)
+		{
+			auto const i = std::ranges::find_if(m_fields, [id](auto const& item) {
+				return item.first.id() == id;
+			});
+			if(i != std::end(m_fields))
+			{ m_fields.erase(i); }
+		}
 
 	private:
-		std::map<field_name, std::string, std::less<>> m_fields;
+		value_type* find_entry(field_name const& key)
+		{
+			return std::ranges::find_if(m_fields, [&key](auto const& item) {
+				return key.id() == known_field::unknown?
+					item.first.id() == known_field::unknown && item.first == key.value()
+					: item.first.id() == key.id();
+			});
+		}
+
+		small_vector<value_type, 8> m_fields;
 	};
 
 	inline auto get_content_length(field_map const& fields)
 	{
-		auto i = fields.find("Content-Length");
+		auto i = fields.find(known_field::content_length);
 		if(i == std::end(fields))
 		{ return std::optional<size_t>{0}; }
 
 		return to_number<size_t>(i->second);
 	}
 
+	// Returns true if the last transfer coding in `fields` is chunked
+	inline bool is_chunked(field_map const& fields)
+	{
+		auto i = fields.find(known_field::transfer_encoding);
+		if(i == std::end(fields))
+		{ return false; }
+
+		std::string_view codings{i->second};
+		auto const last_coding = codings.substr(codings.rfind(',') + 1);
+		auto const begin = last_coding.find_first_not_of(" \t");
+		if(begin == std::string_view::npos)
+		{ return false; }
+		auto const end = last_coding.find_last_not_of(" \t");
+		return iequals(last_coding.substr(begin, end - begin + 1), "chunked");
+	}
+
+	// Returns true if `fields` has a transfer-encoding with chunked as its only transfer coding
+	inline bool is_chunked_only(field_map const& fields)
+	{
+		auto i = fields.find(known_field::transfer_encoding);
+		if(i == std::end(fields))
+		{ return false; }
+
+		std::string_view coding{i->second};
+		auto const begin = coding.find_first_not_of(" \t");
+		if(begin == std::string_view::npos)
+		{ return false; }
+		auto const end = coding.find_last_not_of(" \t");
+		return iequals(coding.substr(begin, end - begin + 1), "chunked");
+	}
+
+	// Returns true if `option` is in the comma-separated list of connection options in `fields`
+	inline bool has_connection_option(field_map const& fields, std::string_view option)
+	{
+		auto i = fields.find(known_field::connection);
+		if(i == std::end(fields))
+		{ return false; }
+
+		std::string_view options{i->second};
+		while(true)
+		{
+			auto const separator = options.find(',');
+			auto const item = options.substr(0, separator);
+			if(auto const begin = item.find_first_not_of(" \t"); begin != std::string_view::npos)
+			{
+				auto const end = item.find_last_not_of(" \t");
+				if(iequals(item.substr(begin, end - begin + 1), option))
+				{ return true; }
+			}
+
+			if(separator == std::string_view::npos)
+			{ return false; }
+			options.remove_prefix(separator + 1);
+		}
+	}
+
 	struct request_line
 	{
 		request_method method;
@@ -486,6 +753,16 @@ namespace west::http
 	inline auto get_content_length(request_header const& header)
 	{ return get_content_length(header.fields); }
 
+	// Returns true if the client expects the connection to stay open after the response. HTTP/1.1
+	// connections are persistent unless the client sends "Connection: close", while HTTP/1.0
+	// connections are only kept open if the client sends "Connection: keep-alive".
+	inline bool is_persistent(request_header const& header)
+	{
+		if(header.request_line.http_version == version{1, 0})
+		{ return has_connection_option(header.fields, "keep-alive"); }
+		return !has_connection_option(header.fields, "close");
+	}
+
 	struct status_line
 	{
 		version http_version;
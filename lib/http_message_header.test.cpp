@@ -245,4 +245,167 @@ TESTCASE(west_http_field_value_create)
 		EXPECT_NE(*res, "A string with whitespace");
 		EXPECT_EQ(res->value(), "a string with whitespace");
 	}
-}
\ No newline at end of file
+}
+TESTCASE(west_http_to_known_field)
+{
+	EXPECT_EQ(west::http::to_known_field("Content-Length"), west::http::known_field::content_length);
+	EXPECT_EQ(west::http::to_known_field("content-length"), west::http::known_field::content_length);
+	EXPECT_EQ(west::http::to_known_field("HOST"), west::http::known_field::host);
+	EXPECT_EQ(west::http::to_known_field("date"), west::http::known_field::date);
+	EXPECT_EQ(west::http::to_known_field("accept-language"), west::http::known_field::accept_language);
+	EXPECT_EQ(west::http::to_known_field("Accept-Encoding"), west::http::known_field::accept_encoding);
+	EXPECT_EQ(west::http::to_known_field("Transfer-Encoding"), west::http::known_field::transfer_encoding);
+	EXPECT_EQ(west::http::to_known_field("Hostx"), west::http::known_field::unknown);
+	EXPECT_EQ(west::http::to_known_field("Cookies"), west::http::known_field::unknown);
+	EXPECT_EQ(west::http::to_known_field("Content-Lengtz"), west::http::known_field::unknown);
+	EXPECT_EQ(west::http::to_known_field(""), west::http::known_field::unknown);
+
+	for(auto k = static_cast<int>(west::http::known_field::accept);
+		k <= static_cast<int>(west::http::known_field::user_agent);
+		++k)
+	{
+		auto const id = static_cast<west::http::known_field>(k);
+		EXPECT_EQ(west::http::to_known_field(to_string(id)), id);
+	}
+
+	auto const name = west::http::field_name::create("connection");
+	REQUIRE_EQ(name.has_value(), true);
+	EXPECT_EQ(name->id(), west::http::known_field::connection);
+}
+
+TESTCASE(west_http_field_map_append_and_find)
+{
+	west::http::field_map fields;
+	EXPECT_EQ(fields.empty(), true);
+
+	fields.append("Host", "localhost")
+		.append("X-Custom", "foo")
+		.append("content-length", "10")
+		.append("x-custom", "bar")
+		.append("Accept", "text/html")
+		.append("accept", "")
+		.append("ACCEPT", "text/plain");
+
+	EXPECT_EQ(fields.size(), 4);
+	EXPECT_EQ(fields.find("HOST")->second, "localhost");
+	EXPECT_EQ(fields.find(west::http::known_field::host)->second, "localhost");
+	EXPECT_EQ(fields.find("X-CUSTOM")->second, "foo, bar");
+	EXPECT_EQ(fields.find("Accept")->second, "text/html, text/plain");
+	EXPECT_EQ(fields.contains("Content-Length"), true);
+	EXPECT_EQ(fields.contains(west::http::known_field::cookie), false);
+	EXPECT_EQ(fields.contains("X-Other"), false);
+	EXPECT_EQ(get_content_length(fields), 10);
+
+	// Fields are kept in the order they were first appended
+	std::vector<std::string> names;
+	for(auto const& item : fields)
+	{ names.push_back(item.first.value()); }
+	EXPECT_EQ(names.size(), 4);
+	EXPECT_EQ(names[0], "Host");
+	EXPECT_EQ(names[1], "X-Custom");
+	EXPECT_EQ(names[2], "content-length");
+	EXPECT_EQ(names[3], "Accept");
+}
+
+TESTCASE(west_http_field_map_erase)
+{
+	west::http::field_map fields;
+	fields.append("Host", "localhost")
+		.append("Transfer-Encoding", "chunked")
+		.append("Accept", "text/html");
+
+	fields.erase(west::http::known_field::transfer_encoding);
+	EXPECT_EQ(fields.size(), 2);
+	EXPECT_EQ(fields.contains(west::http::known_field::transfer_encoding), false);
+	EXPECT_EQ(fields.find("Accept")->second, "text/html");
+
+	fields.erase(west::http::known_field::transfer_encoding);
+	EXPECT_EQ(fields.size(), 2);
+}
+
+TESTCASE(west_http_field_map_many_fields)
+{
+	west::http::field_map fields;
+	for(size_t k = 0; k != 40; ++k)
+	{ fields.append("x-field-" + std::to_string(k), std::to_string(k)); }
+
+	EXPECT_EQ(fields.size(), 40);
+	for(size_t k = 0; k != 40; ++k)
+	{ EXPECT_EQ(fields.find("X-Field-" + std::to_string(k))->second, std::to_string(k)); }
+}
+
+TESTCASE(west_http_is_chunked)
+{
+	west::http::field_map fields;
+	EXPECT_EQ(is_chunked(fields), false);
+
+	fields.append("Transfer-Encoding", "gzip");
+	EXPECT_EQ(is_chunked(fields), false);
+
+	fields.append("transfer-encoding", "Chunked");
+	EXPECT_EQ(fields.find(west::http::known_field::transfer_encoding)->second, "gzip, Chunked");
+	EXPECT_EQ(is_chunked(fields), true);
+
+	west::http::field_map chunked_first;
+	chunked_first.append("Transfer-Encoding", "chunked, gzip");
+	EXPECT_EQ(is_chunked(chunked_first), false);
+}
+
+TESTCASE(west_http_is_chunked_only)
+{
+	west::http::field_map fields;
+	EXPECT_EQ(is_chunked_only(fields), false);
+
+	fields.append("Transfer-Encoding", "Chunked");
+	EXPECT_EQ(is_chunked_only(fields), true);
+
+	west::http::field_map stacked;
+	stacked.append("Transfer-Encoding", "gzip, chunked");
+	EXPECT_EQ(is_chunked(stacked), true);
+	EXPECT_EQ(is_chunked_only(stacked), false);
+
+	west::http::field_map repeated;
+	repeated.append("Transfer-Encoding", "gzip")
+		.append("Transfer-Encoding", "chunked");
+	EXPECT_EQ(is_chunked_only(repeated), false);
+
+	west::http::field_map twice;
+	twice.append("Transfer-Encoding", "chunked, chunked");
+	EXPECT_EQ(is_chunked_only(twice), false);
+}
+
+TESTCASE(west_http_has_connection_option)
+{
+	west::http::field_map fields;
+	EXPECT_EQ(has_connection_option(fields, "close"), false);
+
+	fields.append("Connection", "Upgrade");
+	EXPECT_EQ(has_connection_option(fields, "close"), false);
+	EXPECT_EQ(has_connection_option(fields, "upgrade"), true);
+
+	fields.append("connection", "Close");
+	EXPECT_EQ(has_connection_option(fields, "close"), true);
+
+	west::http::field_map with_whitespace;
+	with_whitespace.append("Connection", "foo ,\tkeep-alive\t, bar");
+	EXPECT_EQ(has_connection_option(with_whitespace, "keep-alive"), true);
+	EXPECT_EQ(has_connection_option(with_whitespace, "foo"), true);
+	EXPECT_EQ(has_connection_option(with_whitespace, "close"), false);
+}
+
+TESTCASE(west_http_is_persistent)
+{
+	west::http::request_header header;
+	header.request_line.http_version = west::http::version{1, 1};
+	EXPECT_EQ(is_persistent(header), true);
+
+	header.fields.append("Connection", "close");
+	EXPECT_EQ(is_persistent(header), false);
+
+	header.request_line.http_version = west::http::version{1, 0};
+	header.fields = west::http::field_map{};
+	EXPECT_EQ(is_persistent(header), false);
+
+	header.fields.append("Connection", "Keep-Alive");
+	EXPECT_EQ(is_persistent(header), true);
+}
@@ -0,0 +1,144 @@
+#ifndef WEST_HTTP_READ_REQUEST_CHUNKED_BODY_HPP
+#define WEST_HTTP_READ_REQUEST_CHUNKED_BODY_HPP
+
+#include "./io_interfaces.hpp"
+#include "./io_adapter.hpp"
+#include "./http_request_handler.hpp"
+#include "./http_session.hpp"
+#include "./http_chunked_body_decoder.hpp"
+#include "./utils.hpp"
+
+#include <limits>
+
+namespace west::http
+{
+	// NOTE: Chunk data is passed to process_request_content directly from the receive buffer, so a
+	//       chunk is never buffered as a whole. The `bytes_to_read` argument is the number of bytes
+	//       left in the current chunk, since the size of the body is not known. A chunk that would
+	//       make the body larger than `max_body_size` is rejected before any of its data is passed
+	//       on.
+	class read_request_chunked_body
+	{
+	public:
+		explicit read_request_chunked_body(chunked_decoder_limits const& limits = chunked_decoder_limits{},
+			size_t max_body_size = std::numeric_limits<size_t>::max()):
+			m_decoder{limits},
+			m_bytes_left{max_body_size}
+		{ }
+
+		template<io::data_source Source, class RequestHandler, size_t BufferSize>
+		[[nodiscard]] session_state_response socket_is_ready(io_adapter::buffer_span<char, BufferSize>& buffer,
+			session<Source, RequestHandler>& session);
+
+	private:
+		chunked_body_decoder m_decoder;
+		size_t m_bytes_left;
+	};
+}
+
+template<west::io::data_source Source, class RequestHandler, size_t BufferSize>
+[[nodiscard]] west::http::session_state_response west::http::read_request_chunked_body::socket_is_ready(
+	io_adapter::buffer_span<char, BufferSize>& buffer,
+	session<Source, RequestHandler>& session)
+{
+	while(true)
+	{
+		if(std::size(buffer.span_to_read()) == 0 && !m_decoder.is_completed())
+		{
+			auto const read_result = session.connection.read(buffer.span_to_write());
+			buffer.reset_with_new_length(read_result.bytes_read);
+			if(is_error_indicator(read_result.ec) || read_result.bytes_read == 0)
+			{
+				return make_read_response(read_result.ec, [](){
+					return to_string(chunked_decoder_error_code::more_data_needed);
+				});
+			}
+		}
+
+		auto const res = m_decoder.decode(buffer.span_to_read());
+		buffer.consume_elements(res.framing_bytes);
+
+		switch(res.ec)
+		{
+			case chunked_decoder_error_code::completed:
+			{
+				session.response_info = response_info{};
+				auto state_res = session.request_handler.finalize_state(session.response_info.header.fields);
+
+				session.response_info.header.status_line.http_version = version{1, 1};
+				auto const saved_http_status = state_res.http_status;
+				session.response_info.header.status_line.status_code = saved_http_status;
+				session.response_info.header.status_line.reason_phrase = to_string(saved_http_status);
+
+				return session_state_response{
+					.status = is_error(saved_http_status) ?
+						session_state_status::client_error_detected : session_state_status::completed,
+					.state_result = std::move(state_res)
+				};
+			}
+
+			case chunked_decoder_error_code::more_data_needed:
+				break;
+
+			case chunked_decoder_error_code::bad_chunk_size:
+			case chunked_decoder_error_code::chunk_size_line_too_long:
+			case chunked_decoder_error_code::expected_linefeed:
+			case chunked_decoder_error_code::trailer_too_long:
+			default:
+				buffer.reset_with_new_length(0);
+				return session_state_response{
+					.status = session_state_status::client_error_detected,
+					.state_result = finalize_state_result{
+						.http_status = status::bad_request,
+						.error_message = make_unique_cstr(to_string(res.ec))
+					}
+				};
+		}
+
+		if(std::size(res.payload) == 0)
+		{ continue; }
+
+		if(m_decoder.chunk_bytes_left() > m_bytes_left)
+		{
+			buffer.reset_with_new_length(0);
+			return session_state_response{
+				.status = session_state_status::client_error_detected,
+				.state_result = finalize_state_result{
+					.http_status = status::request_entity_too_large,
+					.error_message = make_unique_cstr("Request body too large")
+				}
+			};
+		}
+
+		auto const write_result = session.request_handler.process_request_content(res.payload,
+			m_decoder.chunk_bytes_left());
+		buffer.consume_elements(write_result.bytes_written);
+		m_decoder.consume_payload(write_result.bytes_written);
+		m_bytes_left -= write_result.bytes_written;
+
+		if(!can_continue(write_result.ec))
+		{
+			buffer.reset_with_new_length(0);
+			return session_state_response{
+				.status = session_state_status::client_error_detected,
+				.state_result = finalize_state_result{
+					.http_status = status::bad_request,
+					.error_message = make_unique_cstr(to_string(write_result.ec))
+				}
+			};
+		}
+
+		if(write_result.bytes_written == 0)
+		{
+			return session_state_response{
+				.status = session_state_status::more_data_needed,
+				.state_result = finalize_state_result{
+					.http_status = status::ok,
+					.error_message = nullptr
+				}
+			};
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,206 @@
+//@	{"target":{"name":"http_read_request_chunked_body.test"}}
+
+#include "./http_read_request_chunked_body.hpp"
+
+#include "stubs/data_source.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+namespace
+{
+	enum class test_result{completed, is_blocked, error};
+
+	constexpr bool is_error_indicator(test_result res)
+	{ return res != test_result::completed; }
+
+	constexpr char const* to_string(test_result res)
+	{
+		switch(res)
+		{
+			case test_result::completed:
+				return "Completed";
+			case test_result::is_blocked:
+				return "Is blocked";
+			case test_result::error:
+				return "Error";
+		}
+		__builtin_unreachable();
+	}
+
+	constexpr bool can_continue(test_result res)
+	{ return res == test_result::completed; }
+
+	struct result
+	{
+		size_t bytes_written;
+		test_result ec;
+	};
+
+	template<test_result Result>
+	struct request_handler
+	{
+		auto process_request_content(std::span<char const> buffer, size_t bytes_to_read)
+		{
+			if(Result == test_result::is_blocked)
+			{ return result{.bytes_written = 0, .ec = test_result::completed}; }
+
+			data_processed.insert(std::end(data_processed), std::begin(buffer), std::end(buffer));
+			max_bytes_to_read = std::max(max_bytes_to_read, bytes_to_read);
+
+			return result{
+				.bytes_written = std::size(buffer),
+				.ec = Result
+			};
+		}
+
+		auto finalize_state(west::http::field_map& resp_header_fields) const
+		{
+			resp_header_fields.append("Kaka", "Foobar");
+
+			return west::http::finalize_state_result {
+				.http_status = west::http::status::accepted,
+				.error_message = west::make_unique_cstr("Hej")
+			};
+		}
+
+		std::string data_processed;
+		size_t max_bytes_to_read{0};
+	};
+
+	constexpr std::string_view chunked_body{"1a\r\n"
+"Aenean at placerat tortor.\r\n"
+"20;foo=bar\r\n"
+" Proin tristique sit amet elit v\r\n"
+"0\r\n"
+"\r\n"
+"Some additional data."};
+}
+
+TESTCASE(http_read_request_chunked_body_read_all_data)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::stubs::data_source src{chunked_body};
+
+	west::http::session session{src,
+		request_handler<test_result::completed>{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+	west::http::read_request_chunked_body reader{};
+
+	auto res = reader.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::completed);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::accepted);
+	EXPECT_EQ(res.state_result.error_message.get(), std::string_view{"Hej"});
+	EXPECT_EQ(session.response_info.header.status_line.reason_phrase, "Accepted");
+	EXPECT_EQ(session.response_info.header.fields.find("Kaka")->second, "Foobar");
+	EXPECT_EQ(session.request_handler.data_processed,
+		"Aenean at placerat tortor. Proin tristique sit amet elit v");
+	EXPECT_EQ(session.request_handler.max_bytes_to_read, 32);
+	EXPECT_EQ(buff_span.span_to_read()[0], 'S');
+}
+
+TESTCASE(http_read_request_chunked_body_read_early_eof)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::stubs::data_source src{chunked_body.substr(0, 40)};
+
+	west::http::session session{src,
+		request_handler<test_result::completed>{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+	west::http::read_request_chunked_body reader{};
+
+	auto res = reader.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::bad_request);
+	EXPECT_EQ(res.state_result.error_message.get(), std::string_view{"Chunked body truncated"});
+}
+
+TESTCASE(http_read_request_chunked_body_read_bad_chunk_size)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::stubs::data_source src{std::string_view{"1a\r\nAenean at placerat tortor.\r\nfoo\r\n"}};
+
+	west::http::session session{src,
+		request_handler<test_result::completed>{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+	west::http::read_request_chunked_body reader{};
+
+	auto res = reader.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::bad_request);
+	EXPECT_EQ(res.state_result.error_message.get(), std::string_view{"Bad chunk size"});
+	EXPECT_EQ(session.request_handler.data_processed, "Aenean at placerat tortor.");
+}
+
+TESTCASE(http_read_request_chunked_body_read_req_handler_fails_to_read)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::stubs::data_source src{chunked_body};
+
+	west::http::session session{src,
+		request_handler<test_result::error>{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+	west::http::read_request_chunked_body reader{};
+
+	auto res = reader.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::bad_request);
+	EXPECT_EQ(res.state_result.error_message.get(), std::string_view{"Error"});
+}
+
+TESTCASE(http_read_request_chunked_body_read_req_handler_blocks_when_reading)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::stubs::data_source src{chunked_body};
+
+	west::http::session session{src,
+		request_handler<test_result::is_blocked>{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+	west::http::read_request_chunked_body reader{};
+
+	auto res = reader.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::more_data_needed);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::ok);
+	EXPECT_EQ(res.state_result.error_message.get(), nullptr);
+}
+
+TESTCASE(http_read_request_chunked_body_read_body_too_large)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::stubs::data_source src{chunked_body};
+
+	west::http::session session{src,
+		request_handler<test_result::completed>{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+	west::http::read_request_chunked_body reader{west::http::chunked_decoder_limits{}, 40};
+
+	// The second chunk is rejected before any of it is passed to the request handler
+	auto res = reader.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::request_entity_too_large);
+	EXPECT_EQ(res.state_result.error_message.get(), std::string_view{"Request body too large"});
+	EXPECT_EQ(session.request_handler.data_processed, "Aenean at placerat tortor.");
+}
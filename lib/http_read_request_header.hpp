@@ -20,9 +20,15 @@ namespace west::http
 		[[nodiscard]] auto socket_is_ready(io_adapter::buffer_span<char, BufferSize>& buffer,
 			session<Source, RequestHandler>& session);
 
+		// Returns the status of the header parser. If the header was rejected while the status is
+		// more_data_needed, the header was too large.
+		[[nodiscard]] req_header_parser_error_code parser_status() const
+		{ return m_parser_status; }
+
 	private:
 		request_header_parser m_req_header_parser;
 		size_t m_bytes_to_read;
+		req_header_parser_error_code m_parser_status{req_header_parser_error_code::more_data_needed};
 	};
 }
 
@@ -64,7 +70,8 @@ template<west::io::data_source Source, class RequestHandler, size_t BufferSize>
 					return to_string(req_header_parser_error_code::more_data_needed);
 				});
 			},
-			[&req_header_parser = m_req_header_parser, &session](req_header_parser_error_code ec, auto&&...){
+			[&req_header_parser = m_req_header_parser, &parser_status = m_parser_status, &session](req_header_parser_error_code ec, auto&&...){
+				parser_status = ec;
 				switch(ec)
 				{
 				// GCOVR_EXCL_START
@@ -75,18 +82,87 @@ template<west::io::data_source Source, class RequestHandler, size_t BufferSize>
 					{
 						auto& header = session.request_info.header;
 						header = req_header_parser.take_result();
-						if(header.request_line.http_version != version{1, 1})
+						if(header.request_line.http_version != version{1, 1}
+							&& header.request_line.http_version != version{1, 0})
 						{
 							return session_state_response{
 								.status = session_state_status::client_error_detected,
 								.state_result = finalize_state_result{
 									.http_status = status::http_version_not_supported,
-									.error_message = make_unique_cstr("This web server only supports HTTP version 1.1")
+									.error_message = make_unique_cstr("This web server only supports HTTP version 1.0 and 1.1")
+								}
+							};
+						}
+						session.request_info.keep_alive = is_persistent(header);
+
+						auto const expect = header.fields.find(known_field::expect);
+						if(expect != std::end(header.fields) && !iequals(std::string_view{expect->second}, "100-continue"))
+						{
+							return session_state_response{
+								.status = session_state_status::client_error_detected,
+								.state_result = finalize_state_result{
+									.http_status = status::expectation_failed,
+									.error_message = make_unique_cstr("Unsupported expectation")
 								}
 							};
 						}
 
-						// TODO: Introduce limit on content-length here
+						if(header.fields.contains(known_field::transfer_encoding))
+						{
+							// NOTE: Transfer-encoding is not defined for HTTP/1.0, so the end of the
+							//       body cannot be trusted
+							if(header.request_line.http_version == version{1, 0})
+							{
+								return session_state_response{
+									.status = session_state_status::client_error_detected,
+									.state_result = finalize_state_result{
+										.http_status = status::bad_request,
+										.error_message = make_unique_cstr("Transfer-encoding is not supported in HTTP/1.0")
+									}
+								};
+							}
+
+							// NOTE: A request with both transfer-encoding and content-length may be an
+							//       attempt to smuggle a request through a proxy. Without chunked as the
+							//       final transfer coding, the end of the body cannot be found.
+							if(!is_chunked(header.fields) || header.fields.contains(known_field::content_length))
+							{
+								return session_state_response{
+									.status = session_state_status::client_error_detected,
+									.state_result = finalize_state_result{
+										.http_status = status::bad_request,
+										.error_message = make_unique_cstr("Bad transfer-encoding")
+									}
+								};
+							}
+
+							// NOTE: Other transfer codings, such as gzip applied before chunked, are
+							//       not decoded
+							if(!is_chunked_only(header.fields))
+							{
+								return session_state_response{
+									.status = session_state_status::client_error_detected,
+									.state_result = finalize_state_result{
+										.http_status = status::not_implemented,
+										.error_message = make_unique_cstr("Unsupported transfer-encoding")
+									}
+								};
+							}
+
+							auto res = session.request_handler.finalize_state(header);
+							session.request_info.content_length = 0;
+							session.request_info.body_is_chunked = true;
+							session.request_info.expects_continue = expect != std::end(header.fields);
+							auto const saved_http_status = res.http_status;
+							return session_state_response{
+								.status = is_error(saved_http_status) ?
+									session_state_status::client_error_detected : session_state_status::completed,
+								.state_result = std::move(res)
+							};
+						}
+
+						// NOTE: The content-length is checked against the body size limit by the request
+						//       processor, after the request handler has seen the header
 						auto const content_length = get_content_length(header);
 						if(!content_length.has_value())
 						{
@@ -101,6 +177,10 @@ template<west::io::data_source Source, class RequestHandler, size_t BufferSize>
 
 						auto res = session.request_handler.finalize_state(header);
 						session.request_info.content_length = *content_length;
+						session.request_info.body_is_chunked = false;
+						session.request_info.expects_continue = expect != std::end(header.fields)
+							&& header.request_line.http_version == version{1, 1}
+							&& *content_length != 0;
 						auto const saved_http_status = res.http_status;
 						return session_state_response{
 							.status = is_error(saved_http_status) ?
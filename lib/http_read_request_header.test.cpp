@@ -83,7 +83,7 @@ TESTCASE(west_http_read_request_header_read_unsupported_http_version)
 	EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
 	EXPECT_EQ(res.state_result.http_status, west::http::status::http_version_not_supported);
 	EXPECT_EQ(res.state_result.error_message.get(),
-		std::string_view{"This web server only supports HTTP version 1.1"});
+		std::string_view{"This web server only supports HTTP version 1.0 and 1.1"});
 	auto const remaining_data = buff_span.span_to_read();
 	EXPECT_EQ(std::size(remaining_data), 0);
 }
@@ -146,4 +146,71 @@ TESTCASE(west_http_read_request_header_read_oversized_header)
 	auto const remaining_data = buff_span.span_to_read();
 	EXPECT_EQ(std::size(remaining_data), 3);
 	EXPECT_EQ(std::string_view{session.connection.get_pointer()}, "");
-}
\ No newline at end of file
+}
+
+namespace
+{
+	auto read_header_with_transfer_encoding(std::string_view fields, std::string_view http_version = "1.1")
+	{
+		std::array<char, 4096> buffer{};
+		west::io_adapter::buffer_span buff_span{buffer};
+
+		auto const serialized_header = std::string{"POST / HTTP/"}
+			.append(http_version)
+			.append("\r\nhost: localhost:80\r\n")
+			.append(fields)
+			.append("\r\n");
+		west::stubs::data_source src{std::string_view{serialized_header}};
+		west::http::session session{src, request_handler{}, west::http::request_info{}, west::http::response_header{}};
+		west::http::read_request_header reader{std::size(serialized_header)};
+		auto res = reader.socket_is_ready(buff_span, session);
+		return std::pair{std::move(res), session.request_info.body_is_chunked};
+	}
+}
+
+TESTCASE(west_http_read_request_header_read_transfer_encoding)
+{
+	{
+		auto const [res, body_is_chunked] = read_header_with_transfer_encoding("Transfer-Encoding: Chunked\r\n");
+		EXPECT_EQ(res.status, west::http::session_state_status::completed);
+		EXPECT_EQ(body_is_chunked, true);
+	}
+
+	{
+		auto const [res, body_is_chunked] = read_header_with_transfer_encoding("Transfer-Encoding: gzip, chunked\r\n");
+		EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
+		EXPECT_EQ(res.state_result.http_status, west::http::status::not_implemented);
+		EXPECT_EQ(res.state_result.error_message.get(), std::string_view{"Unsupported transfer-encoding"});
+		EXPECT_EQ(body_is_chunked, false);
+	}
+
+	{
+		auto const [res, body_is_chunked] = read_header_with_transfer_encoding("Transfer-Encoding: gzip\r\n"
+			"Transfer-Encoding: chunked\r\n");
+		EXPECT_EQ(res.state_result.http_status, west::http::status::not_implemented);
+		EXPECT_EQ(body_is_chunked, false);
+	}
+
+	{
+		auto const [res, body_is_chunked] = read_header_with_transfer_encoding("Transfer-Encoding: chunked, gzip\r\n");
+		EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
+		EXPECT_EQ(res.state_result.http_status, west::http::status::bad_request);
+		EXPECT_EQ(body_is_chunked, false);
+	}
+
+	{
+		auto const [res, body_is_chunked] = read_header_with_transfer_encoding("Transfer-Encoding: chunked\r\n"
+			"Content-Length: 10\r\n");
+		EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
+		EXPECT_EQ(res.state_result.http_status, west::http::status::bad_request);
+		EXPECT_EQ(body_is_chunked, false);
+	}
+}
+
+TESTCASE(west_http_read_request_header_read_transfer_encoding_http_1_0)
+{
+	auto const [res, body_is_chunked] = read_header_with_transfer_encoding("Transfer-Encoding: chunked\r\n", "1.0");
+	EXPECT_EQ(res.status, west::http::session_state_status::client_error_detected);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::bad_request);
+	EXPECT_EQ(body_is_chunked, false);
+}
@@ -3,8 +3,10 @@
 
 #include "./http_message_header.hpp"
 #include "./io_adapter.hpp"
+#include "./io_interfaces.hpp"
 
 #include <memory>
+#include <optional>
 
 namespace west::http
 {
@@ -21,6 +23,24 @@ namespace west::http
 		{can_continue(x)} -> std::same_as<bool>;
 	};
 
+	// An error code may provide is_would_block(), to tell that the request handler has no response
+	// data right now, but that more will follow. Without it, reading no data with an error code for
+	// which can_continue is true ends a chunked response body.
+	template<class T>
+	concept would_block_error_code = error_code<T> && requires(T x)
+	{
+		{is_would_block(x)} -> std::same_as<bool>;
+	};
+
+	template<error_code T>
+	constexpr bool indicates_would_block(T ec)
+	{
+		if constexpr(would_block_error_code<T>)
+		{ return is_would_block(ec); }
+		else
+		{ return false; }
+	}
+
 	template<class T>
 	concept process_request_content_result = requires(T x)
 	{
@@ -54,6 +74,43 @@ namespace west::http
 
 		{x.read_response_content(output_buffer)} -> read_response_content_result;
 	};
+
+	// A request handler may provide response_body_file(), to have the response body written directly
+	// from a file (with sendfile), instead of through read_response_content. The function is called
+	// when the body is about to be written, and must return the same value until the body has been
+	// written. If it returns nullopt, read_response_content is used.
+	template<class T>
+	concept file_backed_request_handler = requires(T x)
+	{
+		{x.response_body_file()} -> std::same_as<std::optional<io::file_range>>;
+	};
+
+	template<class RequestHandler, class Sink>
+	std::optional<io::file_range> get_response_body_file(RequestHandler& req_handler)
+	{
+		if constexpr(file_backed_request_handler<RequestHandler> && io::file_sink<Sink>)
+		{ return req_handler.response_body_file(); }
+		else
+		{ return std::nullopt; }
+	}
+
+	// A request handler may provide max_request_body_size(), to limit the size of the request body
+	// per request, for example depending on the request target. The function is called after
+	// finalize_state(request_header const&). If it returns nullopt, the limit of the service is used.
+	template<class T>
+	concept body_size_limiting_request_handler = requires(T x)
+	{
+		{x.max_request_body_size()} -> std::same_as<std::optional<size_t>>;
+	};
+
+	template<class RequestHandler>
+	std::optional<size_t> get_max_request_body_size(RequestHandler& req_handler)
+	{
+		if constexpr(body_size_limiting_request_handler<RequestHandler>)
+		{ return req_handler.max_request_body_size(); }
+		else
+		{ return std::nullopt; }
+	}
 }
 
 #endif
\ No newline at end of file
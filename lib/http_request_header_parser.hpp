@@ -2,6 +2,7 @@
 #define WEST_HTTP_REQUEST_HEADER_PARSER_HPP
 
 #include "./http_message_header.hpp"
+#include "./http_char_scanner.hpp"
 #include "./utils.hpp"
 
 #include <functional>
@@ -117,6 +118,33 @@ namespace west::http
 			expect_linefeed_and_return
 		};
 
+		// Returns the chars that are consumed without changing state, for states where long runs of
+		// such chars are common
+		static constexpr char_class const* run_chars(state current_state)
+		{
+			switch(current_state)
+			{
+				case state::req_line_read_method:
+				case state::fields_read_name:
+					return &token_chars;
+				case state::req_line_read_req_target:
+					return &request_target_chars;
+				case state::fields_read_value:
+					return &field_value_chars;
+				case state::req_line_read_protocol_name:
+				case state::req_line_read_protocol_version_major:
+				case state::req_line_read_protocol_version_minor:
+				case state::fields_terminate_at_no_field_name:
+				case state::fields_skip_ws_before_field_value:
+				case state::fields_check_continuation:
+				case state::fields_skip_ws_after_newline:
+				case state::expect_linefeed:
+				case state::expect_linefeed_and_return:
+					return nullptr;
+			}
+			__builtin_unreachable();
+		}
+
 		state m_current_state;
 		state m_state_after_newline;
 		std::string m_buffer;
@@ -131,6 +159,18 @@ auto west::http::request_header_parser::parse(InputSeq input_seq)
 	auto ptr = std::begin(input_seq);
 	while(true)
 	{
+		if constexpr(std::contiguous_iterator<decltype(ptr)>)
+		{
+			// NOTE: All chars in the run would have been appended to m_buffer by the state machine
+			if(auto const cc = run_chars(m_current_state); cc != nullptr)
+			{
+				auto const first = std::to_address(ptr);
+				auto const stop = find_first_not_of(*cc, first, first + (std::end(input_seq) - ptr));
+				m_buffer.append(first, stop);
+				ptr += stop - first;
+			}
+		}
+
 		if(ptr == std::end(input_seq))
 		{ return req_header_parse_result{ptr, req_header_parser_error_code::more_data_needed}; }
 
@@ -0,0 +1,47 @@
+//@	{"target":{"name":"http_request_header_view.bench"}}
+
+#include "./http_request_header_view.hpp"
+
+#include "bench/benchmark.hpp"
+
+#include <cassert>
+#include <string>
+
+namespace
+{
+	constexpr std::string_view browser_header{"GET /index.html HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/111.0\r\n"
+"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+"Accept-Language: sv-SE,sv;q=0.8,en-US;q=0.5,en;q=0.3\r\n"
+"Accept-Encoding: gzip, deflate, br\r\n"
+"DNT: 1\r\n"
+"Connection: keep-alive\r\n"
+"Upgrade-Insecure-Requests: 1\r\n"
+"Sec-Fetch-Dest: document\r\n"
+"Sec-Fetch-Mode: navigate\r\n"
+"Sec-Fetch-Site: none\r\n"
+"Sec-Fetch-User: ?1\r\n"
+"\r\n"};
+}
+
+// NOTE: Compares the parser that refers to the input buffer with the parser that copies the
+//       header into a request_header
+int main()
+{
+	std::string const input{browser_header};
+
+	west::bench::run("request_header_view_parser/browser", std::size(input), [&input](){
+		west::http::request_header_view_parser parser{};
+		[[maybe_unused]] auto const res = parser.parse(input);
+		assert(res.ec == west::http::req_header_parser_error_code::completed);
+		west::bench::do_not_optimize(parser.result());
+	});
+
+	west::bench::run("request_header_parser/browser", std::size(input), [&input](){
+		west::http::request_header_parser parser{};
+		[[maybe_unused]] auto const res = parser.parse(std::string_view{input});
+		assert(res.ec == west::http::req_header_parser_error_code::completed);
+		west::bench::do_not_optimize(parser.take_result());
+	});
+}
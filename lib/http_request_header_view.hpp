@@ -0,0 +1,271 @@
+#ifndef WEST_HTTP_REQUEST_HEADER_VIEW_HPP
+#define WEST_HTTP_REQUEST_HEADER_VIEW_HPP
+
+#include "./http_request_header_parser.hpp"
+#include "./small_vector.hpp"
+
+#include <string_view>
+#include <string>
+#include <list>
+#include <span>
+
+namespace west::http
+{
+	struct request_header_view
+	{
+		std::string_view method;
+		std::string_view request_target;
+		version http_version;
+
+		// NOTE: Fields are stored in the order they appear in the header. Repeated fields are not
+		//       merged.
+		small_vector<std::pair<std::string_view, std::string_view>, 32> fields;
+
+		std::optional<std::string_view> find(std::string_view name) const
+		{
+			for(auto const& item : fields)
+			{
+				if(stricmp(item.first, name) == 0)
+				{ return item.second; }
+			}
+			return std::nullopt;
+		}
+	};
+
+	// NOTE: Unlike request_header_parser, this parser does not copy the header. If the entire header
+	//       is passed to parse in one call, all string_views in the result refer to the input. If the
+	//       header is split across several calls, the parts are copied to an internal buffer, and the
+	//       string_views refer to that buffer. Folded field values are joined in separate storage.
+	//
+	//       Since the header is validated first when it is complete, errors are reported later than
+	//       with request_header_parser.
+	//
+	//       When parse has returned anything but more_data_needed, the next call to parse starts a new
+	//       header. The result of the previous header is valid until then.
+	class request_header_view_parser
+	{
+	public:
+		explicit request_header_view_parser(size_t max_header_size = 65536):
+			m_max_header_size{max_header_size}
+		{}
+
+		// Parses the next part of the header. If the header is larger than max_header_size, no more
+		// input is consumed, more_data_needed is returned, and header_too_large() returns true.
+		[[nodiscard]] req_header_parse_result<char const*> parse(std::span<char const> input);
+
+		[[nodiscard]] request_header_view const& result() const
+		{ return m_result; }
+
+		// Returns true if the result refers to internal storage instead of the input
+		[[nodiscard]] bool uses_internal_storage() const
+		{ return !m_pending.empty() || !m_folded_values.empty(); }
+
+		[[nodiscard]] bool header_too_large() const
+		{ return m_header_too_large; }
+
+		void reset()
+		{
+			m_result = request_header_view{};
+			m_pending.clear();
+			m_folded_values.clear();
+			m_header_completed = false;
+			m_header_too_large = false;
+		}
+
+	private:
+		req_header_parser_error_code parse_complete_header(std::string_view header);
+		req_header_parser_error_code parse_request_line(std::string_view line);
+		req_header_parser_error_code parse_fields(std::string_view fields);
+
+		req_header_parse_result<char const*> complete_header(char const* ptr, std::string_view header)
+		{
+			m_header_completed = true;
+			return req_header_parse_result{ptr, parse_complete_header(header)};
+		}
+
+		req_header_parse_result<char const*> reject_too_large(std::span<char const> input)
+		{
+			m_header_too_large = true;
+			return req_header_parse_result{std::data(input), req_header_parser_error_code::more_data_needed};
+		}
+
+		request_header_view m_result;
+		std::string m_pending;
+		std::list<std::string> m_folded_values;
+		size_t m_max_header_size;
+		bool m_header_completed{false};
+		bool m_header_too_large{false};
+	};
+
+	namespace detail
+	{
+		inline std::string_view trim_strict_whitespace(std::string_view str)
+		{
+			while(!str.empty() && is_strict_whitespace(str.front()))
+			{ str.remove_prefix(1); }
+
+			while(!str.empty() && is_strict_whitespace(str.back()))
+			{ str.remove_suffix(1); }
+
+			return str;
+		}
+
+		inline bool is_valid_field_value(std::string_view str)
+		{
+			return std::ranges::none_of(str, [](auto val){
+				return is_not_printable(val) && !is_strict_whitespace(val);
+			});
+		}
+	}
+}
+
+inline west::http::req_header_parse_result<char const*>
+west::http::request_header_view_parser::parse(std::span<char const> input)
+{
+	constexpr std::string_view header_end{"\r\n\r\n"};
+	std::string_view const input_str{std::data(input), std::size(input)};
+
+	if(m_header_completed)
+	{ reset(); }
+
+	if(m_header_too_large)
+	{ return reject_too_large(input); }
+
+	if(m_pending.empty())
+	{
+		if(auto const i = input_str.find(header_end); i != std::string_view::npos)
+		{
+			auto const length = i + std::size(header_end);
+			if(length > m_max_header_size)
+			{ return reject_too_large(input); }
+
+			return complete_header(std::data(input) + length, input_str.substr(0, length));
+		}
+
+		if(std::size(input_str) > m_max_header_size)
+		{ return reject_too_large(input); }
+
+		m_pending = input_str;
+		return req_header_parse_result{std::data(input) + std::size(input), req_header_parser_error_code::more_data_needed};
+	}
+
+	// The end of the header may be split between the pending data and the input
+	auto const old_size = std::size(m_pending);
+	auto const search_from = old_size >= std::size(header_end) - 1? old_size - (std::size(header_end) - 1) : 0;
+	m_pending.append(input_str.substr(0, m_max_header_size - old_size + 1));
+	auto const i = std::string_view{m_pending}.find(header_end, search_from);
+	if(i == std::string_view::npos || i + std::size(header_end) > m_max_header_size)
+	{
+		if(std::size(m_pending) > m_max_header_size)
+		{
+			m_pending.resize(old_size);
+			return reject_too_large(input);
+		}
+		return req_header_parse_result{std::data(input) + std::size(input), req_header_parser_error_code::more_data_needed};
+	}
+
+	auto const length = i + std::size(header_end);
+	m_pending.resize(length);
+	return complete_header(std::data(input) + (length - old_size), m_pending);
+}
+
+inline west::http::req_header_parser_error_code
+west::http::request_header_view_parser::parse_complete_header(std::string_view header)
+{
+	m_result.fields.clear();
+	auto const request_line_end = header.find("\r\n");
+	if(auto const res = parse_request_line(header.substr(0, request_line_end));
+		res != req_header_parser_error_code::completed)
+	{ return res; }
+
+	return parse_fields(header.substr(request_line_end + 2));
+}
+
+inline west::http::req_header_parser_error_code
+west::http::request_header_view_parser::parse_request_line(std::string_view line)
+{
+	auto const method_end = line.find(' ');
+	if(method_end == std::string_view::npos || !is_token(line.substr(0, method_end)))
+	{ return req_header_parser_error_code::bad_request_method; }
+	m_result.method = line.substr(0, method_end);
+	line.remove_prefix(method_end + 1);
+
+	auto const target_end = line.find(' ');
+	if(target_end == std::string_view::npos || target_end == 0 || contains_whitespace(line.substr(0, target_end)))
+	{ return req_header_parser_error_code::bad_request_target; }
+	m_result.request_target = line.substr(0, target_end);
+	line.remove_prefix(target_end + 1);
+
+	constexpr std::string_view protocol{"HTTP/"};
+	if(!line.starts_with(protocol))
+	{ return req_header_parser_error_code::wrong_protocol; }
+	line.remove_prefix(std::size(protocol));
+
+	auto const dot = line.find('.');
+	if(dot == std::string_view::npos)
+	{ return req_header_parser_error_code::bad_protocol_version; }
+
+	auto const major = to_number<uint32_t>(line.substr(0, dot));
+	auto const minor = to_number<uint32_t>(line.substr(dot + 1));
+	if(!major.has_value() || !minor.has_value())
+	{ return req_header_parser_error_code::bad_protocol_version; }
+
+	m_result.http_version = version{*major, *minor};
+	return req_header_parser_error_code::completed;
+}
+
+inline west::http::req_header_parser_error_code
+west::http::request_header_view_parser::parse_fields(std::string_view fields)
+{
+	std::string* folded_value = nullptr;
+	while(true)
+	{
+		auto const line_end = fields.find('\r');
+		assert(line_end != std::string_view::npos);
+		if(line_end + 1 == std::size(fields) || fields[line_end + 1] != '\n')
+		{ return req_header_parser_error_code::expected_linefeed; }
+
+		auto const line = fields.substr(0, line_end);
+		fields.remove_prefix(line_end + 2);
+
+		if(line.empty())
+		{ return req_header_parser_error_code::completed; }
+
+		if(is_strict_whitespace(line.front()))
+		{
+			// Obsolete line folding. The value has to be joined with the previous line.
+			if(m_result.fields.empty())
+			{ return req_header_parser_error_code::bad_field_name; }
+
+			auto const continuation = detail::trim_strict_whitespace(line);
+			if(continuation.empty())
+			{ continue; }
+
+			if(!detail::is_valid_field_value(continuation))
+			{ return req_header_parser_error_code::bad_field_value; }
+
+			auto& value = m_result.fields[std::size(m_result.fields) - 1].second;
+			if(folded_value == nullptr)
+			{ folded_value = &m_folded_values.emplace_back(value); }
+
+			if(!folded_value->empty())
+			{ folded_value->append(" "); }
+			folded_value->append(continuation);
+			value = *folded_value;
+			continue;
+		}
+
+		folded_value = nullptr;
+		auto const colon = line.find(':');
+		if(colon == std::string_view::npos || !is_token(line.substr(0, colon)))
+		{ return req_header_parser_error_code::bad_field_name; }
+
+		auto const value = detail::trim_strict_whitespace(line.substr(colon + 1));
+		if(!detail::is_valid_field_value(value))
+		{ return req_header_parser_error_code::bad_field_value; }
+
+		m_result.fields.emplace_back(line.substr(0, colon), value);
+	}
+}
+
+#endif
@@ -0,0 +1,244 @@
+//@	{"target":{"name":"http_request_header_view.test"}}
+
+#include "./http_request_header_view.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	size_t allocation_count = 0;
+
+	constexpr std::string_view browser_header{"GET /index.html HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/111.0\r\n"
+"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+"Accept-Language: sv-SE,sv;q=0.8,en-US;q=0.5,en;q=0.3\r\n"
+"Accept-Encoding: gzip, deflate, br\r\n"
+"DNT: 1\r\n"
+"Connection: keep-alive\r\n"
+"Upgrade-Insecure-Requests: 1\r\n"
+"Sec-Fetch-Dest: document\r\n"
+"Sec-Fetch-Mode: navigate\r\n"
+"Sec-Fetch-Site: none\r\n"
+"Sec-Fetch-User: ?1\r\n"
+"\r\n"};
+}
+
+// NOTE: GCC does not know that the global operator new has been replaced
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(size_t size)
+{
+	++allocation_count;
+	if(auto const ret = malloc(size); ret != nullptr)
+	{ return ret; }
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{ free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept
+{ free(ptr); }
+
+TESTCASE(west_http_request_header_view_parser_parse_complete_header)
+{
+	std::string_view serialized_header{"GET / HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"Accept: text/html,application/xhtml+xml,application/xml;\r\n"
+"\t q=0.9,image/avif,image/webp,*/*;\r\n"
+" \r\n"
+" \tq=0.8\r\n"
+"Accept-Encoding: gzip, deflate\r\n"
+"Accept-Encoding: br\r\n"
+"Key-without-value-1:   \r\n"
+"Key-without-value-2:\r\n"
+"Key-with-value-between-whitespace:  foo   \r\n"
+"\r\nSome additional data"};
+
+	west::http::request_header_view_parser parser{};
+	auto const res = parser.parse(serialized_header);
+	EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::completed);
+	EXPECT_EQ(std::string_view{res.ptr}, "Some additional data");
+
+	auto const& header = parser.result();
+	EXPECT_EQ(header.method, "GET");
+	EXPECT_EQ(header.request_target, "/");
+	EXPECT_EQ(header.http_version, west::http::version(1, 1));
+	REQUIRE_EQ(std::size(header.fields), 7);
+	EXPECT_EQ(header.find("host"), "localhost:8000");
+	EXPECT_EQ(header.find("accept"),
+		"text/html,application/xhtml+xml,application/xml; "
+		"q=0.9,image/avif,image/webp,*/*; "
+		"q=0.8");
+	EXPECT_EQ(header.fields[2].second, "gzip, deflate");
+	EXPECT_EQ(header.fields[3].second, "br");
+	EXPECT_EQ(header.find("key-without-value-1"), "");
+	EXPECT_EQ(header.find("key-without-value-2"), "");
+	EXPECT_EQ(header.find("Key-with-value-between-whitespace"), "foo");
+	EXPECT_EQ(header.find("Content-Length").has_value(), false);
+
+	// Only the folded value is copied
+	EXPECT_EQ(header.find("host")->data(), serialized_header.data() + 22);
+	EXPECT_EQ(parser.uses_internal_storage(), true);
+}
+
+TESTCASE(west_http_request_header_view_parser_parse_header_in_blocks)
+{
+	std::string_view serialized_header{"POST /foo HTTP/1.0\r\n"
+"Host: localhost:8000\r\n"
+"Content-Length: 20\r\n"
+"\r\nSome additional data"};
+
+	// Try all split points, including those inside the final CRLFCRLF
+	for(size_t k = 1; k != std::size(serialized_header) - 20; ++k)
+	{
+		west::http::request_header_view_parser parser{};
+		auto res = parser.parse(serialized_header.substr(0, k));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::more_data_needed);
+		EXPECT_EQ(res.ptr, serialized_header.data() + k);
+
+		auto const rest = serialized_header.substr(k);
+		res = parser.parse(rest);
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::completed);
+		EXPECT_EQ(std::string_view{res.ptr}, "Some additional data");
+		EXPECT_EQ(parser.uses_internal_storage(), true);
+
+		auto const& header = parser.result();
+		EXPECT_EQ(header.method, "POST");
+		EXPECT_EQ(header.request_target, "/foo");
+		EXPECT_EQ(header.http_version, west::http::version(1, 0));
+		EXPECT_EQ(header.find("host"), "localhost:8000");
+		EXPECT_EQ(header.find("content-length"), "20");
+	}
+}
+
+TESTCASE(west_http_request_header_view_parser_parse_next_header_without_reset)
+{
+	std::string_view first_header{"GET /first HTTP/1.1\r\n"
+"Accept: text/html,\r\n"
+" text/plain\r\n"
+"\r\n"};
+	std::string_view second_header{"GET /second HTTP/1.1\r\n"
+"Accept: image/png,\r\n"
+" image/webp\r\n"
+"\r\n"};
+
+	west::http::request_header_view_parser parser{};
+	for(size_t k = 0; k != 3; ++k)
+	{
+		auto res = parser.parse(first_header.substr(0, 10));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::more_data_needed);
+		res = parser.parse(first_header.substr(10));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::completed);
+		EXPECT_EQ(res.ptr, std::data(first_header) + std::size(first_header));
+		EXPECT_EQ(parser.result().request_target, "/first");
+		EXPECT_EQ(parser.result().find("accept"), "text/html, text/plain");
+
+		res = parser.parse(second_header.substr(0, 30));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::more_data_needed);
+		res = parser.parse(second_header.substr(30));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::completed);
+		EXPECT_EQ(res.ptr, std::data(second_header) + std::size(second_header));
+		EXPECT_EQ(parser.result().request_target, "/second");
+		EXPECT_EQ(parser.result().find("accept"), "image/png, image/webp");
+		REQUIRE_EQ(std::size(parser.result().fields), 1);
+	}
+
+	// A header in one piece after one that was split refers to the input again
+	auto const res = parser.parse(std::string_view{"GET / HTTP/1.1\r\n\r\n"});
+	EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::completed);
+	EXPECT_EQ(parser.uses_internal_storage(), false);
+	EXPECT_EQ(std::size(parser.result().fields), 0);
+}
+
+TESTCASE(west_http_request_header_view_parser_header_too_large)
+{
+	std::string_view serialized_header{"GET / HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"\r\n"};
+
+	{
+		west::http::request_header_view_parser parser{std::size(serialized_header)};
+		auto const res = parser.parse(serialized_header);
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::completed);
+		EXPECT_EQ(parser.header_too_large(), false);
+	}
+
+	{
+		west::http::request_header_view_parser parser{std::size(serialized_header) - 1};
+		auto const res = parser.parse(serialized_header);
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::more_data_needed);
+		EXPECT_EQ(res.ptr, std::data(serialized_header));
+		EXPECT_EQ(parser.header_too_large(), true);
+	}
+
+	// Split at every point, the pending data never grows past the limit
+	for(size_t k = 1; k != std::size(serialized_header); ++k)
+	{
+		west::http::request_header_view_parser parser{std::size(serialized_header) - 1};
+		auto res = parser.parse(serialized_header.substr(0, k));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::more_data_needed);
+		EXPECT_EQ(res.ptr, std::data(serialized_header) + k);
+		EXPECT_EQ(parser.header_too_large(), false);
+
+		res = parser.parse(serialized_header.substr(k));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::more_data_needed);
+		EXPECT_EQ(res.ptr, std::data(serialized_header) + k);
+		EXPECT_EQ(parser.header_too_large(), true);
+
+		parser.reset();
+		res = parser.parse(std::string_view{"GET / HTTP/1.1\r\n\r\n"});
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::completed);
+	}
+
+	{
+		west::http::request_header_view_parser parser{20};
+		std::string const garbage(64, 'a');
+		auto res = parser.parse(std::string_view{garbage}.substr(0, 10));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::more_data_needed);
+		res = parser.parse(std::string_view{garbage}.substr(10));
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::more_data_needed);
+		EXPECT_EQ(parser.header_too_large(), true);
+	}
+}
+
+TESTCASE(west_http_request_header_view_parser_errors)
+{
+	auto parse = [](std::string_view str) {
+		west::http::request_header_view_parser parser{};
+		return parser.parse(str).ec;
+	};
+
+	EXPECT_EQ(parse("G(T / HTTP/1.1\r\n\r\n"), west::http::req_header_parser_error_code::bad_request_method);
+	EXPECT_EQ(parse("GET  HTTP/1.1\r\n\r\n"), west::http::req_header_parser_error_code::bad_request_target);
+	EXPECT_EQ(parse("GET / HTTQ/1.1\r\n\r\n"), west::http::req_header_parser_error_code::wrong_protocol);
+	EXPECT_EQ(parse("GET / HTTP/a.1\r\n\r\n"), west::http::req_header_parser_error_code::bad_protocol_version);
+	EXPECT_EQ(parse("GET / HTTP/1.b\r\n\r\n"), west::http::req_header_parser_error_code::bad_protocol_version);
+	EXPECT_EQ(parse("GET / HTTP/1.1\r\nFoo: bar\rx\r\n\r\n"), west::http::req_header_parser_error_code::expected_linefeed);
+	EXPECT_EQ(parse("GET / HTTP/1.1\r\nFoo bar\r\n\r\n"), west::http::req_header_parser_error_code::bad_field_name);
+	EXPECT_EQ(parse("GET / HTTP/1.1\r\nF(o: bar\r\n\r\n"), west::http::req_header_parser_error_code::bad_field_name);
+	EXPECT_EQ(parse("GET / HTTP/1.1\r\n bar\r\n\r\n"), west::http::req_header_parser_error_code::bad_field_name);
+	EXPECT_EQ(parse("GET / HTTP/1.1\r\nFoo: b\x01r\r\n\r\n"), west::http::req_header_parser_error_code::bad_field_value);
+	EXPECT_EQ(parse("GET / HTTP/1.1\r\n"), west::http::req_header_parser_error_code::more_data_needed);
+}
+
+TESTCASE(west_http_request_header_view_parser_does_not_allocate)
+{
+	std::string const input{browser_header};
+
+	auto const alloc_start = allocation_count;
+	size_t field_count = 0;
+	for(size_t k = 0; k != 100; ++k)
+	{
+		west::http::request_header_view_parser parser{};
+		auto const res = parser.parse(input);
+		EXPECT_EQ(res.ec, west::http::req_header_parser_error_code::completed);
+		field_count += std::size(parser.result().fields);
+	}
+	EXPECT_EQ(allocation_count - alloc_start, 0);
+	EXPECT_EQ(field_count, 12*100);
+}
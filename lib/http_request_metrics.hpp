@@ -0,0 +1,104 @@
+#ifndef WEST_HTTP_REQUEST_METRICS_HPP
+#define WEST_HTTP_REQUEST_METRICS_HPP
+
+#include "./http_instrumentation.hpp"
+#include "./latency_histogram.hpp"
+#include "./per_loop_shared.hpp"
+
+#include <array>
+#include <chrono>
+#include <memory>
+
+namespace west::http
+{
+	// NOTE: Byte and call counts do not need the precision of a latency measurement
+	using count_histogram = basic_latency_histogram<6>;
+
+	struct request_state_metrics
+	{
+		// Time from entering the state to leaving it, in nanoseconds. This includes time spent
+		// waiting for the socket.
+		latency_histogram duration_ns;
+
+		// Bytes read and written while in the state
+		count_histogram bytes;
+
+		// Socket calls made while in the state
+		count_histogram socket_calls;
+
+		void reset()
+		{
+			duration_ns.reset();
+			bytes.reset();
+			socket_calls.reset();
+		}
+	};
+
+	// NOTE: Not thread-safe. Use one instance per event loop, and only read it from that loop.
+	struct request_metrics
+	{
+		// Indexed like request_state_holder. See request_state_names.
+		std::array<request_state_metrics, request_state_count> states;
+
+		// Time from the start of a request until its response has been written, in nanoseconds
+		latency_histogram request_duration_ns;
+
+		void reset()
+		{
+			for(auto& item : states)
+			{ item.reset(); }
+			request_duration_ns.reset();
+		}
+	};
+
+	class request_metrics_recorder
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		static constexpr bool enabled = true;
+
+		explicit request_metrics_recorder(std::shared_ptr<request_metrics> metrics):
+			m_metrics{std::move(metrics)},
+			m_state_start{clock::now()},
+			m_request_start{m_state_start}
+		{}
+
+		void state_completed(size_t state_index, io::io_counters const& io)
+		{
+			auto const now = clock::now();
+			auto& item = m_metrics->states[state_index];
+			item.duration_ns.record(to_ns(now - m_state_start));
+			item.bytes.record(io.bytes());
+			item.socket_calls.record(io.calls());
+			m_state_start = now;
+		}
+
+		void request_started()
+		{ m_request_start = m_state_start; }
+
+		void request_completed()
+		{ m_metrics->request_duration_ns.record(to_ns(clock::now() - m_request_start)); }
+
+	private:
+		static uint64_t to_ns(clock::duration d)
+		{ return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()); }
+
+		std::shared_ptr<request_metrics> m_metrics;
+		clock::time_point m_state_start;
+		clock::time_point m_request_start;
+	};
+
+	// NOTE: An instrumentation policy for session_factory, that records into request_metrics. A
+	//       copy records into new, empty metrics. See per_loop_shared.
+	class request_metrics_handle:public per_loop_shared<request_metrics>
+	{
+	public:
+		using per_loop_shared::per_loop_shared;
+
+		request_metrics_recorder create_recorder() const
+		{ return request_metrics_recorder{get()}; }
+	};
+}
+
+#endif
@@ -0,0 +1,80 @@
+//@	{"target":{"name":"http_request_metrics.test"}}
+
+#include "./http_request_metrics.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <thread>
+
+static_assert(west::http::request_recorder<west::http::request_metrics_recorder>);
+static_assert(west::http::request_recorder<west::http::no_instrumentation>);
+
+TESTCASE(west_http_request_metrics_state_names)
+{
+	using namespace west::http;
+	EXPECT_EQ(std::size(request_state_names), request_state_count);
+	EXPECT_EQ(std::string_view{request_state_names[request_state_index<read_request_header>]},
+		"read_request_header");
+	EXPECT_EQ(std::string_view{request_state_names[request_state_index<write_response_body>]},
+		"write_response_body");
+}
+
+TESTCASE(west_http_request_metrics_recorder)
+{
+	auto const metrics = std::make_shared<west::http::request_metrics>();
+	west::http::request_metrics_handle handle{metrics};
+	auto recorder = handle.create_recorder();
+
+	constexpr auto header_index = west::http::request_state_index<west::http::read_request_header>;
+	constexpr auto body_index = west::http::request_state_index<west::http::write_response_body>;
+
+	std::this_thread::sleep_for(std::chrono::milliseconds{2});
+	recorder.state_completed(header_index, west::io::io_counters{
+		.read_calls = 2,
+		.write_calls = 0,
+		.bytes_read = 300,
+		.bytes_written = 0
+	});
+	recorder.state_completed(body_index, west::io::io_counters{
+		.read_calls = 0,
+		.write_calls = 1,
+		.bytes_read = 0,
+		.bytes_written = 40
+	});
+	recorder.request_completed();
+
+	auto const& header = metrics->states[header_index];
+	EXPECT_EQ(header.duration_ns.count(), 1);
+	EXPECT_GE(header.duration_ns.min(), 2000000);
+	EXPECT_EQ(header.bytes.max(), 300);
+	EXPECT_EQ(header.socket_calls.max(), 2);
+
+	auto const& body = metrics->states[body_index];
+	EXPECT_EQ(body.duration_ns.count(), 1);
+	EXPECT_EQ(body.bytes.max(), 40);
+	EXPECT_EQ(body.socket_calls.max(), 1);
+
+	// The first request started when the recorder was created
+	EXPECT_EQ(metrics->request_duration_ns.count(), 1);
+	EXPECT_GE(metrics->request_duration_ns.min(), header.duration_ns.min());
+
+	metrics->reset();
+	EXPECT_EQ(metrics->request_duration_ns.count(), 0);
+	EXPECT_EQ(metrics->states[header_index].duration_ns.count(), 0);
+}
+
+TESTCASE(west_http_request_metrics_handle_copy_gets_new_metrics)
+{
+	west::http::request_metrics_handle a{};
+	auto b = a;
+	EXPECT_NE(a.get(), b.get());
+
+	auto const metrics = a.get();
+	auto c = std::move(a);
+	EXPECT_EQ(c.get(), metrics);
+
+	auto recorder = b.create_recorder();
+	recorder.request_completed();
+	EXPECT_EQ(b->request_duration_ns.count(), 1);
+	EXPECT_EQ(c->request_duration_ns.count(), 0);
+}
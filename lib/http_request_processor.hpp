@@ -2,11 +2,34 @@
 #define WEST_HTTP_REQUEST_PROCESSOR_HPP
 
 #include "./http_request_state_transitions.hpp"
+#include "./http_timeout_policy.hpp"
+#include "./http_instrumentation.hpp"
 #include "./io_adapter.hpp"
+#include "./buffer_pool.hpp"
+
+#include <optional>
+#include <utility>
 
 namespace west::http
 {
-	enum class request_processor_status{completed, more_data_needed, application_error, io_error};
+	using session_buffer = std::array<char, 65536>;
+	using session_buffer_pool = buffer_pool<session_buffer>;
+
+	// NOTE: `yielded` means that the processor stopped although it could continue, to let other
+	//       sessions run. It is reported with session_state_io_direction::output, since the socket
+	//       is normally writable, so the processor is called again on the next event.
+	//
+	//       `waiting_for_request_handler` means that the request handler has no response data yet.
+	//       The session should stop listening on the socket, and continues when the timeout from
+	//       timeout_update() expires.
+	enum class request_processor_status{
+		completed,
+		more_data_needed,
+		yielded,
+		waiting_for_request_handler,
+		application_error,
+		io_error
+	};
 
 	struct process_request_result
 	{
@@ -27,31 +50,208 @@ namespace west::http
 	constexpr bool is_session_terminated(process_request_result res)
 	{ return is_session_terminated(res.status); }
 
-	template<io::socket Socket, request_handler RequestHandler>
-	class request_processor
+	constexpr bool is_session_yielding(process_request_result res)
+	{ return res.status == request_processor_status::yielded; }
+
+	struct request_processor_limits
 	{
-		using buffer_type = std::array<char, 65536>;
+		// Maximum number of requests to complete per call to socket_is_ready. Pipelined requests
+		// beyond this limit are processed on the next event, so one client cannot starve others.
+		size_t max_requests_per_event{16};
 
+		// Maximum number of requests on one connection. The connection is closed after the
+		// response to the last request.
+		size_t max_requests_per_connection{1000};
+
+		// Maximum size of a request body, unless the request handler sets a limit for the request
+		// through max_request_body_size(). Larger requests are rejected with status 413.
+		size_t max_request_body_size{64*1024*1024};
+	};
+
+	// NOTE: The receive and send buffers are borrowed from a buffer_pool when needed, and returned
+	//       when the session has to wait for the socket, and there is no data left in the buffer.
+	//       Thus, a connection waiting for the next request does not hold any buffers.
+	//
+	//       If the recorder is enabled, the socket is wrapped in a counting_socket, so the recorder
+	//       can be told how much I/O each state did.
+	template<io::socket Socket, request_handler RequestHandler, request_recorder Recorder = no_instrumentation>
+	class request_processor
+	{
 	public:
-		explicit request_processor(Socket&& connection, RequestHandler&& req_handler = RequestHandler{}):
-			m_session{std::move(connection), std::move(req_handler), request_info{}, response_header{}},
-			m_recv_buffer{std::make_unique<buffer_type>()},
-			m_send_buffer{std::make_unique<buffer_type>()},
-			m_buff_spans{buffer_span{*m_recv_buffer}, buffer_span{*m_send_buffer}}
-		{}
+		using session_socket = instrumented_socket_t<Socket, Recorder>;
+
+		explicit request_processor(Socket&& connection,
+			RequestHandler&& req_handler = RequestHandler{},
+			timeout_policy const& timeouts = timeout_policy{},
+			std::shared_ptr<session_buffer_pool> buffers = std::make_shared<session_buffer_pool>(),
+			request_processor_limits const& limits = request_processor_limits{},
+			Recorder&& recorder = Recorder{}):
+			m_session{session_socket{std::move(connection)}, std::move(req_handler), request_info{}, response_header{}},
+			m_timeouts{timeouts},
+			m_limits{limits},
+			m_buffer_pool{std::move(buffers)},
+			m_recorder{std::move(recorder)}
+		{ update_timeout(); }
 
 		[[nodiscard]] auto socket_is_ready()
+		{
+			if(std::exchange(m_waiting_for_request_handler, false))
+			{ update_timeout(); }
+
+			m_requests_this_event = 0;
+			auto const ret = process_socket();
+			release_idle_buffers();
+			return ret;
+		}
+
+		[[nodiscard]] auto socket_is_idle()
+		{
+			// NOTE: The request handler has had some time to produce more data, so try again
+			if(std::exchange(m_waiting_for_request_handler, false))
+			{
+				update_timeout();
+				return process_request_result{
+					request_processor_status::more_data_needed,
+					m_state.second
+				};
+			}
+
+			// NOTE: There is no request in progress, so the connection can be closed without a response
+			if(std::holds_alternative<wait_for_data>(m_state.first) && !m_buffers[0].has_value())
+			{
+				return process_request_result{
+					request_processor_status::completed,
+					m_state.second
+				};
+			}
+
+			auto const res = std::visit([]<class T>(T const&) {
+				return select_io_direction<T>::value;
+			}, m_state.first);
+
+			switch(res)
+			{
+				case session_state_io_direction::input:
+				{
+					auto constexpr http_status = status::request_timeout;
+					start_error_response(finalize_state_result{
+						.http_status = http_status,
+						.error_message = make_unique_cstr(to_string(http_status))
+					});
+
+					return process_request_result{
+						request_processor_status::more_data_needed,
+						m_state.second
+					};
+				}
+
+				case session_state_io_direction::output:
+					return process_request_result {
+						request_processor_status::completed,
+						m_state.second
+					};
+
+				default:
+					__builtin_unreachable();
+			}
+		}
+
+		// Returns the timeout for the current state, if it has changed since the last call
+		[[nodiscard]] std::optional<io::fd_timeout> timeout_update()
+		{ return std::exchange(m_timeout_update, std::nullopt); }
+
+		auto& session()
+		{ return m_session; }
+
+		auto const& session() const
+		{ return m_session; }
+
+		[[nodiscard]] auto const& buffer_pool() const
+		{ return *m_buffer_pool; }
+
+		[[nodiscard]] bool holds_buffer(session_state_io_direction dir) const
+		{ return m_buffers[dir == session_state_io_direction::input? 0 : 1].has_value(); }
+
+		[[nodiscard]] auto const& recorder() const
+		{ return m_recorder; }
+
+	private:
+		using buffer_span = io_adapter::buffer_span<session_buffer::value_type, std::tuple_size_v<session_buffer>>;
+
+		struct borrowed_buffer
+		{
+			explicit borrowed_buffer(session_buffer_pool::buffer_ptr&& buff):
+				buffer{std::move(buff)},
+				span{*buffer}
+			{}
+
+			session_buffer_pool::buffer_ptr buffer;
+			buffer_span span;
+		};
+
+		buffer_span& get_buffer(size_t index)
+		{
+			auto& item = m_buffers[index];
+			if(!item.has_value())
+			{ item.emplace(m_buffer_pool->acquire()); }
+			return item->span;
+		}
+
+		void release_idle_buffers()
+		{
+			for(auto& item : m_buffers)
+			{
+				if(item.has_value() && std::size(item->span.span_to_read()) == 0)
+				{ item.reset(); }
+			}
+		}
+
+		[[nodiscard]] auto process_socket()
 		{
 			while(true)
 			{
 				auto res = std::visit([this]<class T>(T& state){
-					return state.socket_is_ready(std::get<select_buffer_index<T>::value>(m_buff_spans), m_session);
+					return state.socket_is_ready(get_buffer(select_buffer_index<T>::value), m_session);
 				}, m_state.first);
 
 				switch(res.status)
 				{
 					case session_state_status::completed:
+						if(std::holds_alternative<read_request_header>(m_state.first)
+							&& !accept_request_header())
+						{ break; }
+
+						if(std::holds_alternative<read_request_body>(m_state.first)
+							|| std::holds_alternative<read_request_chunked_body>(m_state.first))
+						{
+							remove_chunked_framing_for_http_1_0();
+							set_connection_field();
+						}
+
+						leave_state();
 						m_state = make_state_handler(m_state.first, m_session.request_info, m_session.response_info);
+						enter_state();
+						update_timeout();
+						if(!std::holds_alternative<wait_for_data>(m_state.first))
+						{ break; }
+
+						m_recorder.request_completed();
+
+						if(!m_session.request_info.keep_alive)
+						{
+							return process_request_result{
+								request_processor_status::completed,
+								m_state.second
+							};
+						}
+
+						if(++m_requests_this_event >= m_limits.max_requests_per_event)
+						{
+							return process_request_result{
+								request_processor_status::yielded,
+								session_state_io_direction::output
+							};
+						}
 						break;
 
 					case session_state_status::connection_closed:
@@ -66,24 +266,26 @@ namespace west::http
 							m_state.second
 						};
 
-					case session_state_status::client_error_detected:
-					{
-						m_session.connection.stop_reading();
-
-						m_session.response_info = response_info{};
-						auto const saved_http_status = res.state_result.http_status;
-						m_session.request_handler.finalize_state(m_session.response_info.header.fields,
-							std::move(res.state_result));
-						m_session.response_info.header.status_line.http_version = version{1, 1};
-						m_session.response_info.header.status_line.status_code = saved_http_status;
-						m_session.response_info.header.status_line.reason_phrase = to_string(saved_http_status);
-
-						m_state = std::pair{
-							write_response_header{m_session.response_info.header},
-							session_state_io_direction::output
+					case session_state_status::request_handler_would_block:
+						m_waiting_for_request_handler = true;
+						m_timeout_update = io::fd_timeout{
+							m_timeouts.request_handler_poll_interval,
+							io::timeout_mode::fixed_deadline
+						};
+						return process_request_result{
+							request_processor_status::waiting_for_request_handler,
+							m_state.second
 						};
+
+					case session_state_status::client_error_detected:
+						if constexpr(Recorder::enabled)
+						{
+							if(auto const state = std::get_if<read_request_header>(&m_state.first);
+								state != nullptr && state->parser_status() != req_header_parser_error_code::completed)
+							{ notify_header_rejected(m_recorder, state->parser_status()); }
+						}
+						start_error_response(std::move(res.state_result));
 						break;
-					}
 
 					case session_state_status::write_response_failed:
 						return process_request_result{
@@ -100,65 +302,118 @@ namespace west::http
 			}
 		}
 
-		[[nodiscard]] auto socket_is_idle()
+		// Applies the limits of the service to a request whose header has been read. Returns false if
+		// the request has been rejected.
+		bool accept_request_header()
 		{
-			auto const res = std::visit([]<class T>(T const&) {
-				return select_io_direction<T>::value;
-			}, m_state.first);
+			auto& request = m_session.request_info;
+			if(++m_requests_on_connection >= m_limits.max_requests_per_connection)
+			{ request.keep_alive = false; }
 
-			switch(res)
+			// NOTE: A body with a known size is rejected before any of it is read. The size of a
+			//       chunked body is checked by read_request_chunked_body.
+			request.max_body_size = get_max_request_body_size(m_session.request_handler)
+				.value_or(m_limits.max_request_body_size);
+			if(!request.body_is_chunked && request.content_length > request.max_body_size)
 			{
-				case session_state_io_direction::input:
-				{
-					m_session.connection.stop_reading();
+				start_error_response(finalize_state_result{
+					.http_status = status::request_entity_too_large,
+					.error_message = make_unique_cstr("Request body too large")
+				});
+				return false;
+			}
 
-					m_session.response_info = response_info{};
-					auto constexpr http_status = status::request_timeout;
-					m_session.request_handler.finalize_state(m_session.response_info.header.fields,
-						finalize_state_result{
-							.http_status = http_status,
-							.error_message = make_unique_cstr(to_string(http_status))
-						});
-					m_session.response_info.header.status_line.http_version = version{1, 1};
-					m_session.response_info.header.status_line.status_code = http_status;
-					m_session.response_info.header.status_line.reason_phrase = to_string(http_status);
-
-					m_state = std::pair{
-						write_response_header{m_session.response_info.header},
-						session_state_io_direction::output
-					};
+			return true;
+		}
 
-					return process_request_result{
-						request_processor_status::more_data_needed,
-						m_state.second
-					};
-				}
+		// Stops reading from the client, and starts writing an error response. The connection is
+		// closed after the response.
+		void start_error_response(finalize_state_result&& result)
+		{
+			leave_state();
+			m_session.connection.stop_reading();
 
-				case session_state_io_direction::output:
-					return process_request_result {
-						request_processor_status::completed,
-						m_state.second
-					};
+			m_session.response_info = response_info{};
+			auto const saved_http_status = result.http_status;
+			m_session.request_handler.finalize_state(m_session.response_info.header.fields,
+				std::move(result));
+			m_session.request_info.keep_alive = false;
+			remove_chunked_framing_for_http_1_0();
+			set_connection_field();
+			m_session.response_info.header.status_line.http_version = version{1, 1};
+			m_session.response_info.header.status_line.status_code = saved_http_status;
+			m_session.response_info.header.status_line.reason_phrase = to_string(saved_http_status);
 
-				default:
-					__builtin_unreachable();
-			}
+			m_state = std::pair{
+				write_response_header{m_session.response_info.header},
+				session_state_io_direction::output
+			};
+			enter_state();
+			update_timeout();
 		}
 
-		auto& session()
-		{ return m_session; }
+		// NOTE: An HTTP/1.0 client does not understand chunked transfer-encoding. The body is then
+		//       sent as is, and the connection is closed after it.
+		void remove_chunked_framing_for_http_1_0()
+		{
+			auto& request = m_session.request_info;
+			auto& response = m_session.response_info;
+			if(request.header.request_line.http_version != version{1, 0}
+				|| !is_chunked(response.header.fields))
+			{ return; }
 
-		auto const& session() const
-		{ return m_session; }
+			response.header.fields.erase(known_field::transfer_encoding);
+			response.body_ends_at_close = true;
+			request.keep_alive = false;
+		}
 
-	private:
-		struct session<Socket, RequestHandler> m_session;
-		std::pair<request_state_holder, session_state_io_direction> m_state;
-		std::unique_ptr<buffer_type> m_recv_buffer;
-		std::unique_ptr<buffer_type> m_send_buffer;
+		// NOTE: The request handler may close the connection by setting "Connection: close"
+		void set_connection_field()
+		{
+			auto& fields = m_session.response_info.header.fields;
+			auto& request = m_session.request_info;
+			if(has_connection_option(fields, "close"))
+			{ request.keep_alive = false; }
+			else if(!request.keep_alive)
+			{ fields.append("Connection", "close"); }
+			else if(request.header.request_line.http_version == version{1, 0}
+				&& !fields.contains(known_field::connection))
+			{ fields.append("Connection", "keep-alive"); }
+		}
+
+		void update_timeout()
+		{ m_timeout_update = select_timeout_for(m_state.first, m_timeouts, m_session.request_info); }
+
+		void leave_state()
+		{
+			if constexpr(Recorder::enabled)
+			{
+				auto const io = m_session.connection.counters();
+				m_recorder.state_completed(m_state.first.index(), io - m_io_at_state_start);
+				m_io_at_state_start = io;
+				if(std::holds_alternative<wait_for_data>(m_state.first))
+				{ m_recorder.request_started(); }
+			}
+		}
 
-		using buffer_span = io_adapter::buffer_span<buffer_type::value_type, std::tuple_size_v<buffer_type>>;
-		std::array<buffer_span, 2> m_buff_spans;
+		void enter_state()
+		{
+			if constexpr(Recorder::enabled)
+			{ notify_state_entered(m_recorder, m_state.first.index()); }
+		}
+
+		struct session<session_socket, RequestHandler> m_session;
+		timeout_policy m_timeouts;
+		request_processor_limits m_limits;
+		size_t m_requests_this_event{0};
+		size_t m_requests_on_connection{0};
+		bool m_waiting_for_request_handler{false};
+		std::optional<io::fd_timeout> m_timeout_update;
+		std::pair<request_state_holder, session_state_io_direction> m_state;
+		std::shared_ptr<session_buffer_pool> m_buffer_pool;
+		std::array<std::optional<borrowed_buffer>, 2> m_buffers;
+		[[no_unique_address]] Recorder m_recorder;
+		[[no_unique_address]] std::conditional_t<Recorder::enabled, io::io_counters, std::monostate> m_io_at_state_start{};
 	};
 }
 #endif
@@ -1,6 +1,7 @@
 //@	{"target":{"name":"http_request_processor.test"}}
 
 #include "./http_request_processor.hpp"
+#include "./http_session_counters.hpp"
 
 #include <testfwk/testfwk.hpp>
 #include <random>
@@ -33,7 +34,7 @@ namespace
 				{
 					++m_calls_to_read;
 					auto const bytes_left = static_cast<size_t>(std::end(m_request) - m_request_offset);
-					auto const bytes_to_read = std::min(std::min(std::size(buffer), bytes_left), static_cast<size_t>(23));
+					auto const bytes_to_read = std::min(std::min(std::size(buffer), bytes_left), m_max_read_size);
 					std::copy_n(m_request_offset, bytes_to_read, std::begin(buffer));
 					m_request_offset += bytes_to_read;
 					return west::io::read_result{
@@ -126,6 +127,12 @@ namespace
 			m_write_blocks_every = n;
 		}
 
+		void max_read_size(size_t n)
+		{ m_max_read_size = n; }
+
+		size_t calls_to_read() const
+		{ return m_calls_to_read; }
+
 	private:
 		uint32_t m_endpoint_status{0};
 		static constexpr uint32_t CLIENT_READ_CLOSED{1};
@@ -139,6 +146,7 @@ namespace
 		std::string_view::iterator m_request_offset;
 		std::string m_output;
 
+		size_t m_max_read_size{23};
 		size_t m_read_blocks_every{65536};
 		size_t m_calls_to_read{0};
 		size_t m_write_blocks_every{65536};
@@ -241,6 +249,12 @@ namespace
 			}
 
 			m_fail_writing_response = header.fields.contains("Fail-Writing-Response");
+			m_chunked_response = header.fields.contains("Chunked-Response");
+
+			if(auto const i = header.fields.find("Max-Body-Size"); i != std::end(header.fields))
+			{ m_max_body_size = west::to_number<size_t>(i->second); }
+			else
+			{ m_max_body_size.reset(); }
 
 			return validation_result;
 		}
@@ -249,7 +263,10 @@ namespace
 		{
 			puts("Finalize read body");
 			west::http::finalize_state_result validation_result;
-			fields.append("Content-Length", std::to_string(std::size(m_response_body)));
+			if(m_chunked_response)
+			{ fields.append("Transfer-Encoding", "chunked"); }
+			else
+			{ fields.append("Content-Length", std::to_string(std::size(m_response_body))); }
 			if(m_rej_req)
 			{
 				validation_result.http_status = west::http::status::unprocessable_content;
@@ -295,6 +312,9 @@ namespace
 
 		auto& request() const { return m_request; }
 
+		std::optional<size_t> max_request_body_size() const
+		{ return m_max_body_size; }
+
 	private:
 		std::unique_ptr<char[]> m_error_message;
 		std::string_view m_response_body;
@@ -302,9 +322,40 @@ namespace
 		std::string m_request;
 		bool m_rej_req{false};
 		bool m_fail_writing_response{false};
+		bool m_chunked_response{false};
+		std::optional<size_t> m_max_body_size;
+	};
+
+	struct recorded_event
+	{
+		std::string_view name;
+		size_t state_index;
+		west::io::io_counters io;
+
+		bool operator==(recorded_event const&) const = default;
+	};
+
+	struct recorder
+	{
+		static constexpr bool enabled = true;
+
+		void state_completed(size_t state_index, west::io::io_counters const& io)
+		{ events->push_back(recorded_event{"state_completed", state_index, io}); }
+
+		void request_started()
+		{ events->push_back(recorded_event{"request_started", 0, west::io::io_counters{}}); }
+
+		void request_completed()
+		{ events->push_back(recorded_event{"request_completed", 0, west::io::io_counters{}}); }
+
+		std::shared_ptr<std::vector<recorded_event>> events;
 	};
 }
 
+static_assert(std::is_same_v<west::http::request_processor<socket, request_handler>::session_socket, socket>);
+static_assert(std::is_same_v<west::http::request_processor<socket, request_handler, recorder>::session_socket,
+	west::io::counting_socket<socket>>);
+
 TESTCASE(west_http_request_processor_process_socket_initial_io_error)
 {
 	std::string_view request{"GET / HTTP/1.1\r\n"
@@ -335,6 +386,7 @@ TESTCASE(west_http_request_processor_process_socket_connection_closed_early_writ
 	}));
 	EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 400 Bad request\r\n"
 	"Content-Length: 16\r\n"
+"Connection: close\r\n"
 "\r\n"
 "Header truncated");
 }
@@ -354,6 +406,7 @@ TESTCASE(west_http_request_processor_process_socket_connection_closed_early_writ
 	}));
 	EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 400 Bad request\r\n"
 	"Content-Length: 16\r\n"
+"Connection: close\r\n"
 "\r\n"
 "Header truncated");
 }
@@ -395,6 +448,7 @@ TESTCASE(west_http_request_processor_process_socket_connection_closed_while_read
 		EXPECT_EQ(proc.session().request_handler.request().empty(), true);
 		EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 400 Bad request\r\n"
 "Content-Length: 16\r\n"
+"Connection: close\r\n"
 "\r\n"
 "Header truncated");
 	}
@@ -446,6 +500,7 @@ TESTCASE(west_http_request_processor_process_socket_connection_closed_while_read
 			"Sed malesuada luctus velit nec consequat. Mauris congue aliquet tellus, tempus aliquam elit sollicit");
 		EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 400 Bad request\r\n"
 "Content-Length: 40\r\n"
+"Connection: close\r\n"
 "\r\n"
 "Client claims there is more data to read");
 	}
@@ -471,9 +526,10 @@ TESTCASE(west_http_request_processor_process_socket_bad_header_rej_by_fwk)
 			EXPECT_EQ(proc.session().connection.server_read_closed(), true);
 			EXPECT_EQ(proc.session().connection.output(),
 "HTTP/1.1 505 Http version not supported\r\n"
-"Content-Length: 46\r\n"
+"Content-Length: 54\r\n"
+"Connection: close\r\n"
 "\r\n"
-"This web server only supports HTTP version 1.1");
+"This web server only supports HTTP version 1.0 and 1.1");
 			break;
 		}
 		else
@@ -503,6 +559,7 @@ TESTCASE(west_http_request_processor_process_socket_bad_header_content_length_no
 			EXPECT_EQ(proc.session().connection.output(),
 "HTTP/1.1 400 Bad request\r\n"
 "Content-Length: 18\r\n"
+"Connection: close\r\n"
 "\r\n"
 "Bad content-length");
 			break;
@@ -533,6 +590,7 @@ TESTCASE(west_http_request_processor_process_socket_bad_header_rej_by_app_1)
 			EXPECT_EQ(proc.session().connection.output(),
 "HTTP/1.1 418 I am a teapot\r\n"
 "Content-Length: 69\r\n"
+"Connection: close\r\n"
 "\r\n"
 "Application requested request to be reject when validating the header");
 			EXPECT_EQ(proc.session().connection.server_read_closed(), true);
@@ -564,6 +622,7 @@ TESTCASE(west_http_request_processor_process_socket_bad_header_rej_by_app_2)
 			EXPECT_EQ(proc.session().connection.output(),
 "HTTP/1.1 422 Unprocessable content\r\n"
 "Content-Length: 70\r\n"
+"Connection: close\r\n"
 "\r\n"
 "Application requested request to be reject when the body was processed");
 			EXPECT_EQ(proc.session().connection.server_read_closed(), true);
@@ -646,4 +705,503 @@ TESTCASE(west_http_request_processor_process_socket_valid_request_with_response)
 		else
 		{ EXPECT_EQ(proc.session().connection.server_read_closed(), false); }
 	}
-}
\ No newline at end of file
+}
+TESTCASE(west_http_request_processor_timeout_update_and_idle)
+{
+	west::http::timeout_policy policy{};
+	policy.read_request_header = std::chrono::milliseconds{50};
+	policy.write_response = std::chrono::milliseconds{60};
+
+	west::http::request_processor proc{socket{}, request_handler{""}, policy};
+	EXPECT_EQ(proc.timeout_update(), (west::io::fd_timeout{
+		std::chrono::milliseconds{50},
+		west::io::timeout_mode::fixed_deadline
+	}));
+	EXPECT_EQ(proc.timeout_update().has_value(), false);
+
+	proc.session().connection.request("GET / HTTP/1.1\r\n");
+	proc.session().connection.read_blocks(2);
+	auto const res = proc.socket_is_ready();
+	EXPECT_EQ(res.status, west::http::request_processor_status::more_data_needed);
+	EXPECT_EQ(proc.timeout_update().has_value(), false);
+
+	// The client did not send the header in time
+	auto const idle_res = proc.socket_is_idle();
+	EXPECT_EQ(idle_res, (west::http::process_request_result{
+		.status = west::http::request_processor_status::more_data_needed,
+		.io_dir = west::http::session_state_io_direction::output
+	}));
+	EXPECT_EQ(proc.timeout_update(), (west::io::fd_timeout{
+		std::chrono::milliseconds{60},
+		west::io::timeout_mode::restart_on_activity
+	}));
+}
+
+TESTCASE(west_http_request_processor_buffers_are_borrowed_while_needed)
+{
+	std::string_view request{"GET / HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"\r\n"};
+
+	auto pool = std::make_shared<west::http::session_buffer_pool>();
+	{
+		west::http::request_processor proc{socket{}, request_handler{"Hello, World"}, west::http::timeout_policy{}, pool};
+		EXPECT_EQ(pool->stats().buffers_in_use, 0);
+
+		proc.session().connection.request(request);
+		proc.session().connection.read_blocks(2);
+		proc.session().connection.write_blocks(3);
+
+		// First read blocks. No data has been received, so the buffer is returned.
+		auto res = proc.socket_is_ready();
+		EXPECT_EQ(res.status, west::http::request_processor_status::more_data_needed);
+		EXPECT_EQ(proc.holds_buffer(west::http::session_state_io_direction::input), false);
+		EXPECT_EQ(pool->stats().buffers_in_use, 0);
+
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{
+			res = proc.socket_is_ready();
+			EXPECT_LE(pool->stats().buffers_in_use, 2);
+		}
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(pool->stats().buffers_in_use, 0);
+	}
+
+	EXPECT_EQ(pool->stats().buffers_in_use, 0);
+	EXPECT_GT(pool->stats().hits, 0);
+	EXPECT_LE(pool->stats().misses, 2);
+}
+
+TESTCASE(west_http_request_processor_pipelined_requests_in_one_buffer)
+{
+	std::string request;
+	for(size_t k = 0; k != 40; ++k)
+	{ request.append("GET / HTTP/1.1\r\nHost: localhost:8000\r\n\r\n"); }
+
+	west::http::request_processor proc{socket{},
+		request_handler{""},
+		west::http::timeout_policy{},
+		std::make_shared<west::http::session_buffer_pool>(),
+		west::http::request_processor_limits{.max_requests_per_event = 16}
+	};
+	proc.session().connection.request(request);
+	proc.session().connection.max_read_size(65536);
+
+	std::string_view const response{"HTTP/1.1 200 Ok\r\nContent-Length: 0\r\n\r\n"};
+
+	// First read blocks
+	auto res = proc.socket_is_ready();
+	EXPECT_EQ(res.status, west::http::request_processor_status::more_data_needed);
+
+	// All requests are received by the second read. The processor yields after 16 responses.
+	res = proc.socket_is_ready();
+	EXPECT_EQ(res, (west::http::process_request_result{
+		.status = west::http::request_processor_status::yielded,
+		.io_dir = west::http::session_state_io_direction::output
+	}));
+	EXPECT_EQ(std::size(proc.session().connection.output()), 16*std::size(response));
+	EXPECT_EQ(proc.holds_buffer(west::http::session_state_io_direction::input), true);
+
+	res = proc.socket_is_ready();
+	EXPECT_EQ(res.status, west::http::request_processor_status::yielded);
+	EXPECT_EQ(std::size(proc.session().connection.output()), 32*std::size(response));
+	EXPECT_EQ(proc.session().connection.calls_to_read(), 2);
+
+	// The last 8 requests are processed, and the client then closes the connection
+	res = proc.socket_is_ready();
+	EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+	EXPECT_EQ(proc.session().connection.calls_to_read(), 3);
+
+	std::string expected_output;
+	for(size_t k = 0; k != 40; ++k)
+	{ expected_output.append(response); }
+	EXPECT_EQ(proc.session().connection.output(), expected_output);
+}
+
+TESTCASE(west_http_request_processor_connection_close)
+{
+	std::string_view request{"GET / HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"Connection: close\r\n"
+"\r\n"
+"GET / HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"\r\n"};
+
+	west::http::request_processor proc{socket{}, request_handler{"Hello"}};
+	proc.session().connection.request(request);
+	proc.session().connection.read_blocks(2);
+
+	auto res = proc.socket_is_ready();
+	while(res.status == west::http::request_processor_status::more_data_needed)
+	{ res = proc.socket_is_ready(); }
+
+	// The second request is not processed
+	EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+	EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 200 Ok\r\n"
+"Content-Length: 5\r\n"
+"Connection: close\r\n"
+"\r\n"
+"Hello");
+}
+
+TESTCASE(west_http_request_processor_http_1_0)
+{
+	{
+		west::http::request_processor proc{socket{}, request_handler{""}};
+		proc.session().connection.request("GET / HTTP/1.0\r\n\r\nGET / HTTP/1.0\r\n\r\n");
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 200 Ok\r\n"
+"Content-Length: 0\r\n"
+"Connection: close\r\n"
+"\r\n");
+	}
+
+	{
+		west::http::request_processor proc{socket{}, request_handler{""}};
+		proc.session().connection.request("GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n"
+			"GET / HTTP/1.0\r\n\r\n");
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 200 Ok\r\n"
+"Content-Length: 0\r\n"
+"Connection: keep-alive\r\n"
+"\r\n"
+"HTTP/1.1 200 Ok\r\n"
+"Content-Length: 0\r\n"
+"Connection: close\r\n"
+"\r\n");
+	}
+}
+
+TESTCASE(west_http_request_processor_http_1_0_chunked)
+{
+	{
+		west::http::request_processor proc{socket{}, request_handler{"Hello"}};
+		proc.session().connection.request("GET / HTTP/1.1\r\nHost: localhost:8000\r\nChunked-Response: yes\r\n\r\n");
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_NE(proc.session().connection.output().find("Transfer-Encoding: chunked\r\n"), std::string::npos);
+	}
+
+	// The response body is not chunked, and the connection is closed after it, even if the client
+	// asked to keep it open
+	{
+		west::http::request_processor proc{socket{}, request_handler{"Hello"}};
+		proc.session().connection.request("GET / HTTP/1.0\r\nConnection: keep-alive\r\nChunked-Response: yes\r\n\r\n"
+			"GET / HTTP/1.0\r\n\r\n");
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 200 Ok\r\n"
+"Connection: close\r\n"
+"\r\n"
+"Hello");
+	}
+
+	// A chunked request body is rejected
+	{
+		west::http::request_processor proc{socket{}, request_handler{""}};
+		proc.session().connection.request("POST / HTTP/1.0\r\nTransfer-Encoding: chunked\r\n\r\n"
+			"5\r\nHello\r\n0\r\n\r\n");
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(proc.session().connection.output().starts_with("HTTP/1.1 400 Bad request\r\n"), true);
+		EXPECT_EQ(proc.session().request_handler.request(), "");
+	}
+}
+
+TESTCASE(west_http_request_processor_max_requests_per_connection)
+{
+	std::string request;
+	for(size_t k = 0; k != 5; ++k)
+	{ request.append("GET / HTTP/1.1\r\nHost: localhost:8000\r\n\r\n"); }
+
+	west::http::request_processor proc{socket{},
+		request_handler{""},
+		west::http::timeout_policy{},
+		std::make_shared<west::http::session_buffer_pool>(),
+		west::http::request_processor_limits{.max_requests_per_connection = 3}
+	};
+	proc.session().connection.request(request);
+	proc.session().connection.read_blocks(2);
+
+	auto res = proc.socket_is_ready();
+	while(res.status == west::http::request_processor_status::more_data_needed)
+	{ res = proc.socket_is_ready(); }
+
+	EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+	EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 200 Ok\r\n"
+"Content-Length: 0\r\n"
+"\r\n"
+"HTTP/1.1 200 Ok\r\n"
+"Content-Length: 0\r\n"
+"\r\n"
+"HTTP/1.1 200 Ok\r\n"
+"Content-Length: 0\r\n"
+"Connection: close\r\n"
+"\r\n");
+}
+
+TESTCASE(west_http_request_processor_request_body_too_large)
+{
+	struct testcase
+	{
+		std::string_view request;
+		bool accepted;
+	};
+
+	std::array<testcase, 4> const testcases{
+		testcase{"POST / HTTP/1.1\r\nContent-Length: 16\r\n\r\nxxxxxxxxxxxxxxxx", true},
+		testcase{"POST / HTTP/1.1\r\nContent-Length: 17\r\n\r\nxxxxxxxxxxxxxxxxx", false},
+
+		// The request handler may use a different limit for some requests
+		testcase{"POST / HTTP/1.1\r\nContent-Length: 17\r\nMax-Body-Size: 32\r\n\r\nxxxxxxxxxxxxxxxxx", true},
+		testcase{"POST / HTTP/1.1\r\nContent-Length: 9\r\nMax-Body-Size: 8\r\n\r\nxxxxxxxxx", false}
+	};
+
+	for(auto const& item : testcases)
+	{
+		west::http::request_processor proc{socket{},
+			request_handler{""},
+			west::http::timeout_policy{},
+			std::make_shared<west::http::session_buffer_pool>(),
+			west::http::request_processor_limits{.max_request_body_size = 16}
+		};
+		proc.session().connection.request(item.request);
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		if(item.accepted)
+		{
+			EXPECT_EQ(proc.session().connection.output().starts_with("HTTP/1.1 200 Ok\r\n"), true);
+			EXPECT_NE(std::size(proc.session().request_handler.request()), 0);
+		}
+		else
+		{
+			EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 413 Request entity too large\r\n"
+"Content-Length: 22\r\n"
+"Connection: close\r\n"
+"\r\n"
+"Request body too large");
+
+			// No body bytes are passed to the request handler
+			EXPECT_EQ(proc.session().request_handler.request(), "");
+		}
+	}
+}
+
+TESTCASE(west_http_request_processor_expect_100_continue)
+{
+	{
+		west::http::request_processor proc{socket{}, request_handler{"Hello"}};
+		proc.session().connection.request("POST / HTTP/1.1\r\n"
+"Content-Length: 4\r\n"
+"Expect: 100-continue\r\n"
+"\r\n"
+"Body");
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(proc.session().request_handler.request(), "Body");
+		EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 100 Continue\r\n"
+"\r\n"
+"HTTP/1.1 200 Ok\r\n"
+"Content-Length: 5\r\n"
+"\r\n"
+"Hello");
+	}
+
+	{
+		// The request is rejected before the client sends the body
+		west::http::request_processor proc{socket{}, request_handler{"Hello"}};
+		proc.session().connection.request("POST / HTTP/1.1\r\n"
+"Content-Length: 4\r\n"
+"Expect: 100-continue\r\n"
+"Trigger-Rej-By-App: At header validation\r\n"
+"\r\n");
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(proc.session().connection.output().starts_with("HTTP/1.1 418 I am a teapot\r\n"), true);
+	}
+
+	{
+		west::http::request_processor proc{socket{}, request_handler{"Hello"}};
+		proc.session().connection.request("POST / HTTP/1.1\r\n"
+"Content-Length: 4\r\n"
+"Expect: something-else\r\n"
+"\r\n"
+"Body");
+		proc.session().connection.read_blocks(2);
+
+		auto res = proc.socket_is_ready();
+		while(res.status == west::http::request_processor_status::more_data_needed)
+		{ res = proc.socket_is_ready(); }
+
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(proc.session().connection.output(), "HTTP/1.1 417 Expectation failed\r\n"
+"Content-Length: 23\r\n"
+"Connection: close\r\n"
+"\r\n"
+"Unsupported expectation");
+	}
+}
+
+TESTCASE(west_http_request_processor_recorder)
+{
+	std::string_view request{"GET / HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"\r\n"
+"POST / HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"Content-Length: 3\r\n"
+"\r\n"
+"abc"};
+
+	auto const events = std::make_shared<std::vector<recorded_event>>();
+	west::http::request_processor proc{socket{},
+		request_handler{""},
+		west::http::timeout_policy{},
+		std::make_shared<west::http::session_buffer_pool>(),
+		west::http::request_processor_limits{},
+		recorder{events}
+	};
+	proc.session().connection.get().request(request);
+	proc.session().connection.get().max_read_size(65536);
+
+	// First read blocks. No state has completed yet.
+	auto res = proc.socket_is_ready();
+	EXPECT_EQ(res.status, west::http::request_processor_status::more_data_needed);
+	EXPECT_EQ(std::size(*events), 0);
+
+	res = proc.socket_is_ready();
+	EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+	EXPECT_EQ(proc.session().connection.counters().bytes_read, std::size(request));
+
+	std::vector<std::pair<std::string_view, size_t>> actual;
+	west::io::io_counters total{};
+	for(auto const& item : *events)
+	{
+		actual.push_back(std::pair{item.name, item.state_index});
+		total.read_calls += item.io.read_calls;
+		total.write_calls += item.io.write_calls;
+		total.bytes_read += item.io.bytes_read;
+		total.bytes_written += item.io.bytes_written;
+	}
+
+	using namespace west::http;
+	std::vector<std::pair<std::string_view, size_t>> const expected{
+		{"state_completed", request_state_index<read_request_header>},
+		{"state_completed", request_state_index<read_request_body>},
+		{"state_completed", request_state_index<write_response_header>},
+		{"state_completed", request_state_index<write_response_body>},
+		{"request_completed", 0},
+		{"state_completed", request_state_index<wait_for_data>},
+		{"request_started", 0},
+		{"state_completed", request_state_index<read_request_header>},
+		{"state_completed", request_state_index<read_request_body>},
+		{"state_completed", request_state_index<write_response_header>},
+		{"state_completed", request_state_index<write_response_body>},
+		{"request_completed", 0}
+	};
+	EXPECT_EQ(actual, expected);
+
+	// All I/O except the read that found the connection closed is attributed to a state
+	EXPECT_EQ(total.bytes_read, std::size(request));
+	EXPECT_EQ(total.bytes_written, proc.session().connection.counters().bytes_written);
+	EXPECT_EQ(total.read_calls + 1, proc.session().connection.counters().read_calls);
+	EXPECT_EQ(std::string_view{request_state_names[request_state_index<wait_for_data>]}, "wait_for_data");
+}
+
+TESTCASE(west_http_request_processor_session_counters)
+{
+	auto const counters = std::make_shared<west::http::session_counters>();
+
+	{
+		std::string_view request{"GET / HTTP/1.1\r\n"
+"Host: localhost:8000\r\n"
+"\r\n"};
+
+		west::http::request_processor proc{socket{},
+			request_handler{""},
+			west::http::timeout_policy{},
+			std::make_shared<west::http::session_buffer_pool>(),
+			west::http::request_processor_limits{},
+			west::http::session_counters_recorder{counters}
+		};
+		proc.session().connection.get().request(request);
+		proc.session().connection.get().max_read_size(65536);
+		EXPECT_EQ(counters->sessions_in_state[west::http::request_state_index<west::http::read_request_header>], 1);
+
+		// The session is counted in its last state until it is destroyed
+		(void)proc.socket_is_ready();
+		(void)proc.socket_is_ready();
+		EXPECT_EQ(counters->sessions_in_state[west::http::request_state_index<west::http::read_request_header>], 0);
+		EXPECT_EQ(counters->sessions_in_state[west::http::request_state_index<west::http::wait_for_data>], 1);
+		EXPECT_EQ(counters->requests_completed, 1);
+		EXPECT_EQ(counters->bytes_read, std::size(request));
+		EXPECT_EQ(counters->bytes_written, std::size(proc.session().connection.get().output()));
+	}
+
+	{
+		std::string_view request{"GET / HTTP/1.1\r\n"
+"Host : localhost:8000\r\n"
+"\r\n"};
+
+		west::http::request_processor proc{socket{},
+			request_handler{""},
+			west::http::timeout_policy{},
+			std::make_shared<west::http::session_buffer_pool>(),
+			west::http::request_processor_limits{},
+			west::http::session_counters_recorder{counters}
+		};
+		proc.session().connection.get().request(request);
+		proc.session().connection.get().max_read_size(65536);
+		EXPECT_EQ(counters->open_sessions(), 1);
+
+		(void)proc.socket_is_ready();
+		auto const res = proc.socket_is_ready();
+		EXPECT_EQ(res.status, west::http::request_processor_status::completed);
+		EXPECT_EQ(counters->header_errors[static_cast<size_t>(west::http::req_header_parser_error_code::bad_field_name)], 1);
+	}
+
+	EXPECT_EQ(counters->open_sessions(), 0);
+	EXPECT_EQ(counters->requests_completed, 2);
+}
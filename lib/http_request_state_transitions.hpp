@@ -2,7 +2,9 @@
 #define WEST_HTTP_REQUEST_STATE_TRANSITIONS_HPP
 
 #include "./http_read_request_header.hpp"
+#include "./http_write_interim_response.hpp"
 #include "./http_read_request_body.hpp"
+#include "./http_read_request_chunked_body.hpp"
 #include "./http_write_response_header.hpp"
 #include "./http_write_response_body.hpp"
 #include "./http_wait_for_data.hpp"
@@ -13,7 +15,9 @@
 namespace west::http
 {
 	using request_state_holder = std::variant<read_request_header,
+		write_interim_response,
 		read_request_body,
+		read_request_chunked_body,
 		write_response_header,
 		write_response_body,
 		wait_for_data>;
@@ -25,12 +29,20 @@ namespace west::http
 
 	template<>
 	struct next_request_state<read_request_header>
+	{ using state_handler = write_interim_response; };
+
+	template<>
+	struct next_request_state<write_interim_response>
 	{ using state_handler = read_request_body; };
 
 	template<>
 	struct next_request_state<read_request_body>
 	{ using state_handler = write_response_header; };
 
+	template<>
+	struct next_request_state<read_request_chunked_body>
+	{ using state_handler = write_response_header; };
+
 	template<>
 	struct next_request_state<write_response_header>
 	{ using state_handler = write_response_body; };
@@ -52,10 +64,25 @@ namespace west::http
 	inline auto make_state_handler<read_request_header>(request_info const&, response_info const&)
 	{ return read_request_header{}; }
 
+	// NOTE: A chunked request body is read by read_request_chunked_body instead
 	template<>
 	inline auto make_state_handler<read_request_body>(request_info const& request,
 		response_info const&)
-	{ return read_request_body{request.content_length}; }
+	{
+		if(request.body_is_chunked)
+		{ return request_state_holder{read_request_chunked_body{chunked_decoder_limits{}, request.max_body_size}}; }
+		return request_state_holder{read_request_body{request.content_length}};
+	}
+
+	// NOTE: The interim response is skipped unless the client waits for it
+	template<>
+	inline auto make_state_handler<write_interim_response>(request_info const& request,
+		response_info const& response)
+	{
+		if(request.expects_continue)
+		{ return request_state_holder{write_interim_response{}}; }
+		return make_state_handler<read_request_body>(request, response);
+	}
 
 	template<>
 	inline auto make_state_handler<write_response_header>(request_info const&,
@@ -66,16 +93,29 @@ namespace west::http
 	inline auto make_state_handler<write_response_body>(request_info const&,
 		response_info const& response)
 	{
-		assert(!response.header.fields.contains("Transfer-encoding"));
+		if(response.body_ends_at_close)
+		{
+			assert(!response.header.fields.contains(known_field::content_length));
+			return write_response_body{body_until_close{}};
+		}
+
+		if(is_chunked(response.header.fields))
+		{
+			assert(!response.header.fields.contains(known_field::content_length));
+			return write_response_body{chunked_body{}};
+		}
+
+		assert(!response.header.fields.contains(known_field::transfer_encoding));
 
-		auto i = response.header.fields.find("Content-Length");
+		auto i = response.header.fields.find(known_field::content_length);
 		if(i == std::end(response.header.fields))
 		{ return write_response_body{static_cast<size_t>(0)}; }
 
 		auto length_conv = to_number<size_t>(i->second);
 		assert(length_conv.has_value());
+		assert(response.body_bytes_sent <= *length_conv);
 
-		return write_response_body{*length_conv};
+		return write_response_body{*length_conv - response.body_bytes_sent};
 	}
 
 	template<>
@@ -94,10 +134,18 @@ namespace west::http
 	struct select_io_direction<read_request_header>
 	{ static constexpr auto value = session_state_io_direction::input; };
 
+	template<>
+	struct select_io_direction<write_interim_response>
+	{ static constexpr auto value = session_state_io_direction::output; };
+
 	template<>
 	struct select_io_direction<read_request_body>
 	{ static constexpr auto value = session_state_io_direction::input; };
 
+	template<>
+	struct select_io_direction<read_request_chunked_body>
+	{ static constexpr auto value = session_state_io_direction::input; };
+
 	template<>
 	struct select_io_direction<write_response_header>
 	{ static constexpr auto value = session_state_io_direction::output; };
@@ -125,12 +173,15 @@ namespace west::http
 		request_info const& request,
 		response_info const& response)
 	{
-		return std::visit([&request, response]<class T>(T const&) {
+		return std::visit([&request, &response]<class T>(T const&) {
 			using next_state_handler = next_request_state<T>::state_handler;
-			return std::pair{
-				request_state_holder{make_state_handler<next_state_handler>(request, response)},
-				select_io_direction<next_state_handler>::value
-			};
+			request_state_holder next_state{make_state_handler<next_state_handler>(request, response)};
+
+			// NOTE: A state may be skipped, so the direction is taken from the state that was created
+			auto const io_dir = std::visit([]<class U>(U const&) {
+				return select_io_direction<U>::value;
+			}, next_state);
+			return std::pair{std::move(next_state), io_dir};
 		}, initial_state);
 	}
 }
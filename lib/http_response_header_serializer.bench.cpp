@@ -0,0 +1,82 @@
+//@	{"target":{"name":"http_response_header_serializer.bench"}}
+
+#include "./http_response_header_serializer.hpp"
+
+#include "bench/benchmark.hpp"
+
+#include <array>
+#include <vector>
+
+namespace
+{
+	west::http::response_header make_small_header()
+	{
+		west::http::response_header ret{};
+		ret.status_line.http_version = west::http::version{1, 1};
+		ret.status_line.status_code = west::http::status::ok;
+		ret.fields.append("Content-Length", "1234")
+			.append("Content-Type", "text/html; charset=utf-8");
+		return ret;
+	}
+
+	west::http::response_header make_large_header()
+	{
+		west::http::response_header ret{};
+		ret.status_line.http_version = west::http::version{1, 1};
+		ret.status_line.status_code = west::http::status::ok;
+		ret.fields.append("Content-Length", "1234")
+			.append("Content-Type", "application/javascript; charset=utf-8")
+			.append("Cache-Control", "public, max-age=31536000, immutable")
+			.append("ETag", "\"5d8c72a5edda8d6a:0\"")
+			.append("Last-Modified", "Wed, 21 Oct 2015 07:28:00 GMT")
+			.append("Date", "Wed, 21 Oct 2015 07:28:00 GMT")
+			.append("Server", "west")
+			.append("Vary", "Accept-Encoding")
+			.append("Strict-Transport-Security", "max-age=63072000; includeSubDomains; preload")
+			.append("X-Content-Type-Options", "nosniff")
+			.append("X-Request-Id", "0f8fad5b-d9cb-469f-a165-70867728950e")
+			.append("Set-Cookie", "session_id=8c5f1e0a9b2d4c7e8f6a3b1d0e9c8b7a; Path=/; Secure; HttpOnly");
+		return ret;
+	}
+
+	// Serializes `header` through a buffer of `buffer_size` bytes, and returns the number of bytes
+	// written
+	size_t serialize(west::http::response_header const& header, std::span<char> buffer)
+	{
+		west::http::response_header_serializer serializer{header};
+		size_t ret = 0;
+		while(!serializer.is_completed())
+		{
+			auto const res = serializer.serialize(buffer);
+			ret += static_cast<size_t>(res.ptr - std::data(buffer));
+			west::bench::do_not_optimize(buffer);
+		}
+		return ret;
+	}
+}
+
+int main()
+{
+	std::array const headers{
+		std::pair{"small", make_small_header()},
+		std::pair{"large", make_large_header()}
+	};
+
+	std::vector<char> buffer(4096);
+	for(auto const& [header_name, header] : headers)
+	{
+		auto const header_size = serialize(header, buffer);
+		for(auto const buffer_size : {size_t{4096}, size_t{64}})
+		{
+			auto const name = std::string{"response_header_serializer/"}
+				.append(header_name)
+				.append("/buffer_size=")
+				.append(std::to_string(buffer_size));
+
+			std::span const output_buffer{std::data(buffer), buffer_size};
+			west::bench::run(name, header_size, [&header, output_buffer](){
+				west::bench::do_not_optimize(serialize(header, output_buffer));
+			});
+		}
+	}
+}
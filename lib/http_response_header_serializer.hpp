@@ -4,6 +4,8 @@
 #include "./http_message_header.hpp"
 
 #include <span>
+#include <string_view>
+#include <cstring>
 
 namespace west::http
 {
@@ -16,53 +18,203 @@ namespace west::http
 		[[no_unique_address]] resp_header_serializer_error_code ec;
 	};
 
+	// Writes the decimal representation of val to output, and returns a pointer past the last digit
+	constexpr char* format_decimal(uint32_t val, char* output)
+	{
+		std::array<char, 10> digits{};
+		size_t n = 0;
+		do
+		{
+			digits[n] = static_cast<char>('0' + val % 10);
+			val /= 10;
+			++n;
+		}
+		while(val != 0);
+
+		while(n != 0)
+		{
+			--n;
+			*output = digits[n];
+			++output;
+		}
+		return output;
+	}
+
+	namespace detail
+	{
+		// NOTE: Contains "HTTP/1.1 <code> <reason phrase>\r\n" for all values of status, generated at
+		//       compile time
+		struct status_line_table
+		{
+			constexpr status_line_table():chars{}, offsets{}, lengths{}
+			{
+				size_t offset = 0;
+				for(auto item : all_statuses)
+				{
+					auto const code = static_cast<uint32_t>(item);
+					std::string_view const reason{to_string(item)};
+					auto ptr = std::data(chars) + offset;
+					ptr = std::ranges::copy(std::string_view{"HTTP/1.1 "}, ptr).out;
+					ptr = format_decimal(code, ptr);
+					*ptr++ = ' ';
+					ptr = std::ranges::copy(reason, ptr).out;
+					ptr = std::ranges::copy(std::string_view{"\r\n"}, ptr).out;
+
+					auto const length = static_cast<size_t>(ptr - (std::data(chars) + offset));
+					offsets[code] = static_cast<uint16_t>(offset);
+					lengths[code] = static_cast<uint8_t>(length);
+					offset += length;
+				}
+			}
+
+			// Returns an empty view if `val` is not one of all_statuses
+			constexpr std::string_view get(status val) const
+			{
+				auto const code = static_cast<size_t>(val);
+				if(code >= std::size(lengths) || lengths[code] == 0)
+				{ return std::string_view{}; }
+				return std::string_view{std::data(chars) + offsets[code], lengths[code]};
+			}
+
+			// The reason phrase starts after "HTTP/1.1 <three digits> ", and is followed by "\r\n"
+			static constexpr size_t reason_phrase_offset = 13;
+
+			std::array<char, 2048> chars;
+			std::array<uint16_t, 600> offsets;
+			std::array<uint8_t, 600> lengths;
+		};
+
+		inline constexpr status_line_table status_lines{};
+	}
+
+	constexpr std::string_view make_status_line(status val)
+	{ return detail::status_lines.get(val); }
+
+	// NOTE: The serializer writes the header directly to the output buffer, and keeps a cursor into
+	//       the header, so serialization can continue with the next buffer if the header does not
+	//       fit. The header is not copied, and must outlive the serializer.
 	class response_header_serializer
 	{
 	public:
 		inline explicit response_header_serializer(response_header const& resp_header);
 
-		resp_header_serialize_result serialize(std::span<char> output_buffer)
-		{
-			auto const n = std::min(std::size(output_buffer), std::size(m_range_to_write));
-			std::copy_n(std::begin(m_range_to_write), n, std::begin(output_buffer));
-			m_range_to_write = std::span{std::begin(m_range_to_write) + n, std::end(m_range_to_write)};
-
-			return resp_header_serialize_result{
-				std::data(output_buffer) + n,
-				resp_header_serializer_error_code{}
-			};
-		}
+		inline resp_header_serialize_result serialize(std::span<char> output_buffer);
+
+		[[nodiscard]] bool is_completed() const
+		{ return m_current_piece == m_piece_count; }
 
 	private:
-		std::span<char const> m_range_to_write;
-		std::string m_string_to_write;
+		inline std::string_view get_piece(size_t index) const;
+
+		response_header const* m_header;
+
+		// NOTE: Refers to the precomputed status line. If empty, the beginning of the status line is
+		//       stored in m_status_line_buffer. A length is stored rather than a view into the
+		//       buffer, so the serializer can be copied and moved.
+		std::string_view m_precomputed_status_line;
+		size_t m_status_line_length;
+		std::string_view m_reason_phrase;
+		std::string_view m_status_line_end;
+		size_t m_piece_count;
+		size_t m_current_piece;
+		size_t m_offset;
+		std::array<char, 32> m_status_line_buffer;
 	};
+}
 
-	response_header_serializer::response_header_serializer(response_header const& resp_header):
-		m_string_to_write{"HTTP/"}
+west::http::response_header_serializer::response_header_serializer(response_header const& resp_header):
+	m_header{&resp_header},
+	m_status_line_length{0},
+	m_piece_count{4 + 4*std::size(resp_header.fields)},
+	m_current_piece{0},
+	m_offset{0}
+{
+	// NOTE: A status code that is not one of all_statuses has no precomputed status line, and no
+	//       default reason phrase
+	auto const& status_line = resp_header.status_line;
+	auto const precomputed_status_line = make_status_line(status_line.status_code);
+	if(status_line.http_version == version{1, 1} && !precomputed_status_line.empty())
 	{
-		using status_int = std::underlying_type<status>::type;
-		m_string_to_write.append(to_string(resp_header.status_line.http_version))
-			.append(" ")
-			.append(std::to_string(static_cast<status_int>(resp_header.status_line.status_code)))
-			.append(" ")
-			.append(resp_header.status_line.reason_phrase.empty() ?
-				 to_string(resp_header.status_line.status_code)
-				:resp_header.status_line.reason_phrase)
-			.append("\r\n");
-
-		for(auto const& item : resp_header.fields)
+		auto const default_reason_phrase = precomputed_status_line.substr(
+			detail::status_line_table::reason_phrase_offset,
+			std::size(precomputed_status_line) - detail::status_line_table::reason_phrase_offset - 2);
+		if(status_line.reason_phrase.empty() || status_line.reason_phrase == default_reason_phrase)
 		{
-			m_string_to_write.append(item.first.value())
-				.append(": ")
-				.append(item.second)
-				.append("\r\n");
+			m_precomputed_status_line = precomputed_status_line;
+			return;
 		}
+	}
+
+	auto ptr = std::data(m_status_line_buffer);
+	ptr = std::ranges::copy(std::string_view{"HTTP/"}, ptr).out;
+	ptr = format_decimal(status_line.http_version.major(), ptr);
+	*ptr++ = '.';
+	ptr = format_decimal(status_line.http_version.minor(), ptr);
+	*ptr++ = ' ';
+	ptr = format_decimal(static_cast<uint32_t>(status_line.status_code), ptr);
+	*ptr++ = ' ';
+	m_status_line_length = static_cast<size_t>(ptr - std::data(m_status_line_buffer));
+	if(!status_line.reason_phrase.empty())
+	{ m_reason_phrase = status_line.reason_phrase; }
+	else
+	if(!precomputed_status_line.empty())
+	{ m_reason_phrase = to_string(status_line.status_code); }
+	m_status_line_end = "\r\n";
+}
+
+std::string_view west::http::response_header_serializer::get_piece(size_t index) const
+{
+	switch(index)
+	{
+		case 0:
+			return m_precomputed_status_line.empty()?
+				std::string_view{std::data(m_status_line_buffer), m_status_line_length}
+				: m_precomputed_status_line;
+		case 1:
+			return m_reason_phrase;
+		case 2:
+			return m_status_line_end;
+		default:
+			break;
+	}
+
+	if(index == m_piece_count - 1)
+	{ return "\r\n"; }
 
-		m_string_to_write.append("\r\n");
+	auto const& field = *(std::begin(m_header->fields) + (index - 3)/4);
+	switch((index - 3)%4)
+	{
+		case 0:
+			return field.first.value();
+		case 1:
+			return ": ";
+		case 2:
+			return field.second;
+		default:
+			return "\r\n";
+	}
+}
 
-		m_range_to_write = std::span{std::begin(m_string_to_write), std::end(m_string_to_write)};
+west::http::resp_header_serialize_result
+west::http::response_header_serializer::serialize(std::span<char> output_buffer)
+{
+	auto ptr = std::data(output_buffer);
+	auto const end = ptr + std::size(output_buffer);
+	while(ptr != end && m_current_piece != m_piece_count)
+	{
+		auto const piece = get_piece(m_current_piece);
+		auto const n = std::min(std::size(piece) - m_offset, static_cast<size_t>(end - ptr));
+		memcpy(ptr, std::data(piece) + m_offset, n);
+		ptr += n;
+		m_offset += n;
+		if(m_offset == std::size(piece))
+		{
+			++m_current_piece;
+			m_offset = 0;
+		}
 	}
+
+	return resp_header_serialize_result{ptr, resp_header_serializer_error_code{}};
 }
 
-#endif
\ No newline at end of file
+#endif
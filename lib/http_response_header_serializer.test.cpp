@@ -4,6 +4,9 @@
 
 #include <testfwk/testfwk.hpp>
 
+#include <optional>
+#include <vector>
+
 TESTCASE(west_http_response_header_serializer_serialize_no_reason_phrase)
 {
 	west::http::response_header response{};
@@ -30,4 +33,152 @@ TESTCASE(west_http_response_header_serializer_serialize_no_reason_phrase)
 "connection: closed\r\n"
 "content-type: text/plain\r\n"
 "\r\n"});
-}
\ No newline at end of file
+}
+namespace
+{
+	std::string serialize_with_buffer_size(west::http::response_header const& response, size_t buffer_size)
+	{
+		west::http::response_header_serializer serializer{response};
+		std::vector<char> buffer(buffer_size);
+		std::string result;
+		while(true)
+		{
+			auto const res = serializer.serialize(buffer);
+			if(res.ptr == std::data(buffer))
+			{ return result; }
+			result.append(std::data(buffer), res.ptr);
+		}
+	}
+}
+
+TESTCASE(west_http_format_decimal)
+{
+	constexpr auto formatted = [](){
+		std::array<char, 16> ret{};
+		west::http::format_decimal(4294967295u, std::data(ret));
+		return ret;
+	}();
+	EXPECT_EQ(std::string_view{std::data(formatted)}, "4294967295");
+
+	std::array<char, 16> buffer{};
+	EXPECT_EQ(west::http::format_decimal(0, std::data(buffer)), std::data(buffer) + 1);
+	EXPECT_EQ(buffer[0], '0');
+}
+
+TESTCASE(west_http_make_status_line)
+{
+	static_assert(west::http::make_status_line(west::http::status::ok) == "HTTP/1.1 200 Ok\r\n");
+
+	for(auto item : west::http::all_statuses)
+	{
+		auto const expected = std::string{"HTTP/1.1 "}
+			.append(std::to_string(static_cast<int>(item)))
+			.append(" ")
+			.append(to_string(item))
+			.append("\r\n");
+		EXPECT_EQ(west::http::make_status_line(item), expected);
+	}
+
+	EXPECT_EQ(west::http::make_status_line(static_cast<west::http::status>(299)), "");
+	EXPECT_EQ(west::http::make_status_line(static_cast<west::http::status>(600)), "");
+	EXPECT_EQ(west::http::make_status_line(static_cast<west::http::status>(999)), "");
+}
+
+TESTCASE(west_http_response_header_serializer_serialize_precomputed_status_line)
+{
+	west::http::response_header response{};
+	response.status_line.http_version = west::http::version{1, 1};
+	response.status_line.status_code = west::http::status::not_found;
+	response.status_line.reason_phrase = "Not found";
+	response.fields.append("Content-Length", "0");
+
+	EXPECT_EQ(serialize_with_buffer_size(response, 4096), std::string_view{"HTTP/1.1 404 Not found\r\n"
+"Content-Length: 0\r\n"
+"\r\n"});
+}
+
+TESTCASE(west_http_response_header_serializer_serialize_custom_status_line)
+{
+	west::http::response_header response{};
+	response.status_line.http_version = west::http::version{1, 0};
+	response.status_line.status_code = west::http::status::ok;
+	response.fields.append("Server", "west");
+
+	EXPECT_EQ(serialize_with_buffer_size(response, 4096), std::string_view{"HTTP/1.0 200 Ok\r\n"
+"Server: west\r\n"
+"\r\n"});
+
+	response.status_line.http_version = west::http::version{1, 1};
+	response.status_line.reason_phrase = "Fine";
+	EXPECT_EQ(serialize_with_buffer_size(response, 4096), std::string_view{"HTTP/1.1 200 Fine\r\n"
+"Server: west\r\n"
+"\r\n"});
+}
+
+TESTCASE(west_http_response_header_serializer_serialize_custom_status_code)
+{
+	west::http::response_header response{};
+	response.status_line.http_version = west::http::version{1, 1};
+	response.status_line.status_code = static_cast<west::http::status>(299);
+	response.status_line.reason_phrase = "Custom";
+	response.fields.append("Server", "west");
+
+	EXPECT_EQ(serialize_with_buffer_size(response, 4096), std::string_view{"HTTP/1.1 299 Custom\r\n"
+"Server: west\r\n"
+"\r\n"});
+
+	response.status_line.status_code = static_cast<west::http::status>(799);
+	EXPECT_EQ(serialize_with_buffer_size(response, 4096), std::string_view{"HTTP/1.1 799 Custom\r\n"
+"Server: west\r\n"
+"\r\n"});
+
+	response.status_line.reason_phrase.clear();
+	EXPECT_EQ(serialize_with_buffer_size(response, 4096), std::string_view{"HTTP/1.1 799 \r\n"
+"Server: west\r\n"
+"\r\n"});
+}
+
+TESTCASE(west_http_response_header_serializer_copy_and_move_custom_status_line)
+{
+	west::http::response_header response{};
+	response.status_line.http_version = west::http::version{1, 0};
+	response.status_line.status_code = west::http::status::ok;
+	response.fields.append("Server", "west");
+
+	auto serialize = [](west::http::response_header_serializer& serializer) {
+		std::array<char, 4096> buffer{};
+		auto const res = serializer.serialize(buffer);
+		return std::string{std::data(buffer), res.ptr};
+	};
+
+	std::optional<west::http::response_header_serializer> original{response};
+	auto copy = *original;
+	auto moved = std::move(*original);
+
+	// Reuse the storage of the original for a different status line
+	west::http::response_header other_response{};
+	other_response.status_line.http_version = west::http::version{1, 1};
+	other_response.status_line.status_code = west::http::status::ok;
+	other_response.status_line.reason_phrase = "Fine";
+	original.emplace(other_response);
+
+	EXPECT_EQ(serialize(copy), "HTTP/1.0 200 Ok\r\nServer: west\r\n\r\n");
+	EXPECT_EQ(serialize(moved), "HTTP/1.0 200 Ok\r\nServer: west\r\n\r\n");
+	EXPECT_EQ(serialize(*original), "HTTP/1.1 200 Fine\r\n\r\n");
+}
+
+TESTCASE(west_http_response_header_serializer_serialize_any_buffer_size)
+{
+	west::http::response_header response{};
+	response.status_line.http_version = west::http::version{1, 1};
+	response.status_line.status_code = west::http::status::ok;
+	for(size_t k = 0; k != 20; ++k)
+	{ response.fields.append("x-field-" + std::to_string(k), std::string(k*10, 'a')); }
+
+	auto const expected = serialize_with_buffer_size(response, 65536);
+	EXPECT_EQ(expected.starts_with("HTTP/1.1 200 Ok\r\nx-field-0: \r\nx-field-1: aaaaaaaaaa\r\n"), true);
+	EXPECT_EQ(expected.ends_with("\r\n\r\n"), true);
+
+	for(size_t buffer_size = 1; buffer_size != 64; ++buffer_size)
+	{ EXPECT_EQ(serialize_with_buffer_size(response, buffer_size), expected); }
+}
@@ -2,6 +2,7 @@
 #define WEST_HTTP_SERVER_HPP
 
 #include "./service_registry.hpp"
+#include "./sharded_service_registry.hpp"
 #include "./http_request_processor.hpp"
 #include "./http_session_factory.hpp"
 #include "./http_request_handler.hpp"
@@ -11,6 +12,9 @@ struct west::session_state_mapper<west::http::process_request_result>
 {
 	constexpr auto operator()(http::process_request_result res) const
 	{
+		if(res.status == http::request_processor_status::waiting_for_request_handler)
+		{ return io::listen_on::nothing; }
+
 		switch(res.io_dir)
 		{
 			case http::session_state_io_direction::input:
@@ -25,8 +29,8 @@ struct west::session_state_mapper<west::http::process_request_result>
 
 namespace west
 {
-	template<http::request_handler RequestHandler, server_socket ServerSocket, class... SessionArgs>
-	auto& enroll_http_service(service_registry& registry,
+	template<http::request_handler RequestHandler, server_socket ServerSocket, class EventMonitor, class... SessionArgs>
+	auto& enroll_http_service(basic_service_registry<EventMonitor>& registry,
 		ServerSocket&& server,
 		SessionArgs&&... session_args)
 	{
@@ -34,6 +38,16 @@ namespace west
 			http::session_factory<RequestHandler>{},
 			std::forward<SessionArgs>(session_args)...);
 	}
+
+	template<http::request_handler RequestHandler, server_socket ServerSocket, class EventMonitor, class... SessionArgs>
+	auto& enroll_http_service(basic_sharded_service_registry<EventMonitor>& registry,
+		std::vector<ServerSocket>&& servers,
+		SessionArgs const&... session_args)
+	{
+		return registry.enroll(std::move(servers),
+			http::session_factory<RequestHandler>{},
+			session_args...);
+	}
 }
 
 #endif
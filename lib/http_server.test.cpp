@@ -0,0 +1,649 @@
+//@	{"target":{"name":"http_server.test"}}
+
+#include "./http_server.hpp"
+#include "./http_request_metrics.hpp"
+#include "./io_inet_server_socket.hpp"
+#include "./io_uring_event_monitor.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <atomic>
+#include <thread>
+#include <string>
+#include <charconv>
+
+namespace
+{
+	enum class request_handler_error_code{no_error, would_block};
+
+	constexpr bool can_continue(request_handler_error_code)
+	{ return true; }
+
+	constexpr bool is_error_indicator(request_handler_error_code)
+	{ return false; }
+
+	constexpr bool is_would_block(request_handler_error_code ec)
+	{ return ec == request_handler_error_code::would_block; }
+
+	constexpr char const* to_string(request_handler_error_code ec)
+	{ return ec == request_handler_error_code::would_block? "Would block" : "No error"; }
+
+	struct request_handler_write_result
+	{
+		size_t bytes_written;
+		request_handler_error_code ec;
+	};
+
+	struct request_handler_read_result
+	{
+		size_t bytes_read;
+		request_handler_error_code ec;
+	};
+
+	class fixed_size_response
+	{
+	public:
+		explicit fixed_size_response(size_t body_size):m_body_size{body_size}, m_bytes_left{0}
+		{}
+
+		west::http::finalize_state_result finalize_state(west::http::request_header const&)
+		{ return west::http::finalize_state_result{}; }
+
+		west::http::finalize_state_result finalize_state(west::http::field_map& fields)
+		{
+			fields.append("Content-Length", std::to_string(m_body_size));
+			m_bytes_left = m_body_size;
+			return west::http::finalize_state_result{};
+		}
+
+		void finalize_state(west::http::field_map& fields, west::http::finalize_state_result&&)
+		{
+			fields.append("Content-Length", "0");
+			m_bytes_left = 0;
+		}
+
+		auto process_request_content(std::span<char const> buffer, size_t)
+		{ return request_handler_write_result{std::size(buffer), request_handler_error_code::no_error}; }
+
+		auto read_response_content(std::span<char> buffer)
+		{
+			auto const n = std::min(std::size(buffer), m_bytes_left);
+			std::fill_n(std::data(buffer), n, 'x');
+			m_bytes_left -= n;
+			return request_handler_read_result{n, request_handler_error_code::no_error};
+		}
+
+	private:
+		size_t m_body_size;
+		size_t m_bytes_left;
+	};
+
+	// NOTE: Responds with a chunked body. The size is not known in advance, as if the body was
+	//       generated while it is being sent.
+	class chunked_response
+	{
+	public:
+		explicit chunked_response(size_t body_size):m_body_size{body_size}, m_bytes_left{0}
+		{}
+
+		west::http::finalize_state_result finalize_state(west::http::request_header const&)
+		{ return west::http::finalize_state_result{}; }
+
+		west::http::finalize_state_result finalize_state(west::http::field_map& fields)
+		{
+			fields.append("Transfer-Encoding", "chunked");
+			m_bytes_left = m_body_size;
+			return west::http::finalize_state_result{};
+		}
+
+		void finalize_state(west::http::field_map& fields, west::http::finalize_state_result&&)
+		{
+			fields.append("Content-Length", "0");
+			m_bytes_left = 0;
+		}
+
+		auto process_request_content(std::span<char const> buffer, size_t)
+		{ return request_handler_write_result{std::size(buffer), request_handler_error_code::no_error}; }
+
+		auto read_response_content(std::span<char> buffer)
+		{
+			auto const n = std::min(std::min(std::size(buffer), m_bytes_left), static_cast<size_t>(1000));
+			std::fill_n(std::data(buffer), n, 'x');
+			m_bytes_left -= n;
+			return request_handler_read_result{n, request_handler_error_code::no_error};
+		}
+
+	private:
+		size_t m_body_size;
+		size_t m_bytes_left;
+	};
+
+	// Responds with the number of request body bytes it received
+	class count_request_body
+	{
+	public:
+		west::http::finalize_state_result finalize_state(west::http::request_header const&)
+		{
+			m_bytes_received = 0;
+			return west::http::finalize_state_result{};
+		}
+
+		west::http::finalize_state_result finalize_state(west::http::field_map& fields)
+		{
+			m_response = std::to_string(m_bytes_received);
+			m_bytes_sent = 0;
+			fields.append("Content-Length", std::to_string(std::size(m_response)));
+			return west::http::finalize_state_result{};
+		}
+
+		void finalize_state(west::http::field_map& fields, west::http::finalize_state_result&&)
+		{
+			fields.append("Content-Length", "0");
+			m_response.clear();
+		}
+
+		auto process_request_content(std::span<char const> buffer, size_t)
+		{
+			m_bytes_received += std::size(buffer);
+			return request_handler_write_result{std::size(buffer), request_handler_error_code::no_error};
+		}
+
+		auto read_response_content(std::span<char> buffer)
+		{
+			auto const n = std::min(std::size(buffer), std::size(m_response) - m_bytes_sent);
+			std::copy_n(std::data(m_response) + m_bytes_sent, n, std::data(buffer));
+			m_bytes_sent += n;
+			return request_handler_read_result{n, request_handler_error_code::no_error};
+		}
+
+	private:
+		size_t m_bytes_received{0};
+		std::string m_response;
+		size_t m_bytes_sent{0};
+	};
+
+	// NOTE: Responds with a chunked body, but has no data until `wait` has passed since the response
+	//       header was finalized. Counts the calls to read_response_content in `calls`.
+	class delayed_response
+	{
+	public:
+		explicit delayed_response(std::chrono::milliseconds wait, std::atomic<size_t>* calls):
+			m_wait{wait},
+			m_calls{calls}
+		{}
+
+		west::http::finalize_state_result finalize_state(west::http::request_header const&)
+		{ return west::http::finalize_state_result{}; }
+
+		west::http::finalize_state_result finalize_state(west::http::field_map& fields)
+		{
+			fields.append("Transfer-Encoding", "chunked");
+			m_ready_at = std::chrono::steady_clock::now() + m_wait;
+			m_response = "Hello";
+			return west::http::finalize_state_result{};
+		}
+
+		void finalize_state(west::http::field_map& fields, west::http::finalize_state_result&&)
+		{
+			fields.append("Content-Length", "0");
+			m_response = "";
+		}
+
+		auto process_request_content(std::span<char const> buffer, size_t)
+		{ return request_handler_write_result{std::size(buffer), request_handler_error_code::no_error}; }
+
+		auto read_response_content(std::span<char> buffer)
+		{
+			++*m_calls;
+			if(std::chrono::steady_clock::now() < m_ready_at)
+			{ return request_handler_read_result{0, request_handler_error_code::would_block}; }
+
+			auto const n = std::min(std::size(buffer), std::size(m_response));
+			std::copy_n(std::data(m_response), n, std::data(buffer));
+			m_response.remove_prefix(n);
+			return request_handler_read_result{n, request_handler_error_code::no_error};
+		}
+
+	private:
+		std::chrono::milliseconds m_wait;
+		std::atomic<size_t>* m_calls;
+		std::chrono::steady_clock::time_point m_ready_at;
+		std::string_view m_response;
+	};
+
+	// Sends num_requests requests over one connection, and reads the responses. Returns the number
+	// of calls to epoll_ctl made by the server, per request.
+	double epoll_ctl_calls_per_request(west::io::trigger_mode mode, size_t body_size, size_t num_requests)
+	{
+		west::io::inet_address address{"127.0.0.1"};
+		west::io::inet_server_socket server_socket{
+			address,
+			std::ranges::iota_view{49152, 65536},
+			128
+		};
+		auto const port = server_socket.port();
+
+		west::service_registry registry{};
+		registry.connection_trigger_mode(mode);
+
+		// NOTE: The client sends the next request as soon as it has received a response, so the
+		//       server may complete many requests per event. Yielding would add calls to epoll_ctl.
+		west::http::session_factory<fixed_size_response> factory{};
+		factory.limits.max_requests_per_event = num_requests;
+		registry.enroll(std::move(server_socket), std::move(factory), body_size);
+
+		size_t ctl_calls_at_start = 0;
+		std::jthread server_thread{[&registry](std::stop_token stop){
+			registry.process_events(stop);
+		}};
+
+		size_t ctl_calls = 0;
+		{
+			auto socket = west::io::connect_to(address, port);
+			std::string_view const request{"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"};
+			std::string response;
+			std::array<char, 65536> buffer{};
+			for(size_t k = 0; k != num_requests; ++k)
+			{
+				REQUIRE_EQ(::write(socket.get(), std::data(request), std::size(request)), std::ssize(request));
+
+				response.clear();
+				auto header_end = std::string::npos;
+				while(header_end == std::string::npos || std::size(response) < header_end + 4 + body_size)
+				{
+					auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+					REQUIRE_EQ(n > 0, true);
+					response.append(std::data(buffer), static_cast<size_t>(n));
+					if(header_end == std::string::npos)
+					{ header_end = response.find("\r\n\r\n"); }
+				}
+				EXPECT_EQ(std::size(response), header_end + 4 + body_size);
+
+				// NOTE: The server socket and the connection have been added after the first response
+				if(k == 0)
+				{ ctl_calls_at_start = registry.event_monitor().poller().ctl_call_count(); }
+			}
+
+			// NOTE: Make sure the server is waiting for the next request before counting
+			std::this_thread::sleep_for(std::chrono::milliseconds{50});
+			ctl_calls = registry.event_monitor().poller().ctl_call_count() - ctl_calls_at_start;
+		}
+
+		server_thread.request_stop();
+		server_thread.join();
+
+		return static_cast<double>(ctl_calls)/static_cast<double>(num_requests - 1);
+	}
+}
+
+TESTCASE(west_http_server_trigger_mode_falls_back_to_level)
+{
+	west::service_registry epoll_registry{};
+	epoll_registry.connection_trigger_mode(west::io::trigger_mode::edge);
+	EXPECT_EQ(epoll_registry.connection_trigger_mode(), west::io::trigger_mode::edge);
+	epoll_registry.connection_trigger_mode(west::io::trigger_mode::level);
+	EXPECT_EQ(epoll_registry.connection_trigger_mode(), west::io::trigger_mode::level);
+
+	west::basic_service_registry<west::io::io_uring_event_monitor> io_uring_registry{};
+	io_uring_registry.connection_trigger_mode(west::io::trigger_mode::edge);
+	EXPECT_EQ(io_uring_registry.connection_trigger_mode(), west::io::trigger_mode::level);
+}
+
+TESTCASE(west_http_server_edge_triggered_keep_alive)
+{
+	size_t const num_requests = 64;
+	for(auto const body_size : {size_t{16}, size_t{4*1024*1024}})
+	{
+		auto const level = epoll_ctl_calls_per_request(west::io::trigger_mode::level, body_size, num_requests);
+		auto const edge = epoll_ctl_calls_per_request(west::io::trigger_mode::edge, body_size, num_requests);
+		EXPECT_EQ(edge, 0.0);
+		EXPECT_LE(edge, level);
+	}
+}
+
+TESTCASE(west_http_server_chunked_response)
+{
+	west::io::inet_address address{"127.0.0.1"};
+	west::io::inet_server_socket server_socket{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+	auto const port = server_socket.port();
+
+	size_t const body_size = 200000;
+	west::service_registry registry{};
+	enroll_http_service<chunked_response>(registry, std::move(server_socket), body_size);
+
+	std::jthread server_thread{[&registry](std::stop_token stop){
+		registry.process_events(stop);
+	}};
+
+	auto socket = west::io::connect_to(address, port);
+	std::string_view const request{"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"};
+	std::string response;
+	std::array<char, 65536> buffer{};
+	for(size_t k = 0; k != 2; ++k)
+	{
+		REQUIRE_EQ(::write(socket.get(), std::data(request), std::size(request)), std::ssize(request));
+
+		response.clear();
+		while(!response.ends_with("\r\n0\r\n\r\n"))
+		{
+			auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+			REQUIRE_EQ(n > 0, true);
+			response.append(std::data(buffer), static_cast<size_t>(n));
+		}
+
+		auto const header_end = response.find("\r\n\r\n");
+		REQUIRE_NE(header_end, std::string::npos);
+		EXPECT_NE(response.substr(0, header_end).find("Transfer-Encoding: chunked"), std::string::npos);
+
+		std::string_view body{response};
+		body.remove_prefix(header_end + 4);
+		size_t payload_size = 0;
+		while(true)
+		{
+			auto const size_end = body.find("\r\n");
+			REQUIRE_NE(size_end, std::string_view::npos);
+			size_t chunk_size = 0;
+			REQUIRE_EQ(std::from_chars(std::data(body), std::data(body) + size_end, chunk_size, 16).ec, std::errc{});
+			body.remove_prefix(size_end + 2);
+			if(chunk_size == 0)
+			{ break; }
+			EXPECT_EQ(body.substr(0, chunk_size).find_first_not_of('x'), std::string_view::npos);
+			payload_size += chunk_size;
+			body.remove_prefix(chunk_size + 2);
+		}
+		EXPECT_EQ(payload_size, body_size);
+		EXPECT_EQ(body, "\r\n");
+	}
+
+	server_thread.request_stop();
+}
+
+TESTCASE(west_http_server_chunked_request)
+{
+	west::io::inet_address address{"127.0.0.1"};
+	west::io::inet_server_socket server_socket{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+	auto const port = server_socket.port();
+
+	west::service_registry registry{};
+	enroll_http_service<count_request_body>(registry, std::move(server_socket));
+
+	std::jthread server_thread{[&registry](std::stop_token stop){
+		registry.process_events(stop);
+	}};
+
+	auto socket = west::io::connect_to(address, port);
+	std::string request{"POST / HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n"};
+	size_t const chunk_size = 50000;
+	for(size_t k = 0; k != 4; ++k)
+	{
+		request.append("c350;ext=foo\r\n").append(chunk_size, 'x').append("\r\n");
+	}
+	request.append("0\r\nExpires: never\r\n\r\n");
+
+	// The second request is pipelined after the last chunk of the first one
+	request.append("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+	std::jthread client_thread{[&socket, &request](){
+		std::string_view to_send{request};
+		while(!std::empty(to_send))
+		{
+			auto const n = ::write(socket.get(), std::data(to_send), std::size(to_send));
+			if(n <= 0)
+			{ return; }
+			to_send.remove_prefix(static_cast<size_t>(n));
+		}
+	}};
+
+	std::string response;
+	std::array<char, 65536> buffer{};
+	while(!response.ends_with("\r\n\r\n0"))
+	{
+		auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+		REQUIRE_EQ(n > 0, true);
+		response.append(std::data(buffer), static_cast<size_t>(n));
+	}
+
+	auto const first_body = response.find("\r\n\r\n");
+	REQUIRE_NE(first_body, std::string::npos);
+	EXPECT_EQ(response.substr(0, response.find("\r\n")), "HTTP/1.1 200 Ok");
+	EXPECT_EQ(response.substr(first_body + 4, 6), "200000");
+
+	server_thread.request_stop();
+}
+
+TESTCASE(west_http_server_chunked_request_with_content_length)
+{
+	west::io::inet_address address{"127.0.0.1"};
+	west::io::inet_server_socket server_socket{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+	auto const port = server_socket.port();
+
+	west::service_registry registry{};
+	enroll_http_service<count_request_body>(registry, std::move(server_socket));
+
+	std::jthread server_thread{[&registry](std::stop_token stop){
+		registry.process_events(stop);
+	}};
+
+	auto socket = west::io::connect_to(address, port);
+	std::string_view const request{"POST / HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n"
+		"Content-Length: 5\r\n\r\n5\r\nHello\r\n0\r\n\r\n"};
+	REQUIRE_EQ(::write(socket.get(), std::data(request), std::size(request)), std::ssize(request));
+
+	std::string response;
+	std::array<char, 65536> buffer{};
+	while(true)
+	{
+		auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+		if(n <= 0)
+		{ break; }
+		response.append(std::data(buffer), static_cast<size_t>(n));
+	}
+	EXPECT_EQ(response.substr(0, response.find("\r\n")), "HTTP/1.1 400 Bad request");
+
+	server_thread.request_stop();
+}
+
+TESTCASE(west_http_server_pipelined_requests_yield)
+{
+	for(auto const mode : {west::io::trigger_mode::level, west::io::trigger_mode::edge})
+	{
+		west::io::inet_address address{"127.0.0.1"};
+		west::io::inet_server_socket server_socket{
+			address,
+			std::ranges::iota_view{49152, 65536},
+			128
+		};
+		auto const port = server_socket.port();
+
+		west::service_registry registry{};
+		registry.connection_trigger_mode(mode);
+		west::http::session_factory<fixed_size_response> factory{};
+		factory.limits.max_requests_per_event = 4;
+		registry.enroll(std::move(server_socket), std::move(factory), size_t{16});
+
+		std::jthread server_thread{[&registry](std::stop_token stop){
+			registry.process_events(stop);
+		}};
+
+		// All requests are sent at once, so the server will have to yield several times
+		auto socket = west::io::connect_to(address, port);
+		std::string request;
+		size_t const num_requests = 50;
+		for(size_t k = 0; k != num_requests; ++k)
+		{ request.append("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"); }
+		REQUIRE_EQ(::write(socket.get(), std::data(request), std::size(request)), std::ssize(request));
+
+		std::string_view const response{"HTTP/1.1 200 Ok\r\nContent-Length: 16\r\n\r\nxxxxxxxxxxxxxxxx"};
+		std::string output;
+		std::array<char, 65536> buffer{};
+		while(std::size(output) < num_requests*std::size(response))
+		{
+			auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+			REQUIRE_EQ(n > 0, true);
+			output.append(std::data(buffer), static_cast<size_t>(n));
+		}
+
+		std::string expected_output;
+		for(size_t k = 0; k != num_requests; ++k)
+		{ expected_output.append(response); }
+		EXPECT_EQ(output, expected_output);
+
+		server_thread.request_stop();
+	}
+}
+
+TESTCASE(west_http_server_connection_close)
+{
+	west::io::inet_address address{"127.0.0.1"};
+	west::io::inet_server_socket server_socket{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+	auto const port = server_socket.port();
+
+	west::service_registry registry{};
+	enroll_http_service<fixed_size_response>(registry, std::move(server_socket), size_t{16});
+
+	std::jthread server_thread{[&registry](std::stop_token stop){
+		registry.process_events(stop);
+	}};
+
+	auto socket = west::io::connect_to(address, port);
+	std::string_view const request{"GET / HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"};
+	REQUIRE_EQ(::write(socket.get(), std::data(request), std::size(request)), std::ssize(request));
+
+	// The server closes the connection after the response, so the client sees end of file
+	std::string response;
+	std::array<char, 65536> buffer{};
+	while(true)
+	{
+		auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+		REQUIRE_EQ(n >= 0, true);
+		if(n == 0)
+		{ break; }
+		response.append(std::data(buffer), static_cast<size_t>(n));
+	}
+	EXPECT_EQ(response, "HTTP/1.1 200 Ok\r\nContent-Length: 16\r\nConnection: close\r\n\r\nxxxxxxxxxxxxxxxx");
+
+	server_thread.request_stop();
+}
+
+TESTCASE(west_http_server_request_metrics)
+{
+	west::io::inet_address address{"127.0.0.1"};
+	west::io::inet_server_socket server_socket{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+	auto const port = server_socket.port();
+
+	auto const metrics = std::make_shared<west::http::request_metrics>();
+	west::service_registry registry{};
+	west::http::session_factory<fixed_size_response, west::http::request_metrics_handle> factory{};
+	factory.instrumentation = west::http::request_metrics_handle{metrics};
+	registry.enroll(std::move(server_socket), std::move(factory), size_t{16});
+
+	std::jthread server_thread{[&registry](std::stop_token stop){
+		registry.process_events(stop);
+	}};
+
+	auto socket = west::io::connect_to(address, port);
+	std::string_view const request{"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"GET / HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"};
+	REQUIRE_EQ(::write(socket.get(), std::data(request), std::size(request)), std::ssize(request));
+
+	std::string response;
+	std::array<char, 65536> buffer{};
+	while(true)
+	{
+		auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+		REQUIRE_EQ(n >= 0, true);
+		if(n == 0)
+		{ break; }
+		response.append(std::data(buffer), static_cast<size_t>(n));
+	}
+
+	server_thread.request_stop();
+	server_thread.join();
+
+	using west::http::request_state_index;
+	EXPECT_EQ(metrics->request_duration_ns.count(), 3);
+
+	auto const& header = metrics->states[request_state_index<west::http::read_request_header>];
+	EXPECT_EQ(header.duration_ns.count(), 3);
+	EXPECT_GT(header.duration_ns.max(), 0);
+
+	// All data arrives in one read, which is made while reading the first request header
+	EXPECT_EQ(header.bytes.max(), std::size(request));
+	EXPECT_EQ(header.bytes.min(), 0);
+
+	auto const& response_header = metrics->states[request_state_index<west::http::write_response_header>];
+	EXPECT_EQ(response_header.duration_ns.count(), 3);
+	EXPECT_GE(response_header.socket_calls.min(), 1);
+
+	// The request body states are left three times, but the interim response is always skipped
+	EXPECT_EQ(metrics->states[request_state_index<west::http::read_request_body>].duration_ns.count(), 3);
+	EXPECT_EQ(metrics->states[request_state_index<west::http::write_interim_response>].duration_ns.count(), 0);
+	EXPECT_EQ(metrics->states[request_state_index<west::http::wait_for_data>].duration_ns.count(), 2);
+}
+
+TESTCASE(west_http_server_waiting_request_handler)
+{
+	for(auto const mode : {west::io::trigger_mode::level, west::io::trigger_mode::edge})
+	{
+		west::io::inet_address address{"127.0.0.1"};
+		west::io::inet_server_socket server_socket{
+			address,
+			std::ranges::iota_view{49152, 65536},
+			128
+		};
+		auto const port = server_socket.port();
+
+		auto const wait = std::chrono::milliseconds{200};
+		std::atomic<size_t> calls{0};
+		west::service_registry registry{};
+		registry.connection_trigger_mode(mode);
+		enroll_http_service<delayed_response>(registry, std::move(server_socket), wait, &calls);
+
+		std::jthread server_thread{[&registry](std::stop_token stop){
+			registry.process_events(stop);
+		}};
+
+		auto socket = west::io::connect_to(address, port);
+		std::string_view const request{"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"};
+		REQUIRE_EQ(::write(socket.get(), std::data(request), std::size(request)), std::ssize(request));
+
+		std::string response;
+		std::array<char, 4096> buffer{};
+		while(!response.ends_with("\r\n0\r\n\r\n"))
+		{
+			auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+			REQUIRE_EQ(n > 0, true);
+			response.append(std::data(buffer), static_cast<size_t>(n));
+		}
+		EXPECT_EQ(response.ends_with("5\r\nHello\r\n0\r\n\r\n"), true);
+
+		// NOTE: The request handler is asked about once per poll interval while it waits, rather
+		//       than every time the event loop finds the socket writable
+		auto const polls = wait/west::http::timeout_policy{}.request_handler_poll_interval;
+		EXPECT_GE(calls.load(), 2);
+		EXPECT_LE(calls.load(), static_cast<size_t>(polls) + 8);
+
+		server_thread.request_stop();
+	}
+}
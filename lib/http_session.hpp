@@ -6,6 +6,7 @@
 #include "./io_interfaces.hpp"
 #include "./utils.hpp"
 
+#include <limits>
 #include <memory>
 
 namespace west::http
@@ -15,6 +16,7 @@ namespace west::http
 		completed,
 		connection_closed,
 		more_data_needed,
+		request_handler_would_block,
 		client_error_detected,
 		write_response_failed,
 		io_error
@@ -24,11 +26,29 @@ namespace west::http
 	{
 		request_header header;
 		size_t content_length{0};
+
+		// If true, the request body uses chunked transfer-encoding, and content_length is not used
+		bool body_is_chunked{false};
+
+		// If false, the connection is closed after the response
+		bool keep_alive{true};
+
+		// Maximum size of the request body
+		size_t max_body_size{std::numeric_limits<size_t>::max()};
+
+		// If true, the client waits for "100 Continue" before it sends the request body
+		bool expects_continue{false};
 	};
 
 	struct response_info
 	{
 		response_header header;
+
+		// Number of body bytes that were written together with the header
+		size_t body_bytes_sent{0};
+
+		// If true, the body is sent without framing, and ends when the connection is closed
+		bool body_ends_at_close{false};
 	};
 
 	template<class Socket, class RequestHandler>
@@ -0,0 +1,98 @@
+#ifndef WEST_HTTP_SESSION_COUNTERS_HPP
+#define WEST_HTTP_SESSION_COUNTERS_HPP
+
+#include "./http_instrumentation.hpp"
+#include "./per_loop_shared.hpp"
+
+#include <array>
+#include <memory>
+
+namespace west::http
+{
+	inline constexpr size_t req_header_parser_error_code_count =
+		static_cast<size_t>(req_header_parser_error_code::bad_field_value) + 1;
+
+	// NOTE: Not thread-safe. Use one instance per event loop, and only read it from that loop.
+	struct session_counters
+	{
+		// Number of live sessions in each state. Indexed like request_state_holder. See
+		// request_state_names.
+		std::array<size_t, request_state_count> sessions_in_state{};
+
+		size_t bytes_read{0};
+		size_t bytes_written{0};
+		size_t requests_completed{0};
+
+		// Number of rejected request headers, indexed by req_header_parser_error_code
+		std::array<size_t, req_header_parser_error_code_count> header_errors{};
+
+		size_t open_sessions() const
+		{
+			size_t ret = 0;
+			for(auto item : sessions_in_state)
+			{ ret += item; }
+			return ret;
+		}
+	};
+
+	// NOTE: Unlike request_metrics_recorder, this recorder does not look at the clock, so it can be
+	//       left enabled in production
+	class session_counters_recorder
+	{
+	public:
+		static constexpr bool enabled = true;
+
+		explicit session_counters_recorder(std::shared_ptr<session_counters> counters):
+			m_counters{std::move(counters)},
+			m_state_index{request_state_index<read_request_header>}
+		{ ++m_counters->sessions_in_state[m_state_index]; }
+
+		session_counters_recorder(session_counters_recorder&&) = default;
+		session_counters_recorder& operator=(session_counters_recorder&&) = delete;
+
+		~session_counters_recorder()
+		{
+			if(m_counters != nullptr)
+			{ --m_counters->sessions_in_state[m_state_index]; }
+		}
+
+		void state_completed(size_t, io::io_counters const& io)
+		{
+			m_counters->bytes_read += io.bytes_read;
+			m_counters->bytes_written += io.bytes_written;
+		}
+
+		void state_entered(size_t state_index)
+		{
+			--m_counters->sessions_in_state[m_state_index];
+			++m_counters->sessions_in_state[state_index];
+			m_state_index = state_index;
+		}
+
+		void header_rejected(req_header_parser_error_code ec)
+		{ ++m_counters->header_errors[static_cast<size_t>(ec)]; }
+
+		void request_started()
+		{ }
+
+		void request_completed()
+		{ ++m_counters->requests_completed; }
+
+	private:
+		std::shared_ptr<session_counters> m_counters;
+		size_t m_state_index;
+	};
+
+	// NOTE: An instrumentation policy for session_factory, that records into session_counters. A
+	//       copy records into new counters. See per_loop_shared.
+	class session_counters_handle:public per_loop_shared<session_counters>
+	{
+	public:
+		using per_loop_shared::per_loop_shared;
+
+		session_counters_recorder create_recorder() const
+		{ return session_counters_recorder{get()}; }
+	};
+}
+
+#endif
@@ -0,0 +1,61 @@
+//@	{"target":{"name":"http_session_counters.test"}}
+
+#include "./http_session_counters.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+static_assert(west::http::request_recorder<west::http::session_counters_recorder>);
+
+TESTCASE(west_http_session_counters_recorder)
+{
+	using namespace west::http;
+	auto const counters = std::make_shared<session_counters>();
+	session_counters_handle handle{counters};
+
+	{
+		auto recorder = handle.create_recorder();
+		EXPECT_EQ(counters->sessions_in_state[request_state_index<read_request_header>], 1);
+		EXPECT_EQ(counters->open_sessions(), 1);
+
+		recorder.state_completed(request_state_index<read_request_header>, west::io::io_counters{
+			.read_calls = 2,
+			.write_calls = 0,
+			.bytes_read = 300,
+			.bytes_written = 0
+		});
+		recorder.state_entered(request_state_index<write_response_header>);
+		EXPECT_EQ(counters->sessions_in_state[request_state_index<read_request_header>], 0);
+		EXPECT_EQ(counters->sessions_in_state[request_state_index<write_response_header>], 1);
+
+		recorder.state_completed(request_state_index<write_response_header>, west::io::io_counters{
+			.read_calls = 0,
+			.write_calls = 1,
+			.bytes_read = 0,
+			.bytes_written = 40
+		});
+		recorder.request_completed();
+		recorder.header_rejected(req_header_parser_error_code::bad_field_name);
+
+		// A moved-from recorder is not counted as a session
+		auto other = std::move(recorder);
+		EXPECT_EQ(counters->open_sessions(), 1);
+	}
+
+	EXPECT_EQ(counters->open_sessions(), 0);
+	EXPECT_EQ(counters->bytes_read, 300);
+	EXPECT_EQ(counters->bytes_written, 40);
+	EXPECT_EQ(counters->requests_completed, 1);
+	EXPECT_EQ(counters->header_errors[static_cast<size_t>(req_header_parser_error_code::bad_field_name)], 1);
+	EXPECT_EQ(counters->header_errors[static_cast<size_t>(req_header_parser_error_code::bad_field_value)], 0);
+}
+
+TESTCASE(west_http_session_counters_handle_copy_gets_new_counters)
+{
+	west::http::session_counters_handle a;
+	auto const b = a;
+	EXPECT_NE(a.get(), b.get());
+
+	auto const ptr = a.get();
+	auto const c = std::move(a);
+	EXPECT_EQ(c.get(), ptr);
+}
@@ -5,15 +5,24 @@
 
 namespace west::http
 {
-	template<request_handler RequestHandler>
+	template<request_handler RequestHandler, class Instrumentation = no_instrumentation>
 	struct session_factory
 	{
+		timeout_policy timeouts{};
+		buffer_pool_handle<session_buffer> buffers{};
+		request_processor_limits limits{};
+		[[no_unique_address]] Instrumentation instrumentation{};
+
 		template<io::socket Socket, class... SessionArgs>
 		auto create_session(Socket&& socket, SessionArgs&&... session_args)
 		{
 			return request_processor{
 				std::forward<Socket>(socket),
-				RequestHandler{std::forward<SessionArgs>(session_args)...}
+				RequestHandler{std::forward<SessionArgs>(session_args)...},
+				timeouts,
+				buffers.get(),
+				limits,
+				instrumentation.create_recorder()
 			};
 		}
 	};
@@ -0,0 +1,112 @@
+#ifndef WEST_HTTP_TIMEOUT_POLICY_HPP
+#define WEST_HTTP_TIMEOUT_POLICY_HPP
+
+#include "./http_request_state_transitions.hpp"
+#include "./io_interfaces.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <variant>
+
+namespace west::http
+{
+	struct timeout_policy
+	{
+		// Time allowed for the complete request header. Sending the header slowly does not extend it.
+		std::chrono::milliseconds read_request_header{10000};
+
+		// Time allowed for the complete request body is read_request_body plus the time it takes to
+		// transfer the body at min_request_body_rate bytes per second. If min_request_body_rate is
+		// zero, read_request_body is the maximum time between two reads.
+		std::chrono::milliseconds read_request_body{5000};
+		size_t min_request_body_rate{1024};
+
+		// Maximum time the client may block the response
+		std::chrono::milliseconds write_response{20000};
+
+		// Time to wait before a request handler that would block is asked for more response data
+		std::chrono::milliseconds request_handler_poll_interval{10};
+
+		// Maximum time between two requests on the same connection
+		std::chrono::milliseconds keep_alive{5000};
+	};
+
+	template<class T>
+	struct select_timeout{};
+
+	template<>
+	struct select_timeout<read_request_header>
+	{
+		static constexpr auto get(timeout_policy const& policy, request_info const&)
+		{ return io::fd_timeout{policy.read_request_header, io::timeout_mode::fixed_deadline}; }
+	};
+
+	template<>
+	struct select_timeout<write_interim_response>
+	{
+		static constexpr auto get(timeout_policy const& policy, request_info const&)
+		{ return io::fd_timeout{policy.write_response, io::timeout_mode::restart_on_activity}; }
+	};
+
+	template<>
+	struct select_timeout<read_request_body>
+	{
+		static constexpr auto get(timeout_policy const& policy, request_info const& request)
+		{
+			if(policy.min_request_body_rate == 0)
+			{ return io::fd_timeout{policy.read_request_body, io::timeout_mode::restart_on_activity}; }
+
+			constexpr auto max_ms = static_cast<size_t>(std::numeric_limits<int32_t>::max());
+			auto const transfer_time = request.content_length <= max_ms/1000?
+				request.content_length*1000/policy.min_request_body_rate:
+				std::min(request.content_length/policy.min_request_body_rate, max_ms/1000)*1000;
+
+			return io::fd_timeout{
+				policy.read_request_body
+					+ std::chrono::milliseconds{static_cast<int64_t>(std::min(transfer_time, max_ms))},
+				io::timeout_mode::fixed_deadline
+			};
+		}
+	};
+
+	// NOTE: The size of a chunked body is not known, so the timeout is restarted on activity
+	template<>
+	struct select_timeout<read_request_chunked_body>
+	{
+		static constexpr auto get(timeout_policy const& policy, request_info const&)
+		{ return io::fd_timeout{policy.read_request_body, io::timeout_mode::restart_on_activity}; }
+	};
+
+	template<>
+	struct select_timeout<write_response_header>
+	{
+		static constexpr auto get(timeout_policy const& policy, request_info const&)
+		{ return io::fd_timeout{policy.write_response, io::timeout_mode::restart_on_activity}; }
+	};
+
+	template<>
+	struct select_timeout<write_response_body>
+	{
+		static constexpr auto get(timeout_policy const& policy, request_info const&)
+		{ return io::fd_timeout{policy.write_response, io::timeout_mode::restart_on_activity}; }
+	};
+
+	template<>
+	struct select_timeout<wait_for_data>
+	{
+		static constexpr auto get(timeout_policy const& policy, request_info const&)
+		{ return io::fd_timeout{policy.keep_alive, io::timeout_mode::restart_on_activity}; }
+	};
+
+	inline auto select_timeout_for(request_state_holder const& state,
+		timeout_policy const& policy,
+		request_info const& request)
+	{
+		return std::visit([&policy, &request]<class T>(T const&) {
+			return select_timeout<T>::get(policy, request);
+		}, state);
+	}
+}
+
+#endif
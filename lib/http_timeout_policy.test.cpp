@@ -0,0 +1,52 @@
+//@	{"target":{"name":"http_timeout_policy.test"}}
+
+#include "./http_timeout_policy.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+TESTCASE(west_http_timeout_policy_select_timeout)
+{
+	west::http::timeout_policy const policy{
+		.read_request_header = std::chrono::milliseconds{1000},
+		.read_request_body = std::chrono::milliseconds{2000},
+		.min_request_body_rate = 1000,
+		.write_response = std::chrono::milliseconds{3000},
+		.keep_alive = std::chrono::milliseconds{4000}
+	};
+
+	west::http::request_info request{};
+	request.content_length = 5000;
+
+	EXPECT_EQ(select_timeout_for(west::http::read_request_header{}, policy, request),
+		(west::io::fd_timeout{std::chrono::milliseconds{1000}, west::io::timeout_mode::fixed_deadline}));
+
+	EXPECT_EQ(select_timeout_for(west::http::read_request_body{5000}, policy, request),
+		(west::io::fd_timeout{std::chrono::milliseconds{7000}, west::io::timeout_mode::fixed_deadline}));
+
+	EXPECT_EQ(select_timeout_for(west::http::write_response_body{0}, policy, request),
+		(west::io::fd_timeout{std::chrono::milliseconds{3000}, west::io::timeout_mode::restart_on_activity}));
+
+	EXPECT_EQ(select_timeout_for(west::http::wait_for_data{}, policy, request),
+		(west::io::fd_timeout{std::chrono::milliseconds{4000}, west::io::timeout_mode::restart_on_activity}));
+}
+
+TESTCASE(west_http_timeout_policy_select_timeout_request_body)
+{
+	west::http::timeout_policy policy{};
+	policy.read_request_body = std::chrono::milliseconds{100};
+	west::http::request_info request{};
+
+	request.content_length = 0;
+	EXPECT_EQ(select_timeout_for(west::http::read_request_body{0}, policy, request).duration,
+		std::chrono::milliseconds{100});
+
+	// Huge bodies must not overflow
+	request.content_length = std::numeric_limits<size_t>::max();
+	auto const res = select_timeout_for(west::http::read_request_body{0}, policy, request);
+	EXPECT_GT(res.duration, std::chrono::milliseconds{100});
+
+	// Without a minimum rate, the timeout is restarted on every read
+	policy.min_request_body_rate = 0;
+	EXPECT_EQ(select_timeout_for(west::http::read_request_body{0}, policy, request),
+		(west::io::fd_timeout{std::chrono::milliseconds{100}, west::io::timeout_mode::restart_on_activity}));
+}
@@ -0,0 +1,53 @@
+#ifndef WEST_HTTP_WRITE_INTERIM_RESPONSE_HPP
+#define WEST_HTTP_WRITE_INTERIM_RESPONSE_HPP
+
+#include "./io_interfaces.hpp"
+#include "./io_adapter.hpp"
+#include "./http_request_handler.hpp"
+#include "./http_session.hpp"
+
+#include <string_view>
+
+namespace west::http
+{
+	// NOTE: Tells a client that sent "Expect: 100-continue" that it may send the request body. The
+	//       state is only entered after the request handler has accepted the request header. If the
+	//       header is rejected, the final response is sent instead, and the body is never sent.
+	class write_interim_response
+	{
+	public:
+		static constexpr std::string_view continue_response{"HTTP/1.1 100 Continue\r\n\r\n"};
+
+		template<io::data_sink Sink, class RequestHandler, size_t BufferSize>
+		[[nodiscard]] session_state_response socket_is_ready(io_adapter::buffer_span<char, BufferSize>& buffer,
+			session<Sink, RequestHandler>& session);
+
+	private:
+		std::string_view m_bytes_left{continue_response};
+	};
+}
+
+template<west::io::data_sink Sink, class RequestHandler, size_t BufferSize>
+[[nodiscard]] west::http::session_state_response west::http::write_interim_response::socket_is_ready(
+	io_adapter::buffer_span<char, BufferSize>&,
+	session<Sink, RequestHandler>& session)
+{
+	while(!std::empty(m_bytes_left))
+	{
+		auto const res = session.connection.write(m_bytes_left);
+		m_bytes_left.remove_prefix(res.bytes_written);
+
+		if(is_error_indicator(res.ec) || res.bytes_written == 0)
+		{ return make_write_response(res.ec); }
+	}
+
+	return session_state_response{
+		.status = session_state_status::completed,
+		.state_result = finalize_state_result {
+			.http_status = status::ok,
+			.error_message = nullptr
+		}
+	};
+}
+
+#endif
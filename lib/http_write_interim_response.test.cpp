@@ -0,0 +1,87 @@
+//@	{"target":{"name":"http_write_interim_response.test"}}
+
+#include "./http_write_interim_response.hpp"
+
+#include <testfwk/testfwk.hpp>
+#include <functional>
+
+namespace
+{
+	// Writes at most 7 bytes per call, and blocks every other call
+	struct data_sink
+	{
+		std::reference_wrapper<std::string> m_output_buffer;
+		west::io::operation_result res{west::io::operation_result::completed};
+		size_t calls_to_write{0};
+
+		auto write(std::span<char const> buffer)
+		{
+			++calls_to_write;
+			if(res != west::io::operation_result::completed || calls_to_write % 2 == 0)
+			{
+				return west::io::write_result{
+					0,
+					res == west::io::operation_result::completed? west::io::operation_result::operation_would_block : res
+				};
+			}
+
+			auto const bytes_to_write = std::min(std::size(buffer), static_cast<size_t>(7));
+			std::copy_n(std::begin(buffer), bytes_to_write, std::back_inserter(m_output_buffer.get()));
+			return west::io::write_result{
+				bytes_to_write,
+				west::io::operation_result::completed
+			};
+		}
+	};
+
+	struct request_handler
+	{};
+}
+
+TESTCASE(west_http_write_interim_response_write_completed)
+{
+	std::array<char, 4096> buffer;
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	std::string output_buffer;
+	west::http::session session{data_sink{output_buffer},
+		request_handler{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_interim_response writer{};
+	size_t calls = 0;
+	while(true)
+	{
+		auto const res = writer.socket_is_ready(buff_span, session);
+		++calls;
+		if(res.status == west::http::session_state_status::completed)
+		{ break; }
+		EXPECT_EQ(res.status, west::http::session_state_status::more_data_needed);
+	}
+
+	EXPECT_EQ(output_buffer, "HTTP/1.1 100 Continue\r\n\r\n");
+	EXPECT_EQ(calls, 4);
+
+	// The send buffer is not used
+	EXPECT_EQ(std::size(buff_span.span_to_read()), 0);
+}
+
+TESTCASE(west_http_write_interim_response_write_error)
+{
+	std::array<char, 4096> buffer;
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	std::string output_buffer;
+	west::http::session session{data_sink{output_buffer, west::io::operation_result::error},
+		request_handler{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_interim_response writer{};
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::io_error);
+	EXPECT_EQ(output_buffer, "");
+}
@@ -6,13 +6,55 @@
 #include "./http_request_handler.hpp"
 #include "./http_session.hpp"
 
+#include <algorithm>
+#include <optional>
+#include <string_view>
+
 namespace west::http
 {
+	struct chunked_body
+	{};
+
+	// NOTE: The body is sent without framing, and the connection is closed after it. This is how an
+	//       HTTP/1.0 client receives a body that would otherwise be chunked.
+	struct body_until_close
+	{};
+
+	// NOTE: With chunked_body, the body is read from the request handler until it returns no data
+	//       with an error code for which can_continue is true, and indicates_would_block is false.
+	//       Each time the send buffer is empty, it is filled with one chunk, and the chunk header
+	//       and trailing CRLF are written directly around the data. A chunk is sent as soon as the
+	//       request handler returns less data than requested, so data produced bit by bit is not
+	//       held back. The last chunk is appended to the same buffer, if there is room for it.
+	//
+	//       If the request handler has no data yet, and indicates_would_block is true,
+	//       request_handler_would_block is returned. The session then waits for the request
+	//       handler rather than for the socket, which is writable.
 	class write_response_body
 	{
 	public:
 		explicit write_response_body(size_t bytes_to_write):
-			m_bytes_to_write{bytes_to_write}
+			m_bytes_to_write{bytes_to_write},
+			m_file_bytes_sent{0},
+			m_framing{body_framing::content_length},
+			m_last_chunk_is_buffered{false},
+			m_body_has_ended{false}
+		{ }
+
+		explicit write_response_body(chunked_body):
+			m_bytes_to_write{0},
+			m_file_bytes_sent{0},
+			m_framing{body_framing::chunked},
+			m_last_chunk_is_buffered{false},
+			m_body_has_ended{false}
+		{ }
+
+		explicit write_response_body(body_until_close):
+			m_bytes_to_write{0},
+			m_file_bytes_sent{0},
+			m_framing{body_framing::until_close},
+			m_last_chunk_is_buffered{false},
+			m_body_has_ended{false}
 		{ }
 
 		template<io::data_sink Source, class RequestHandler, size_t BufferSize>
@@ -20,7 +62,261 @@ namespace west::http
 			session<Source, RequestHandler>& session);
 
 	private:
+		template<io::file_sink Sink>
+		[[nodiscard]] session_state_response write_file(io::file_range file, Sink& dest);
+
+		template<io::data_sink Sink, class RequestHandler, size_t BufferSize>
+		[[nodiscard]] session_state_response write_chunked(io_adapter::buffer_span<char, BufferSize>& buffer,
+			session<Sink, RequestHandler>& session);
+
+		template<class RequestHandler, size_t BufferSize>
+		[[nodiscard]] std::optional<session_state_response> fill_chunk(io_adapter::buffer_span<char, BufferSize>& buffer,
+			RequestHandler& req_handler);
+
+		template<io::data_sink Sink, class RequestHandler, size_t BufferSize>
+		[[nodiscard]] session_state_response write_until_close(io_adapter::buffer_span<char, BufferSize>& buffer,
+			session<Sink, RequestHandler>& session);
+
+		enum class body_framing{content_length, chunked, until_close};
+
 		size_t m_bytes_to_write;
+		size_t m_file_bytes_sent;
+		body_framing m_framing;
+		bool m_last_chunk_is_buffered;
+		bool m_body_has_ended;
+	};
+
+	namespace detail
+	{
+		constexpr size_t hex_digit_count(size_t value)
+		{
+			size_t ret = 1;
+			while(value >= 16)
+			{
+				value /= 16;
+				++ret;
+			}
+			return ret;
+		}
+	}
+}
+
+template<class RequestHandler, size_t BufferSize>
+std::optional<west::http::session_state_response>
+west::http::write_response_body::fill_chunk(io_adapter::buffer_span<char, BufferSize>& buffer,
+	RequestHandler& req_handler)
+{
+	// NOTE: The chunk size is written with a fixed number of digits, so the data can be read
+	//       directly to its final position. Leading zeros are allowed in a chunk size.
+	static constexpr size_t size_digits = detail::hex_digit_count(BufferSize);
+	static constexpr size_t chunk_header_size = size_digits + 2;
+	static constexpr std::string_view last_chunk{"0\r\n\r\n"};
+	static constexpr size_t chunk_trailer_size = 2 + std::size(last_chunk);
+	static_assert(BufferSize > chunk_header_size + chunk_trailer_size);
+
+	auto const output = buffer.span_to_write();
+	auto const data = output.subspan(chunk_header_size,
+		std::size(output) - chunk_header_size - chunk_trailer_size);
+
+	// NOTE: After a short read, the request handler is asked once more. If the body has ended, the
+	//       last chunk is then sent together with the data.
+	size_t data_size = 0;
+	bool short_read = false;
+	while(data_size != std::size(data))
+	{
+		auto const bytes_requested = std::size(data) - data_size;
+		auto const res = req_handler.read_response_content(data.subspan(data_size));
+		if(!can_continue(res.ec))
+		{
+			return session_state_response{
+				.status = session_state_status::write_response_failed,
+				.state_result = finalize_state_result {
+					.http_status = status::internal_server_error,
+					.error_message = make_unique_cstr(to_string(res.ec))
+				}
+			};
+		}
+
+		if(res.bytes_read == 0)
+		{
+			m_last_chunk_is_buffered = !indicates_would_block(res.ec);
+			break;
+		}
+		data_size += res.bytes_read;
+
+		if(res.bytes_read < bytes_requested)
+		{
+			if(short_read)
+			{ break; }
+			short_read = true;
+		}
+	}
+
+	if(data_size == 0)
+	{
+		if(!m_last_chunk_is_buffered)
+		{
+			return session_state_response{
+				.status = session_state_status::request_handler_would_block,
+				.state_result = finalize_state_result {
+					.http_status = status::ok,
+					.error_message = nullptr
+				}
+			};
+		}
+
+		std::ranges::copy(last_chunk, std::begin(output));
+		buffer.reset_with_new_length(std::size(last_chunk));
+		return std::nullopt;
+	}
+
+	auto size_ptr = std::data(output) + size_digits;
+	for(auto value = data_size; size_ptr != std::data(output); value /= 16)
+	{
+		--size_ptr;
+		*size_ptr = "0123456789abcdef"[value % 16];
+	}
+	output[size_digits] = '\r';
+	output[size_digits + 1] = '\n';
+
+	auto ptr = std::data(data) + data_size;
+	*ptr++ = '\r';
+	*ptr++ = '\n';
+	if(m_last_chunk_is_buffered)
+	{ ptr = std::ranges::copy(last_chunk, ptr).out; }
+
+	buffer.reset_with_new_length(static_cast<size_t>(ptr - std::data(output)));
+	return std::nullopt;
+}
+
+template<west::io::data_sink Sink, class RequestHandler, size_t BufferSize>
+west::http::session_state_response west::http::write_response_body::write_chunked(
+	io_adapter::buffer_span<char, BufferSize>& buffer,
+	session<Sink, RequestHandler>& session)
+{
+	while(true)
+	{
+		if(std::size(buffer.span_to_read()) == 0)
+		{
+			if(m_last_chunk_is_buffered)
+			{
+				return session_state_response{
+					.status = session_state_status::completed,
+					.state_result = finalize_state_result {
+						.http_status = status::ok,
+						.error_message = nullptr
+					}
+				};
+			}
+
+			if(auto res = fill_chunk(buffer, session.request_handler); res.has_value())
+			{ return std::move(*res); }
+		}
+
+		auto const res = session.connection.write(buffer.span_to_read());
+		buffer.consume_elements(res.bytes_written);
+
+		if(is_error_indicator(res.ec) || res.bytes_written == 0)
+		{ return make_write_response(res.ec); }
+	}
+}
+
+template<west::io::data_sink Sink, class RequestHandler, size_t BufferSize>
+west::http::session_state_response west::http::write_response_body::write_until_close(
+	io_adapter::buffer_span<char, BufferSize>& buffer,
+	session<Sink, RequestHandler>& session)
+{
+	while(true)
+	{
+		if(std::size(buffer.span_to_read()) == 0)
+		{
+			if(m_body_has_ended)
+			{
+				return session_state_response{
+					.status = session_state_status::completed,
+					.state_result = finalize_state_result {
+						.http_status = status::ok,
+						.error_message = nullptr
+					}
+				};
+			}
+
+			auto const res = session.request_handler.read_response_content(buffer.span_to_write());
+			if(!can_continue(res.ec))
+			{
+				return session_state_response{
+					.status = session_state_status::write_response_failed,
+					.state_result = finalize_state_result {
+						.http_status = status::internal_server_error,
+						.error_message = make_unique_cstr(to_string(res.ec))
+					}
+				};
+			}
+
+			buffer.reset_with_new_length(res.bytes_read);
+			if(res.bytes_read == 0)
+			{
+				if(indicates_would_block(res.ec))
+				{
+					return session_state_response{
+						.status = session_state_status::request_handler_would_block,
+						.state_result = finalize_state_result {
+							.http_status = status::ok,
+							.error_message = nullptr
+						}
+					};
+				}
+				m_body_has_ended = true;
+				continue;
+			}
+		}
+
+		auto const res = session.connection.write(buffer.span_to_read());
+		buffer.consume_elements(res.bytes_written);
+
+		if(is_error_indicator(res.ec) || res.bytes_written == 0)
+		{ return make_write_response(res.ec); }
+	}
+}
+
+template<west::io::file_sink Sink>
+west::http::session_state_response west::http::write_response_body::write_file(io::file_range file,
+	Sink& dest)
+{
+	while(m_bytes_to_write != 0)
+	{
+		auto const bytes_left_in_file = file.length - std::min(file.length, m_file_bytes_sent);
+		auto const res = bytes_left_in_file == 0?
+			io::write_result{0, io::operation_result::completed} :
+			dest.send_file(io::file_range{
+				.fd = file.fd,
+				.offset = file.offset + static_cast<off_t>(m_file_bytes_sent),
+				.length = std::min(bytes_left_in_file, m_bytes_to_write)
+			});
+		m_file_bytes_sent += res.bytes_written;
+		m_bytes_to_write -= res.bytes_written;
+
+		if(is_error_indicator(res.ec))
+		{ return make_write_response(res.ec); }
+
+		if(res.bytes_written == 0)
+		{
+			return session_state_response{
+				.status = session_state_status::write_response_failed,
+				.state_result = finalize_state_result {
+					.http_status = status::internal_server_error,
+					.error_message = make_unique_cstr("Response body file is shorter than the response body")
+				}
+			};
+		}
+	}
+
+	return session_state_response{
+		.status = session_state_status::completed,
+		.state_result = finalize_state_result {
+			.http_status = status::ok,
+			.error_message = nullptr
+		}
 	};
 }
 
@@ -29,6 +325,28 @@ template<west::io::data_sink Sink, class RequestHandler, size_t BufferSize>
 	io_adapter::buffer_span<char, BufferSize>& buffer,
 	session<Sink, RequestHandler>& session)
 {
+	switch(m_framing)
+	{
+		case body_framing::chunked:
+			return write_chunked(buffer, session);
+
+		case body_framing::until_close:
+			return write_until_close(buffer, session);
+
+		case body_framing::content_length:
+			break;
+	}
+
+	if constexpr(io::file_sink<Sink>)
+	{
+		if(auto const file = get_response_body_file<RequestHandler, Sink>(session.request_handler); file.has_value())
+		{
+			// NOTE: write_response_header does not put any body bytes in the buffer in this case
+			assert(std::size(buffer.span_to_read()) == 0);
+			return write_file(*file, session.connection);
+		}
+	}
+
 	return transfer_data(
 		[&req_handler = session.request_handler](std::span<char> buffer){
 			return req_handler.read_response_content(buffer);
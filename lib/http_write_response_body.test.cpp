@@ -1,9 +1,15 @@
 //@	{"target":{"name":"http_writer_response_body.test"}}
 
 #include "./http_write_response_body.hpp"
+#include "./io_fd.hpp"
 
 #include <testfwk/testfwk.hpp>
 
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <vector>
+
 namespace
 {
 	struct sink
@@ -73,6 +79,9 @@ namespace
 		}
 	}
 
+	constexpr bool is_would_block(error_code ec)
+	{ return ec == error_code::would_block; }
+
 	constexpr char const* to_string(error_code ec)
 	{
 		switch(ec)
@@ -133,6 +142,53 @@ namespace
 			};
 		};
 	};
+
+	struct file_sink
+	{
+		west::io::write_result write(std::span<char const> buffer)
+		{
+			++calls_to_write;
+			output.insert(std::end(output), std::begin(buffer), std::end(buffer));
+			return west::io::write_result{std::size(buffer), west::io::operation_result::completed};
+		}
+
+		west::io::write_result send_file(west::io::file_range range)
+		{
+			++calls_to_send_file;
+			if(calls_to_send_file % 3 == 0)
+			{ return west::io::write_result{0, west::io::operation_result::operation_would_block}; }
+
+			std::array<char, 17> buffer{};
+			auto const n = ::pread(range.fd, std::data(buffer), std::min(std::size(buffer), range.length), range.offset);
+			REQUIRE_EQ(n >= 0, true);
+			output.append(std::data(buffer), static_cast<size_t>(n));
+			return west::io::write_result{static_cast<size_t>(n), west::io::operation_result::completed};
+		}
+
+		std::string output;
+		size_t calls_to_write{0};
+		size_t calls_to_send_file{0};
+	};
+
+	struct file_request_handler
+	{
+		explicit file_request_handler(std::string_view content):
+			file{west::io::fd_ref{::memfd_create("response_body", 0)}},
+			length{std::size(content)}
+		{
+			REQUIRE_EQ(::write(file.get(), std::data(content), std::size(content)),
+				static_cast<ssize_t>(std::size(content)));
+		}
+
+		std::optional<west::io::file_range> response_body_file()
+		{ return west::io::file_range{.fd = file.get(), .offset = 0, .length = length}; }
+
+		read_result read_response_content(std::span<char>)
+		{ return read_result{0, error_code::error}; }
+
+		west::io::fd_owner file;
+		size_t length;
+	};
 }
 
 TESTCASE(http_write_response_body_write_all_data)
@@ -254,4 +310,340 @@ TESTCASE(http_write_response_body_failing_request_handler)
 	EXPECT_EQ(res.status, west::http::session_state_status::write_response_failed);
 	EXPECT_EQ(res.state_result.http_status, west::http::status::internal_server_error);
 	EXPECT_EQ(res.state_result.error_message.get(), std::string_view{"Error"});
-}
\ No newline at end of file
+}
+
+TESTCASE(http_write_response_body_from_file)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	std::string_view src{
+"Etiam egestas ex laoreet tortor tristique, vitae tristique enim vehicula. Aenean mollis tristique "
+"eros nec malesuada. Suspendisse bibendum maximus erat, id volutpat enim. Phasellus at pharetra "
+};
+
+	west::http::session session{file_sink{},
+		file_request_handler{src},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{std::size(src)};
+
+	while(true)
+	{
+		auto res = writer.socket_is_ready(buff_span, session);
+		if(res.status == west::http::session_state_status::completed)
+		{ break; }
+		REQUIRE_EQ(res.status, west::http::session_state_status::more_data_needed);
+	}
+
+	EXPECT_EQ(session.connection.output, src);
+	EXPECT_EQ(session.connection.calls_to_write, 0);
+	EXPECT_GT(session.connection.calls_to_send_file, 0);
+}
+
+TESTCASE(http_write_response_body_from_file_too_short)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	std::string_view src{"A short file"};
+
+	west::http::session session{file_sink{},
+		file_request_handler{src},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{std::size(src) + 1};
+
+	while(true)
+	{
+		auto res = writer.socket_is_ready(buff_span, session);
+		if(res.status != west::http::session_state_status::more_data_needed)
+		{
+			EXPECT_EQ(res.status, west::http::session_state_status::write_response_failed);
+			EXPECT_EQ(res.state_result.http_status, west::http::status::internal_server_error);
+			break;
+		}
+	}
+	EXPECT_EQ(session.connection.output, src);
+}
+
+TESTCASE(http_write_response_body_file_is_ignored_without_file_sink)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::session session{sink{},
+		file_request_handler{"Some content"},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{12};
+	auto res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::write_response_failed);
+}
+
+namespace
+{
+	struct slow_sink
+	{
+		west::io::write_result write(std::span<char const> buffer)
+		{
+			++calls_to_write;
+			if(calls_to_write % 2 == 0)
+			{ return west::io::write_result{0, west::io::operation_result::operation_would_block}; }
+
+			auto const bytes_to_write = std::min(std::size(buffer), static_cast<size_t>(5));
+			output.insert(std::end(output), std::begin(buffer), std::begin(buffer) + bytes_to_write);
+			return west::io::write_result{bytes_to_write, west::io::operation_result::completed};
+		}
+
+		std::string output;
+		size_t calls_to_write{0};
+	};
+
+	struct piecewise_request_handler
+	{
+		read_result read_response_content(std::span<char> buffer)
+		{
+			auto const res = handler.read_response_content(buffer.first(std::min(std::size(buffer), max_piece_size)));
+			++calls;
+			return res;
+		}
+
+		request_handler handler;
+		size_t max_piece_size;
+		size_t calls{0};
+	};
+
+	std::string decode_chunked(std::string_view input)
+	{
+		std::string ret;
+		while(true)
+		{
+			auto const size_end = input.find("\r\n");
+			REQUIRE_NE(size_end, std::string_view::npos);
+			size_t size = 0;
+			for(auto item : input.substr(0, size_end))
+			{ size = 16*size + static_cast<size_t>(item >= 'a'? item - 'a' + 10 : item - '0'); }
+			input.remove_prefix(size_end + 2);
+			if(size == 0)
+			{
+				EXPECT_EQ(input, "\r\n");
+				return ret;
+			}
+			ret.append(input.substr(0, size));
+			EXPECT_EQ(input.substr(size, 2), "\r\n");
+			input.remove_prefix(size + 2);
+		}
+	}
+}
+
+TESTCASE(http_write_response_body_chunked)
+{
+	std::array<char, 64> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	std::string_view src{
+"Etiam egestas ex laoreet tortor tristique, vitae tristique enim vehicula. Aenean mollis tristique "
+"eros nec malesuada. Suspendisse bibendum maximus erat, id volutpat enim. Phasellus at pharetra "
+};
+
+	west::http::session session{slow_sink{},
+		piecewise_request_handler{request_handler{src}, 7},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{west::http::chunked_body{}};
+
+	while(true)
+	{
+		auto res = writer.socket_is_ready(buff_span, session);
+		if(res.status == west::http::session_state_status::completed)
+		{ break; }
+		REQUIRE_EQ(res.status, west::http::session_state_status::more_data_needed);
+	}
+
+	// A chunk is sent after the second short read
+	auto const& output = session.connection.output;
+	EXPECT_EQ(output.substr(0, 4), "0e\r\n");
+	EXPECT_EQ(output.ends_with("\r\n0\r\n\r\n"), true);
+	EXPECT_EQ(decode_chunked(output), src);
+}
+
+namespace
+{
+	// Produces the pieces of a body one at a time, and would block between them
+	struct streaming_request_handler
+	{
+		read_result read_response_content(std::span<char> buffer)
+		{
+			if(data_available)
+			{
+				data_available = false;
+				if(pieces.empty())
+				{ return read_result{0, error_code::no_error}; }
+
+				auto const piece = pieces.front();
+				pieces.erase(std::begin(pieces));
+				EXPECT_GE(std::size(buffer), std::size(piece));
+				std::ranges::copy(piece, std::begin(buffer));
+				return read_result{std::size(piece), error_code::no_error};
+			}
+			return read_result{0, error_code::would_block};
+		}
+
+		std::vector<std::string_view> pieces;
+		bool data_available{false};
+	};
+}
+
+TESTCASE(http_write_response_body_chunked_streaming_request_handler)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::session session{file_sink{},
+		streaming_request_handler{{"Hello", ", ", "World"}},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{west::http::chunked_body{}};
+
+	// Without data, the writer waits instead of ending the body
+	auto res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::request_handler_would_block);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::ok);
+	EXPECT_EQ(session.connection.output, "");
+
+	// Each piece is sent as soon as it is available
+	session.request_handler.data_available = true;
+	res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::request_handler_would_block);
+	EXPECT_EQ(session.connection.output, "0005\r\nHello\r\n");
+
+	session.request_handler.data_available = true;
+	res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::request_handler_would_block);
+	EXPECT_EQ(session.connection.output, "0005\r\nHello\r\n0002\r\n, \r\n");
+
+	session.request_handler.data_available = true;
+	res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::request_handler_would_block);
+
+	session.request_handler.data_available = true;
+	res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::completed);
+	EXPECT_EQ(session.connection.output, "0005\r\nHello\r\n0002\r\n, \r\n0005\r\nWorld\r\n0\r\n\r\n");
+	EXPECT_EQ(session.connection.calls_to_write, 4);
+}
+
+TESTCASE(http_write_response_body_chunked_last_chunk_in_same_write)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::session session{file_sink{},
+		request_handler{"Hello, World"},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{west::http::chunked_body{}};
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::completed);
+	EXPECT_EQ(session.connection.output, "000c\r\nHello, World\r\n0\r\n\r\n");
+	EXPECT_EQ(session.connection.calls_to_write, 1);
+}
+
+TESTCASE(http_write_response_body_chunked_empty_body)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::session session{sink{},
+		request_handler{""},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{west::http::chunked_body{}};
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::completed);
+	EXPECT_EQ(session.connection.output, "0\r\n\r\n");
+}
+
+TESTCASE(http_write_response_body_chunked_failing_request_handler)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::session session{sink{},
+		failing_request_handler{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{west::http::chunked_body{}};
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::write_response_failed);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::internal_server_error);
+	EXPECT_EQ(res.state_result.error_message.get(), std::string_view{"Error"});
+	EXPECT_EQ(session.connection.output, "");
+}
+
+TESTCASE(http_write_response_body_until_close_streaming_request_handler)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::session session{file_sink{},
+		streaming_request_handler{{"Hello", ", ", "World"}},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{west::http::body_until_close{}};
+
+	auto res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::request_handler_would_block);
+	EXPECT_EQ(session.connection.output, "");
+
+	for(size_t k = 0; k != 3; ++k)
+	{
+		session.request_handler.data_available = true;
+		res = writer.socket_is_ready(buff_span, session);
+		EXPECT_EQ(res.status, west::http::session_state_status::request_handler_would_block);
+	}
+	EXPECT_EQ(session.connection.output, "Hello, World");
+
+	session.request_handler.data_available = true;
+	res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::completed);
+	EXPECT_EQ(session.connection.output, "Hello, World");
+	EXPECT_EQ(session.connection.calls_to_write, 3);
+}
+
+TESTCASE(http_write_response_body_until_close_failing_request_handler)
+{
+	std::array<char, 4096> buffer{};
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::session session{sink{},
+		failing_request_handler{},
+		west::http::request_info{},
+		west::http::response_header{}
+	};
+
+	west::http::write_response_body writer{west::http::body_until_close{}};
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::write_response_failed);
+	EXPECT_EQ(res.state_result.http_status, west::http::status::internal_server_error);
+	EXPECT_EQ(session.connection.output, "");
+}
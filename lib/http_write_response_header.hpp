@@ -7,56 +7,94 @@
 #include "./http_session.hpp"
 #include "./http_response_header_serializer.hpp"
 
-#include <limits>
+#include <optional>
 
 namespace west::http
 {
+	// NOTE: When the last part of the header has been serialized, the rest of the send buffer is
+	//       filled with the beginning of the response body. This way, a small response is written
+	//       with a single call to write. Body bytes that are still in the buffer when the header has
+	//       been written are written by write_response_body. If reading the body fails, the error is
+	//       reported after the header has been written, as if it happened in write_response_body.
 	class write_response_header
 	{
 	public:
 		explicit write_response_header(response_header const& resp_header):
-			m_serializer{resp_header}
+			m_serializer{resp_header},
+			m_body_bytes_to_prefetch{get_content_length(resp_header.fields).value_or(0)},
+			m_header_bytes_in_buffer{0}
 		{}
 
 		template<io::data_sink Sink, class RequestHandler, size_t BufferSize>
-		[[nodiscard]] auto socket_is_ready(io_adapter::buffer_span<char, BufferSize>& buffer,
+		[[nodiscard]] session_state_response socket_is_ready(io_adapter::buffer_span<char, BufferSize>& buffer,
 			session<Sink, RequestHandler>& session);
 
 	private:
+		template<class Sink, class RequestHandler, size_t BufferSize>
+		void fill_buffer(io_adapter::buffer_span<char, BufferSize>& buffer, RequestHandler& req_handler);
+
 		response_header_serializer m_serializer;
+		size_t m_body_bytes_to_prefetch;
+		size_t m_header_bytes_in_buffer;
+		std::optional<session_state_response> m_read_body_failure;
 	};
 }
 
-template<>
-struct west::io_adapter::error_code_checker<west::http::resp_header_serializer_error_code>
+template<class Sink, class RequestHandler, size_t BufferSize>
+void west::http::write_response_header::fill_buffer(io_adapter::buffer_span<char, BufferSize>& buffer,
+	RequestHandler& req_handler)
 {
-	constexpr bool operator()(http::resp_header_serializer_error_code) const
-	{ return false; }
-};
+	assert(std::size(buffer.span_to_read()) == 0);
+	auto const output = buffer.span_to_write();
+	auto const header_end = m_serializer.serialize(output).ptr;
+	auto const header_size = static_cast<size_t>(header_end - std::data(output));
+	auto const space_left = static_cast<size_t>(std::to_address(std::end(output)) - header_end);
+
+	// NOTE: A body that is backed by a file is written by write_response_body without copying
+	if(get_response_body_file<RequestHandler, Sink>(req_handler).has_value())
+	{ m_body_bytes_to_prefetch = 0; }
+
+	size_t body_size = 0;
+	if(m_serializer.is_completed() && m_body_bytes_to_prefetch != 0 && space_left != 0)
+	{
+		auto const res = req_handler.read_response_content(
+			std::span{header_end, std::min(space_left, m_body_bytes_to_prefetch)});
+		if(can_continue(res.ec))
+		{
+			body_size = res.bytes_read;
+			m_body_bytes_to_prefetch -= body_size;
+		}
+		else
+		{
+			m_read_body_failure = session_state_response{
+				.status = session_state_status::write_response_failed,
+				.state_result = finalize_state_result {
+					.http_status = status::internal_server_error,
+					.error_message = make_unique_cstr(to_string(res.ec))
+				}
+			};
+			m_body_bytes_to_prefetch = 0;
+		}
+	}
+
+	buffer.reset_with_new_length(header_size + body_size);
+	m_header_bytes_in_buffer = header_size;
+}
 
 template<west::io::data_sink Sink, class RequestHandler, size_t BufferSize>
-[[nodiscard]] auto west::http::write_response_header::socket_is_ready(
+[[nodiscard]] west::http::session_state_response west::http::write_response_header::socket_is_ready(
 	io_adapter::buffer_span<char, BufferSize>& buffer,
 	session<Sink, RequestHandler>& session)
 {
-	auto max_length = std::numeric_limits<size_t>::max();  // No limit in how much data we can write
-	return transfer_data(
-		[this](std::span<char> buffer){
-			struct read_result
+	while(true)
+	{
+		if(m_header_bytes_in_buffer == 0)
+		{
+			if(m_serializer.is_completed())
 			{
-				size_t bytes_read;
-				resp_header_serializer_error_code ec;
-			};
+				if(m_read_body_failure.has_value())
+				{ return std::move(*m_read_body_failure); }
 
-			auto res = m_serializer.serialize(buffer);
-			return read_result{static_cast<size_t>(res.ptr - std::data(buffer)), res.ec};
-		},
-		[&dest = session.connection](std::span<char const> buffer, size_t){
-			return dest.write(buffer);
-		},
-		overload{
-			[&buffer = std::as_const(buffer)](resp_header_serializer_error_code, auto&&...){
-				assert(std::size(buffer.span_to_read()) == 0);
 				return session_state_response{
 					.status = session_state_status::completed,
 					.state_result = finalize_state_result {
@@ -64,15 +102,20 @@ template<west::io::data_sink Sink, class RequestHandler, size_t BufferSize>
 						.error_message = nullptr
 					}
 				};
-			},
-			[](io::operation_result res, auto&&...){ return make_write_response(res); },
-		// GCOVR_EXCL_START
-			[](){return abort<session_state_response>();}
-		// GCOVR_EXCL_STOP
-		},
-		buffer,
-		max_length
-	);
+			}
+
+			fill_buffer<Sink>(buffer, session.request_handler);
+		}
+
+		auto const res = session.connection.write(buffer.span_to_read());
+		buffer.consume_elements(res.bytes_written);
+		auto const header_bytes_written = std::min(res.bytes_written, m_header_bytes_in_buffer);
+		m_header_bytes_in_buffer -= header_bytes_written;
+		session.response_info.body_bytes_sent += res.bytes_written - header_bytes_written;
+
+		if(is_error_indicator(res.ec) || res.bytes_written == 0)
+		{ return make_write_response(res.ec); }
+	}
 }
 
-#endif
\ No newline at end of file
+#endif
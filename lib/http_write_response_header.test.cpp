@@ -26,8 +26,51 @@ namespace
 
 	};
 
+	enum class error_code{no_error, error};
+
+	constexpr bool can_continue(error_code ec)
+	{ return ec == error_code::no_error; }
+
+	constexpr char const* to_string(error_code ec)
+	{ return ec == error_code::no_error? "No error" : "Error"; }
+
+	struct read_result
+	{
+		size_t bytes_read;
+		error_code ec;
+	};
+
 	struct request_handler
-	{};
+	{
+		std::string_view body;
+		error_code ec{error_code::no_error};
+
+		auto read_response_content(std::span<char> buffer)
+		{
+			auto const n = std::min(std::size(buffer), std::size(body));
+			std::copy_n(std::begin(body), n, std::begin(buffer));
+			body = body.substr(n);
+			return read_result{n, ec};
+		}
+	};
+
+	struct counting_sink
+	{
+		std::reference_wrapper<std::string> m_output_buffer;
+		size_t calls_to_write{0};
+		size_t max_length_per_call{65536};
+
+		auto write(std::span<char const> buffer)
+		{
+			++calls_to_write;
+			auto const bytes_to_write = std::min(std::size(buffer), max_length_per_call);
+			std::copy_n(std::begin(buffer), bytes_to_write, std::back_inserter(m_output_buffer.get()));
+			return west::io::write_result{
+				bytes_to_write,
+				west::io::operation_result::completed
+			};
+		}
+	};
 }
 
 TESTCASE(west_http_write_response_header_write_completed)
@@ -99,4 +142,118 @@ TESTCASE(west_http_write_response_header_connection_closed)
 
 	auto res = writer.socket_is_ready(buff_span, session);
 	EXPECT_EQ(res.status, west::http::session_state_status::connection_closed);
-}
\ No newline at end of file
+}
+
+TESTCASE(west_http_write_response_header_small_body_is_written_with_header)
+{
+	std::array<char, 4096> buffer;
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::response_header header;
+	header.status_line.http_version = west::http::version{1, 1};
+	header.status_line.status_code = west::http::status::ok;
+	header.fields.append("Content-Length", "13");
+
+	west::http::write_response_header writer{header};
+	std::string output_buffer;
+	west::http::session session{counting_sink{output_buffer},
+		request_handler{"Hello, World!"},
+		west::http::request_info{},
+		west::http::response_info{}
+	};
+
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::completed);
+	EXPECT_EQ(session.connection.calls_to_write, 1);
+	EXPECT_EQ(session.response_info.body_bytes_sent, 13);
+	EXPECT_EQ(std::size(buff_span.span_to_read()), 0);
+	EXPECT_EQ(output_buffer, std::string_view{"HTTP/1.1 200 Ok\r\n"
+"Content-Length: 13\r\n"
+"\r\n"
+"Hello, World!"});
+}
+
+TESTCASE(west_http_write_response_header_partial_write_leaves_body_in_buffer)
+{
+	std::array<char, 4096> buffer;
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::response_header header;
+	header.status_line.http_version = west::http::version{1, 1};
+	header.status_line.status_code = west::http::status::ok;
+	header.fields.append("Content-Length", "13");
+
+	west::http::write_response_header writer{header};
+	std::string output_buffer;
+	west::http::session session{counting_sink{output_buffer, 0, 41},
+		request_handler{"Hello, World!"},
+		west::http::request_info{},
+		west::http::response_info{}
+	};
+
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::completed);
+	EXPECT_EQ(session.connection.calls_to_write, 1);
+	EXPECT_EQ(output_buffer, std::string_view{"HTTP/1.1 200 Ok\r\n"
+"Content-Length: 13\r\n"
+"\r\n"
+"He"});
+	EXPECT_EQ(session.response_info.body_bytes_sent, 2);
+	EXPECT_EQ((std::string_view{std::data(buff_span.span_to_read()), std::size(buff_span.span_to_read())}),
+		"llo, World!");
+}
+
+TESTCASE(west_http_write_response_header_header_larger_than_buffer)
+{
+	std::array<char, 64> buffer;
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::response_header header;
+	header.status_line.http_version = west::http::version{1, 1};
+	header.status_line.status_code = west::http::status::ok;
+	header.fields.append("Content-Length", "13")
+		.append("X-Long-Field", std::string(100, 'a'));
+
+	west::http::write_response_header writer{header};
+	std::string output_buffer;
+	west::http::session session{counting_sink{output_buffer},
+		request_handler{"Hello, World!"},
+		west::http::request_info{},
+		west::http::response_info{}
+	};
+
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::completed);
+	EXPECT_EQ(session.response_info.body_bytes_sent, 13);
+	EXPECT_EQ(output_buffer, "HTTP/1.1 200 Ok\r\n"
+		"Content-Length: 13\r\n"
+		"X-Long-Field: " + std::string(100, 'a') + "\r\n"
+		"\r\n"
+		"Hello, World!");
+}
+
+TESTCASE(west_http_write_response_header_read_body_failed)
+{
+	std::array<char, 4096> buffer;
+	west::io_adapter::buffer_span buff_span{buffer};
+
+	west::http::response_header header;
+	header.status_line.http_version = west::http::version{1, 1};
+	header.status_line.status_code = west::http::status::ok;
+	header.fields.append("Content-Length", "13");
+
+	west::http::write_response_header writer{header};
+	std::string output_buffer;
+	west::http::session session{counting_sink{output_buffer},
+		request_handler{"Hello, World!", error_code::error},
+		west::http::request_info{},
+		west::http::response_info{}
+	};
+
+	auto const res = writer.socket_is_ready(buff_span, session);
+	EXPECT_EQ(res.status, west::http::session_state_status::write_response_failed);
+	EXPECT_EQ(session.response_info.body_bytes_sent, 0);
+	EXPECT_EQ(output_buffer, std::string_view{"HTTP/1.1 200 Ok\r\n"
+"Content-Length: 13\r\n"
+"\r\n"});
+}
@@ -0,0 +1,79 @@
+//@	{"target":{"name":"io_adapter.bench"}}
+
+#include "./io_adapter.hpp"
+#include "./io_interfaces.hpp"
+#include "./utils.hpp"
+
+#include "bench/benchmark.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr size_t payload_size = 1024*1024;
+
+	// NOTE: Source and sink move at most `chunk_size` bytes per call, as a socket with a small
+	//       receive or send buffer would
+	template<size_t BufferSize>
+	size_t transfer(std::span<char const> payload,
+		std::span<char> output,
+		west::io_adapter::buffer_span<char, BufferSize>& buffer,
+		size_t chunk_size)
+	{
+		auto bytes_to_read = std::size(payload);
+		size_t bytes_written = 0;
+		buffer.reset_with_new_length(0);
+		west::io_adapter::transfer_data(
+			[&payload, chunk_size](std::span<char> buffer) {
+				auto const n = std::min({chunk_size, std::size(buffer), std::size(payload)});
+				memcpy(std::data(buffer), std::data(payload), n);
+				payload = payload.subspan(n);
+				return west::io::read_result{n, west::io::operation_result::completed};
+			},
+			[output, &bytes_written, chunk_size](std::span<char const> buffer, size_t) {
+				auto const n = std::min(chunk_size, std::size(buffer));
+				memcpy(std::data(output) + bytes_written, std::data(buffer), n);
+				bytes_written += n;
+				return west::io::write_result{n, west::io::operation_result::completed};
+			},
+			west::overload{
+				[](){ return true; },
+				[](west::io::operation_result, auto&&...){ return false; }
+			},
+			buffer,
+			bytes_to_read);
+		return bytes_written;
+	}
+
+	template<size_t BufferSize>
+	void run_transfer_benchmarks(std::span<char const> payload, std::span<char> output)
+	{
+		auto storage = std::make_unique<std::array<char, BufferSize>>();
+		west::io_adapter::buffer_span buffer{*storage};
+		for(auto const chunk_size : {size_t{512}, size_t{4096}, size_t{65536}})
+		{
+			auto const name = std::string{"io_adapter/transfer_data/buffer_size="}
+				.append(std::to_string(BufferSize))
+				.append("/chunk_size=")
+				.append(std::to_string(chunk_size));
+
+			west::bench::run(name, std::size(payload), [payload, output, &buffer, chunk_size](){
+				west::bench::do_not_optimize(transfer(payload, output, buffer, chunk_size));
+			});
+		}
+	}
+}
+
+int main()
+{
+	std::vector<char> payload(payload_size);
+	std::ranges::generate(payload, [k = 0u]() mutable { return static_cast<char>(k++); });
+	std::vector<char> output(payload_size);
+
+	run_transfer_benchmarks<4096>(payload, output);
+	run_transfer_benchmarks<65536>(payload, output);
+}
@@ -0,0 +1,91 @@
+#ifndef WEST_IO_COUNTING_SOCKET_HPP
+#define WEST_IO_COUNTING_SOCKET_HPP
+
+#include "./io_interfaces.hpp"
+
+#include <span>
+#include <utility>
+
+namespace west::io
+{
+	struct io_counters
+	{
+		size_t read_calls{0};
+		size_t write_calls{0};
+		size_t bytes_read{0};
+		size_t bytes_written{0};
+
+		constexpr size_t calls() const
+		{ return read_calls + write_calls; }
+
+		constexpr size_t bytes() const
+		{ return bytes_read + bytes_written; }
+
+		constexpr io_counters operator-(io_counters const& other) const
+		{
+			return io_counters{
+				read_calls - other.read_calls,
+				write_calls - other.write_calls,
+				bytes_read - other.bytes_read,
+				bytes_written - other.bytes_written
+			};
+		}
+
+		constexpr bool operator==(io_counters const&) const = default;
+		constexpr bool operator!=(io_counters const&) const = default;
+	};
+
+	// NOTE: Forwards all calls to `Socket`, and counts the number of calls and bytes transferred.
+	//       send_file is only available if `Socket` is a file_sink.
+	template<socket Socket>
+	class counting_socket
+	{
+	public:
+		explicit counting_socket(Socket&& socket):
+			m_socket{std::move(socket)},
+			m_counters{}
+		{}
+
+		[[nodiscard]] read_result read(std::span<char> buffer)
+		{
+			auto const ret = m_socket.read(buffer);
+			++m_counters.read_calls;
+			m_counters.bytes_read += ret.bytes_read;
+			return ret;
+		}
+
+		[[nodiscard]] write_result write(std::span<char const> buffer)
+		{
+			auto const ret = m_socket.write(buffer);
+			++m_counters.write_calls;
+			m_counters.bytes_written += ret.bytes_written;
+			return ret;
+		}
+
+		[[nodiscard]] write_result send_file(file_range range) requires file_sink<Socket>
+		{
+			auto const ret = m_socket.send_file(range);
+			++m_counters.write_calls;
+			m_counters.bytes_written += ret.bytes_written;
+			return ret;
+		}
+
+		void stop_reading()
+		{ m_socket.stop_reading(); }
+
+		[[nodiscard]] io_counters const& counters() const
+		{ return m_counters; }
+
+		Socket& get()
+		{ return m_socket; }
+
+		Socket const& get() const
+		{ return m_socket; }
+
+	private:
+		Socket m_socket;
+		io_counters m_counters;
+	};
+}
+
+#endif
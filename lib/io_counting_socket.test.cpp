@@ -0,0 +1,82 @@
+//@	{"target":{"name":"io_counting_socket.test"}}
+
+#include "./io_counting_socket.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace
+{
+	struct socket
+	{
+		west::io::read_result read(std::span<char> buffer)
+		{
+			auto const n = std::min(std::size(buffer), std::size(input));
+			std::copy_n(std::begin(input), n, std::begin(buffer));
+			input.erase(0, n);
+			return west::io::read_result{n, west::io::operation_result::completed};
+		}
+
+		west::io::write_result write(std::span<char const> buffer)
+		{
+			output.append(std::begin(buffer), std::end(buffer));
+			return west::io::write_result{std::size(buffer), west::io::operation_result::completed};
+		}
+
+		void stop_reading()
+		{ stopped = true; }
+
+		std::string input;
+		std::string output;
+		bool stopped{false};
+	};
+
+	struct file_socket : socket
+	{
+		west::io::write_result send_file(west::io::file_range range)
+		{ return west::io::write_result{range.length, west::io::operation_result::completed}; }
+	};
+}
+
+static_assert(west::io::socket<west::io::counting_socket<socket>>);
+static_assert(!west::io::file_sink<west::io::counting_socket<socket>>);
+static_assert(west::io::file_sink<west::io::counting_socket<file_socket>>);
+
+TESTCASE(west_io_counting_socket_counts_calls_and_bytes)
+{
+	west::io::counting_socket conn{socket{.input = "Hello, World", .output = "", .stopped = false}};
+	EXPECT_EQ(conn.counters(), west::io::io_counters{});
+
+	std::array<char, 5> buffer{};
+	EXPECT_EQ(conn.read(buffer).bytes_read, 5);
+	EXPECT_EQ(conn.read(buffer).bytes_read, 5);
+	EXPECT_EQ(conn.write(std::string_view{"abc"}).bytes_written, 3);
+
+	EXPECT_EQ(conn.counters().read_calls, 2);
+	EXPECT_EQ(conn.counters().write_calls, 1);
+	EXPECT_EQ(conn.counters().bytes_read, 10);
+	EXPECT_EQ(conn.counters().bytes_written, 3);
+	EXPECT_EQ(conn.counters().calls(), 3);
+	EXPECT_EQ(conn.counters().bytes(), 13);
+	EXPECT_EQ(conn.get().output, "abc");
+
+	conn.stop_reading();
+	EXPECT_EQ(conn.get().stopped, true);
+
+	auto const saved = conn.counters();
+	EXPECT_EQ(conn.read(buffer).bytes_read, 2);
+	auto const delta = conn.counters() - saved;
+	EXPECT_EQ(delta.read_calls, 1);
+	EXPECT_EQ(delta.bytes_read, 2);
+	EXPECT_EQ(delta.write_calls, 0);
+}
+
+TESTCASE(west_io_counting_socket_counts_send_file)
+{
+	west::io::counting_socket conn{file_socket{}};
+	EXPECT_EQ(conn.send_file(west::io::file_range{.fd = 0, .offset = 0, .length = 100}).bytes_written, 100);
+	EXPECT_EQ(conn.counters().write_calls, 1);
+	EXPECT_EQ(conn.counters().bytes_written, 100);
+}
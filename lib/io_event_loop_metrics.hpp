@@ -0,0 +1,143 @@
+#ifndef WEST_IO_EVENT_LOOP_METRICS_HPP
+#define WEST_IO_EVENT_LOOP_METRICS_HPP
+
+#include "./io_fd.hpp"
+#include "./latency_histogram.hpp"
+
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace west::io
+{
+	enum class callback_kind{fd_is_ready, fd_is_idle};
+
+	constexpr char const* to_string(callback_kind kind)
+	{
+		switch(kind)
+		{
+			case callback_kind::fd_is_ready:
+				return "fd_is_ready";
+			case callback_kind::fd_is_idle:
+				return "fd_is_idle";
+			default:
+				__builtin_unreachable();
+		}
+	}
+
+	struct slow_callback
+	{
+		fd_ref fd;
+		std::type_info const* listener_type;
+		callback_kind kind;
+		std::chrono::steady_clock::duration duration;
+	};
+
+	// Returns the name of the listener type of `item`, demangled if possible
+	inline std::string listener_type_name(slow_callback const& item)
+	{
+		auto const mangled = item.listener_type->name();
+		int status = 0;
+		std::unique_ptr<char, decltype(&std::free)> demangled{
+			abi::__cxa_demangle(mangled, nullptr, nullptr, &status),
+			&std::free
+		};
+		return status == 0 && demangled != nullptr? std::string{demangled.get()} : std::string{mangled};
+	}
+
+	// NOTE: Keeps the most recent callbacks that took longer than the threshold, so recording never
+	//       allocates memory
+	class slow_callback_log
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		static constexpr size_t capacity = 32;
+
+		explicit slow_callback_log(clock::duration threshold):
+			m_threshold{threshold}
+		{}
+
+		void record(fd_ref fd, std::type_info const& listener_type, callback_kind kind, clock::duration duration)
+		{
+			if(duration <= m_threshold)
+			{ return; }
+
+			m_entries[m_total_count % capacity] = slow_callback{fd, &listener_type, kind, duration};
+			++m_total_count;
+		}
+
+		[[nodiscard]] clock::duration threshold() const
+		{ return m_threshold; }
+
+		// Returns the number of slow callbacks since the last reset, including those that are no
+		// longer kept
+		[[nodiscard]] size_t total_count() const
+		{ return m_total_count; }
+
+		// Returns the kept callbacks, oldest first
+		[[nodiscard]] std::vector<slow_callback> recent() const
+		{
+			std::vector<slow_callback> ret;
+			auto const n = std::min(m_total_count, capacity);
+			ret.reserve(n);
+			for(size_t k = m_total_count - n; k != m_total_count; ++k)
+			{ ret.push_back(m_entries[k % capacity]); }
+			return ret;
+		}
+
+		void reset()
+		{ m_total_count = 0; }
+
+	private:
+		clock::duration m_threshold;
+		size_t m_total_count{0};
+		std::array<slow_callback, capacity> m_entries{};
+	};
+
+	// NOTE: Recorded by an event monitor when enabled. Not thread-safe. Read it from the thread that
+	//       runs the event loop.
+	struct event_loop_metrics
+	{
+		using clock = std::chrono::steady_clock;
+
+		static constexpr auto default_slow_callback_threshold = std::chrono::milliseconds{10};
+
+		explicit event_loop_metrics(clock::duration slow_callback_threshold = default_slow_callback_threshold):
+			slow_callbacks{slow_callback_threshold}
+		{}
+
+		// Time blocked waiting for events, per wakeup, in nanoseconds
+		latency_histogram wait_time_ns;
+
+		// Time from wakeup until all callbacks have returned, per wakeup, in nanoseconds. This is how
+		// long the last event of a wakeup may wait before it is handled.
+		latency_histogram dispatch_time_ns;
+
+		// Duration of each fd_is_ready and fd_is_idle callback, in nanoseconds
+		latency_histogram callback_time_ns;
+
+		// Number of ready fds reported by each wakeup
+		basic_latency_histogram<6> events_per_wakeup;
+
+		slow_callback_log slow_callbacks;
+
+		void reset()
+		{
+			wait_time_ns.reset();
+			dispatch_time_ns.reset();
+			callback_time_ns.reset();
+			events_per_wakeup.reset();
+			slow_callbacks.reset();
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,52 @@
+//@	{"target":{"name":"io_event_loop_metrics.test"}}
+
+#include "./io_event_loop_metrics.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+namespace
+{
+	struct some_listener
+	{};
+}
+
+TESTCASE(west_io_event_loop_metrics_slow_callback_log)
+{
+	west::io::slow_callback_log log{std::chrono::milliseconds{1}};
+	EXPECT_EQ(log.threshold(), std::chrono::milliseconds{1});
+
+	log.record(3, typeid(some_listener), west::io::callback_kind::fd_is_ready, std::chrono::milliseconds{1});
+	EXPECT_EQ(log.total_count(), 0);
+
+	log.record(3, typeid(some_listener), west::io::callback_kind::fd_is_idle, std::chrono::milliseconds{2});
+	EXPECT_EQ(log.total_count(), 1);
+	auto const recent = log.recent();
+	REQUIRE_EQ(std::size(recent), 1);
+	EXPECT_EQ(recent[0].fd, west::io::fd_ref{3});
+	EXPECT_EQ(recent[0].kind, west::io::callback_kind::fd_is_idle);
+	EXPECT_EQ(recent[0].duration, std::chrono::milliseconds{2});
+	EXPECT_EQ(west::io::listener_type_name(recent[0]), "(anonymous namespace)::some_listener");
+}
+
+TESTCASE(west_io_event_loop_metrics_slow_callback_log_keeps_most_recent)
+{
+	west::io::slow_callback_log log{std::chrono::nanoseconds{0}};
+	auto const n = west::io::slow_callback_log::capacity + 5;
+	for(size_t k = 0; k != n; ++k)
+	{
+		log.record(static_cast<int>(k),
+			typeid(some_listener),
+			west::io::callback_kind::fd_is_ready,
+			std::chrono::microseconds{1});
+	}
+
+	EXPECT_EQ(log.total_count(), n);
+	auto const recent = log.recent();
+	REQUIRE_EQ(std::size(recent), west::io::slow_callback_log::capacity);
+	EXPECT_EQ(recent.front().fd, west::io::fd_ref{5});
+	EXPECT_EQ(recent.back().fd, west::io::fd_ref{static_cast<int>(n - 1)});
+
+	log.reset();
+	EXPECT_EQ(log.total_count(), 0);
+	EXPECT_EQ(std::size(log.recent()), 0);
+}
@@ -8,6 +8,7 @@
 #include <sys/stat.h>
 #include <sys/socket.h>
 #include <sys/signalfd.h>
+#include <sys/timerfd.h>
 #include <signal.h>
 #include <fcntl.h>
 
@@ -86,6 +87,14 @@ namespace west::io
 		return fd_owner{fd_ref{tmp}};
 	}
 
+	[[nodiscard]] inline auto create_timer_fd(int clock_id, int flags)
+	{
+		auto const tmp = ::timerfd_create(clock_id, flags);
+		if(tmp == -1)
+		{ throw system_error{"Failed to create timerfd", errno}; }
+		return fd_owner{fd_ref{tmp}};
+	}
+
 	struct pipe
 	{
 		fd_owner read_end;
@@ -106,7 +115,14 @@ namespace west::io
 
 	inline void set_non_blocking(fd_ref fd)
 	{
-		if(::fcntl(fd, F_SETFL, O_NONBLOCK) == -1)
+		auto const flags = ::fcntl(fd, F_GETFL);
+		if(flags == -1)
+		{ throw system_error{"Failed to enable nonblocking mode", errno};}
+
+		if((flags & O_NONBLOCK) != 0)
+		{ return; }
+
+		if(::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
 		{ throw system_error{"Failed to enable nonblocking mode", errno};}
 	}
 }
@@ -28,4 +28,41 @@ TESTCASE(west_io_fd_create_file)
 		EXPECT_EQ(n, 12);
 		EXPECT_EQ((std::string_view{buffer.data(), 12}), "Hello, World");
 	}
-}
\ No newline at end of file
+}
+
+TESTCASE(west_io_fd_set_non_blocking_keeps_other_flags)
+{
+	std::array<int, 2> fds{};
+	REQUIRE_EQ(::pipe2(std::data(fds), O_CLOEXEC), 0);
+	west::io::fd_owner read_end{west::io::fd_ref{fds[0]}};
+	west::io::fd_owner write_end{west::io::fd_ref{fds[1]}};
+
+	REQUIRE_EQ(::fcntl(write_end.get(), F_SETFL, O_APPEND), 0);
+	west::io::set_non_blocking(write_end.get());
+	auto const flags = ::fcntl(write_end.get(), F_GETFL);
+	EXPECT_NE(flags & O_NONBLOCK, 0);
+	EXPECT_NE(flags & O_APPEND, 0);
+
+	// Calling it again is a no-op
+	west::io::set_non_blocking(write_end.get());
+	EXPECT_EQ(::fcntl(write_end.get(), F_GETFL), flags);
+}
+
+TESTCASE(west_io_fd_create_timer_fd)
+{
+	auto const timer = west::io::create_timer_fd(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	EXPECT_NE(timer, nullptr);
+
+	// Not armed
+	uint64_t expirations{};
+	EXPECT_EQ(::read(timer.get(), &expirations, sizeof(expirations)), -1);
+
+	itimerspec const spec{
+		.it_interval = timespec{},
+		.it_value = timespec{.tv_sec = 0, .tv_nsec = 1000}
+	};
+	REQUIRE_EQ(::timerfd_settime(timer.get(), 0, &spec, nullptr), 0);
+	while(::read(timer.get(), &expirations, sizeof(expirations)) == -1)
+	{ EXPECT_EQ(errno, EAGAIN); }
+	EXPECT_EQ(expirations, 1);
+}
@@ -0,0 +1,83 @@
+//@	{"target":{"name":"io_fd_event_monitor.bench"}}
+
+#include "./io_fd_event_monitor.hpp"
+
+#include "bench/benchmark.hpp"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct listener
+	{
+		template<class... T>
+		void fd_is_ready(T&&...)
+		{ }
+
+		template<class... T>
+		void fd_is_idle(T&&...)
+		{ }
+	};
+
+	// NOTE: Models connections that are accepted and closed within the same event loop iteration.
+	//       Each iteration adds all fds, and removes them again.
+	void add_remove(west::io::fd_event_monitor& monitor, std::vector<west::io::pipe> const& pipes)
+	{
+		for(auto const& item : pipes)
+		{ monitor.add(item.read_end.get(), listener{}, west::io::listen_on::read_is_possible); }
+
+		for(auto const& item : pipes)
+		{ monitor.deferred_remove(item.read_end.get()); }
+
+		monitor.flush_fds_to_remove();
+	}
+}
+
+int main()
+{
+	for(auto const fd_count : {size_t{1}, size_t{64}, size_t{1024}})
+	{
+		std::vector<west::io::pipe> pipes;
+		for(size_t k = 0; k != fd_count; ++k)
+		{ pipes.push_back(west::io::create_pipe(O_NONBLOCK | O_DIRECT)); }
+
+		west::io::fd_event_monitor monitor{};
+		auto const name = std::string{"fd_event_monitor/add_remove/fd_count="}
+			.append(std::to_string(fd_count));
+
+		west::bench::run(name, 0, fd_count, [&monitor, &pipes](){
+			add_remove(monitor, pipes);
+		});
+	}
+
+	// NOTE: All fds are readable, so every iteration dispatches fd_count events. This measures the
+	//       cost of the loop itself, with and without loop metrics.
+	for(auto const with_metrics : {false, true})
+	{
+		for(auto const fd_count : {size_t{1}, size_t{64}, size_t{1024}})
+		{
+			std::vector<west::io::pipe> pipes;
+			west::io::fd_event_monitor monitor{};
+			if(with_metrics)
+			{ monitor.enable_loop_metrics(); }
+
+			for(size_t k = 0; k != fd_count; ++k)
+			{
+				pipes.push_back(west::io::create_pipe(O_NONBLOCK | O_DIRECT));
+				if(::write(pipes.back().write_end.get(), "x", 1) != 1)
+				{ return 1; }
+				monitor.add(pipes.back().read_end.get(), listener{}, west::io::listen_on::read_is_possible);
+			}
+
+			auto const name = std::string{"fd_event_monitor/dispatch/"}
+				.append(with_metrics? "loop_metrics" : "no_metrics")
+				.append("/fd_count=")
+				.append(std::to_string(fd_count));
+
+			west::bench::run(name, 0, fd_count, [&monitor](){
+				west::bench::do_not_optimize(monitor.wait_for_and_dispatch_events());
+			});
+		}
+	}
+}
@@ -4,24 +4,44 @@
 #include "./system_error.hpp"
 #include "./io_fd.hpp"
 #include "./utils.hpp"
+#include "./io_timer_wheel.hpp"
+#include "./io_interfaces.hpp"
+#include "./io_fd_table.hpp"
+#include "./io_event_loop_metrics.hpp"
 
 #include <sys/epoll.h>
 
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
 #include <vector>
-#include <unordered_map>
 #include <span>
 #include <cassert>
 #include <chrono>
-#include <list>
+#include <algorithm>
+#include <typeinfo>
+#include <utility>
 
 namespace west::io
 {
-	enum class listen_on {
+	enum class listen_on:uint32_t {
 		read_is_possible = EPOLLIN,
 		write_is_possible = EPOLLOUT,
-		readwrite_is_possible = EPOLLIN|EPOLLOUT
+		readwrite_is_possible = EPOLLIN|EPOLLOUT,
+
+		// NOTE: The fd stays registered, and its timeout still applies, but its listener is not
+		//       notified about readiness until the events are modified again
+		nothing = 0,
+
+		// NOTE: The listener is only notified when the state of the fd changes, so it must read or
+		//       write until the operation would block. The fd never needs to be modified.
+		readwrite_edge_triggered = EPOLLIN|EPOLLOUT|EPOLLRDHUP|EPOLLET
 	};
 
+	enum class trigger_mode{level, edge};
+
 	template<class T>
 	class fd_event_listener_ref
 	{
@@ -63,6 +83,11 @@ namespace west::io
 		void remove(fd_ref fd)
 		{ m_registry.get().deferred_remove(fd);}
 
+		void set_timeout(fd_ref fd,
+			std::chrono::steady_clock::duration timeout,
+			timeout_mode mode = timeout_mode::restart_on_activity)
+		{ m_registry.get().set_timeout(fd, timeout, mode); }
+
 		void clear()
 		{ m_registry.get().deferred_clear(); }
 
@@ -70,165 +95,378 @@ namespace west::io
 		std::reference_wrapper<FdCallbackRegistry> m_registry;
 	};
 
-	class fd_event_monitor
+	class epoll_poller
+	{
+	public:
+		static constexpr bool supports_edge_triggered = true;
+
+		epoll_poller():
+			m_fd{epoll_create1(0)},
+			m_event_buffer_capacity{0},
+			m_ctl_call_count{0},
+			m_wait_call_count{0}
+		{
+			if(m_fd == nullptr)
+			{ throw system_error{"Failed to create epoll instance", errno}; }
+		}
+
+		void add(fd_ref fd, listen_on events, uint64_t token)
+		{
+			epoll_event event{
+				.events = static_cast<uint32_t>(events),
+				.data = epoll_data_t{.u64 = token}
+			};
+
+			++m_ctl_call_count;
+			if(::epoll_ctl(m_fd.get(), EPOLL_CTL_ADD, fd, &event) == -1)
+			{ throw system_error{"Failed to add event listener for file descriptor", errno}; }
+		}
+
+		void modify(fd_ref fd, listen_on new_events, uint64_t token)
+		{
+			epoll_event event{
+				.events = static_cast<uint32_t>(new_events),
+				.data = epoll_data_t{.u64 = token}
+			};
+			++m_ctl_call_count;
+			if(::epoll_ctl(m_fd.get(), EPOLL_CTL_MOD, fd, &event) == -1)
+			{ throw system_error{"Failed to modify event listener", errno}; }
+		}
+
+		void remove(fd_ref fd)
+		{
+			epoll_event event{};
+			++m_ctl_call_count;
+			::epoll_ctl(m_fd.get(), EPOLL_CTL_DEL, fd , &event);
+		}
+
+		// Returns the number of calls to epoll_ctl made through this poller
+		[[nodiscard]] size_t ctl_call_count() const
+		{ return m_ctl_call_count; }
+
+		// Returns the number of system calls made through this poller
+		[[nodiscard]] size_t syscall_count() const
+		{ return m_ctl_call_count + m_wait_call_count; }
+
+		template<class EventHandler>
+		void wait_for_events(size_t max_events, int timeout, EventHandler&& on_event)
+		{
+			if(max_events > m_event_buffer_capacity)
+			{
+				m_events = std::make_unique_for_overwrite<epoll_event[]>(max_events);
+				m_event_buffer_capacity = max_events;
+			}
+
+			++m_wait_call_count;
+			auto const n = ::epoll_wait(m_fd.get(),
+				m_events.get(),
+				static_cast<int>(max_events),
+				timeout);
+
+			if(n == -1)
+			{ throw system_error{"epoll_wait failed", errno}; }
+
+			for(auto& event : std::span{m_events.get(), static_cast<size_t>(n)})
+			{ on_event(event.data.u64); }
+		}
+
+	private:
+		fd_owner m_fd;
+		std::unique_ptr<epoll_event[]> m_events;
+		size_t m_event_buffer_capacity;
+		size_t m_ctl_call_count;
+		size_t m_wait_call_count;
+	};
+
+	namespace detail
+	{
+		// NOTE: Memory for one listener object. Small objects are stored inline. The memory for
+		//       larger objects is kept when the object is destroyed, so it can be reused by the next
+		//       listener for the same fd, without a new allocation. The owner may release memory
+		//       that is too large to be worth keeping.
+		class listener_storage
+		{
+		public:
+			static constexpr size_t inline_capacity = 64;
+
+			template<class T, class... Args>
+			T* construct(Args&&... args)
+			{
+				static_assert(alignof(T) <= alignof(std::max_align_t));
+				if constexpr(sizeof(T) <= inline_capacity)
+				{ return new(std::data(m_inline)) T{std::forward<Args>(args)...}; }
+				else
+				{
+					if(sizeof(T) > m_capacity)
+					{
+						m_data = std::make_unique_for_overwrite<storage_block[]>(blocks_needed(sizeof(T)));
+						m_capacity = blocks_needed(sizeof(T))*sizeof(storage_block);
+					}
+					return new(m_data.get()) T{std::forward<Args>(args)...};
+				}
+			}
+
+			[[nodiscard]] size_t capacity() const
+			{ return m_capacity; }
+
+			// Frees the memory for larger objects if its capacity exceeds max_capacity. No object may
+			// be stored when this is called.
+			void release_if_larger_than(size_t max_capacity)
+			{
+				if(m_capacity > max_capacity)
+				{
+					m_data.reset();
+					m_capacity = 0;
+				}
+			}
+
+		private:
+			struct alignas(std::max_align_t) storage_block
+			{ std::byte data[alignof(std::max_align_t)]; };
+
+			static constexpr size_t blocks_needed(size_t size)
+			{ return (size + sizeof(storage_block) - 1)/sizeof(storage_block); }
+
+			std::unique_ptr<storage_block[]> m_data;
+			size_t m_capacity{0};
+			alignas(std::max_align_t) std::array<std::byte, inline_capacity> m_inline;
+		};
+	}
+
+	template<class Poller>
+	class basic_fd_event_monitor
 	{
 	public:
-		using activity_timestamp = std::chrono::steady_clock::time_point;
-		using fd_activity_list = std::list<std::pair<activity_timestamp, fd_ref>>;
+		using clock = std::chrono::steady_clock;
 
 		static constexpr auto inactivity_period = std::chrono::seconds{20};
+		static constexpr auto default_timer_tick = std::chrono::milliseconds{10};
+		static constexpr auto max_wait_time = std::chrono::milliseconds{1000};
+		static constexpr bool supports_edge_triggered = Poller::supports_edge_triggered;
+
+		// NOTE: Storage for a removed listener is kept for the next listener of the same fd, unless
+		//       it is larger than this. An http session needs about 2.5 kB.
+		static constexpr size_t max_kept_listener_storage = 16384;
+
+		struct statistics
+		{
+			// Number of calls to wait_for_and_dispatch_events that waited for events
+			size_t iterations;
+
+			// Number of fd_is_ready callbacks
+			size_t events;
+
+			// Number of fd_is_idle callbacks
+			size_t idle_events;
+
+			// Time from wakeup until all callbacks of the iteration have returned, summed over all
+			// iterations
+			clock::duration busy_time;
+
+			// The longest busy time of a single iteration
+			clock::duration max_busy_time;
+
+			constexpr bool operator==(statistics const&) const = default;
+			constexpr bool operator!=(statistics const&) const = default;
+		};
 
 		class listener
 		{
 		public:
 			template<class FdEventListener>
-			explicit listener(FdEventListener&& object, fd_activity_list::iterator const& timer):
-				m_object{make_type_erased_ptr<FdEventListener>(std::forward<FdEventListener>(object))},
-				m_fd_is_ready{[](void* obj, fd_callback_registry_ref<fd_event_monitor> registry, fd_ref fd) {
-					auto& l = *static_cast<FdEventListener*>(obj);
+			explicit listener(FdEventListener&& object, uint64_t timeout, detail::listener_storage& storage):
+				m_object{storage.construct<std::remove_cvref_t<FdEventListener>>(std::forward<FdEventListener>(object))},
+				m_destroy{[](void* obj) {
+					std::destroy_at(static_cast<std::remove_cvref_t<FdEventListener>*>(obj));
+				}},
+				m_fd_is_ready{[](void* obj, fd_callback_registry_ref<basic_fd_event_monitor> registry, fd_ref fd) {
+					auto& l = *static_cast<std::remove_cvref_t<FdEventListener>*>(obj);
 					l.fd_is_ready(registry, fd);
 				}},
-				m_fd_is_idle{[](void* obj, fd_callback_registry_ref<fd_event_monitor> registry, fd_ref fd) {
-					auto& l = *static_cast<FdEventListener*>(obj);
+				m_fd_is_idle{[](void* obj, fd_callback_registry_ref<basic_fd_event_monitor> registry, fd_ref fd) {
+					auto& l = *static_cast<std::remove_cvref_t<FdEventListener>*>(obj);
 					l.fd_is_idle(registry, fd);
 				}},
-				m_timer{timer}
+				m_timeout{timeout},
+				m_timeout_mode{timeout_mode::restart_on_activity},
+				m_type{&typeid(std::remove_cvref_t<FdEventListener>)}
 			{}
 
-			void fd_is_ready(fd_callback_registry_ref<fd_event_monitor> callback_registry, fd_ref fd, fd_activity_list& list)
-			{
-				m_fd_is_ready(m_object.get(), callback_registry, fd);
+			listener(listener const&) = delete;
+			listener& operator=(listener const&) = delete;
+
+			~listener()
+			{ m_destroy(m_object); }
 
-				auto const now = std::chrono::steady_clock::now();
-				m_timer->first = now + inactivity_period;
-				list.splice(list.end(), list, m_timer);
+			// NOTE: The timer is re-armed before calling the callback, so the callback may change the
+			//       timeout through set_timeout
+			void fd_is_ready(basic_fd_event_monitor& monitor, fd_ref fd)
+			{
+				if(m_timeout_mode == timeout_mode::restart_on_activity)
+				{ monitor.m_timers.arm(m_timer, monitor.m_now + m_timeout); }
+				m_fd_is_ready(m_object, monitor.fd_callback_registry(), fd);
 			}
 
-			void fd_is_idle(fd_callback_registry_ref<fd_event_monitor> callback_registry,
-				fd_ref fd,
-				fd_activity_list& list)
+			void fd_is_idle(basic_fd_event_monitor& monitor, fd_ref fd)
 			{
-				m_fd_is_idle(m_object.get(), callback_registry, fd);
+				monitor.m_timers.arm(m_timer, monitor.m_now + m_timeout);
+				m_fd_is_idle(m_object, monitor.fd_callback_registry(), fd);
+			}
+
+			timer_wheel::entry& timer()
+			{ return m_timer; }
 
-				auto const now = std::chrono::steady_clock::now();
-				m_timer->first = now + inactivity_period;
-				list.splice(list.end(), list, m_timer);
+			void set_timeout(uint64_t timeout, timeout_mode mode)
+			{
+				m_timeout = timeout;
+				m_timeout_mode = mode;
 			}
 
-			void remove_from(fd_activity_list& list)
-			{ list.erase(m_timer); }
+			uint64_t timeout() const
+			{ return m_timeout; }
+
+			std::type_info const& type() const
+			{ return *m_type; }
 
 		private:
-			type_erased_ptr m_object;
-			void (*m_fd_is_ready)(void*, fd_callback_registry_ref<fd_event_monitor>, fd_ref);
-			void (*m_fd_is_idle)(void*, fd_callback_registry_ref<fd_event_monitor>, fd_ref);
-			fd_activity_list::iterator m_timer;
+			void* m_object;
+			void (*m_destroy)(void*);
+			void (*m_fd_is_ready)(void*, fd_callback_registry_ref<basic_fd_event_monitor>, fd_ref);
+			void (*m_fd_is_idle)(void*, fd_callback_registry_ref<basic_fd_event_monitor>, fd_ref);
+			timer_wheel::entry m_timer;
+			uint64_t m_timeout;
+			timeout_mode m_timeout_mode;
+			std::type_info const* m_type;
 		};
 
-		fd_event_monitor():
-			m_fd{epoll_create1(0)},
-			m_event_buffer_capacity{0},
+		explicit basic_fd_event_monitor(clock::duration timer_tick = default_timer_tick):
+			m_tick{std::max(timer_tick, clock::duration{1})},
+			m_now{to_tick(clock::now())},
+			m_timers{m_now},
 			m_reg_should_be_cleared{false}
-		{
-			if(m_fd == nullptr)
-			{ throw system_error{"Failed to create epoll instance", errno}; }
-		}
+		{}
+
+		basic_fd_event_monitor(basic_fd_event_monitor const&) = delete;
+		basic_fd_event_monitor& operator=(basic_fd_event_monitor const&) = delete;
 
 		auto fd_callback_registry()
 		{ return fd_callback_registry_ref{*this}; }
 
-		[[nodiscard]] bool wait_for_and_dispatch_events()
+		[[nodiscard]] clock::duration timer_tick() const
+		{ return m_tick; }
+
+		[[nodiscard]] Poller const& poller() const
+		{ return m_poller; }
+
+		[[nodiscard]] statistics const& stats() const
+		{ return m_stats; }
+
+		[[nodiscard]] size_t listener_count() const
+		{ return m_listener_count; }
+
+		// Starts recording event_loop_metrics. Callbacks that take longer than
+		// `slow_callback_threshold` are logged, with their fd and listener type. Recording costs one
+		// clock read per callback.
+		basic_fd_event_monitor& enable_loop_metrics(
+			clock::duration slow_callback_threshold = event_loop_metrics::default_slow_callback_threshold)
 		{
-			auto const num_listeners = std::size(m_listeners);
+			m_loop_metrics = std::make_unique<event_loop_metrics>(slow_callback_threshold);
+			return *this;
+		}
 
-			if(num_listeners == 0)
-			{ return false; }
+		basic_fd_event_monitor& disable_loop_metrics()
+		{
+			m_loop_metrics.reset();
+			return *this;
+		}
 
-			if(num_listeners > m_event_buffer_capacity)
-			{
-				m_events = std::make_unique_for_overwrite<epoll_event[]>(num_listeners);
-				m_event_buffer_capacity = num_listeners;
-			}
+		// Returns null unless loop metrics are enabled
+		[[nodiscard]] event_loop_metrics const* loop_metrics() const
+		{ return m_loop_metrics.get(); }
 
-			std::span event_buffer{m_events.get(), num_listeners};
+		[[nodiscard]] event_loop_metrics* loop_metrics()
+		{ return m_loop_metrics.get(); }
 
-			auto const n = ::epoll_wait(m_fd.get(),
-				std::data(event_buffer),
-				static_cast<int>(std::size(event_buffer)),
-				1000);
+		[[nodiscard]] bool wait_for_and_dispatch_events()
+		{
+			auto const num_listeners = m_listener_count;
 
-			if(n == -1)
-			{ throw system_error{"epoll_wait failed", errno}; }
+			if(num_listeners == 0)
+			{ return false; }
 
-			for(auto& event : std::span{m_events.get(), static_cast<size_t>(n)})
+			if(m_loop_metrics == nullptr)
 			{
-				auto const data = static_cast<std::pair<fd_ref const, listener>*>(event.data.ptr);
-				data->second.fd_is_ready(fd_callback_registry(), data->first, m_fd_activity_timestamps);
+				dispatch_events(num_listeners, [](listener const&, fd_ref, callback_kind){});
+				record_iteration(clock::now());
+				return true;
 			}
 
-			process_idle_fds();
-			flush_fds_to_remove();
+			// NOTE: Each callback is timed from the return of the previous one, so the time between
+			//       callbacks is attributed to the next callback
+			auto& metrics = *m_loop_metrics;
+			auto const wait_start = clock::now();
+			auto prev = wait_start;
+			size_t events = 0;
+			dispatch_events(num_listeners, [this, &metrics, &prev, &events](listener const& l, fd_ref fd, callback_kind kind) {
+				auto const now = clock::now();
+				auto const duration = now - std::max(prev, m_wakeup_time);
+				metrics.callback_time_ns.record(to_ns(duration));
+				metrics.slow_callbacks.record(fd, l.type(), kind, duration);
+				events += kind == callback_kind::fd_is_ready? 1 : 0;
+				prev = now;
+			});
 
+			auto const now = clock::now();
+			metrics.wait_time_ns.record(to_ns(m_wakeup_time - wait_start));
+			metrics.dispatch_time_ns.record(to_ns(now - m_wakeup_time));
+			metrics.events_per_wakeup.record(events);
+			record_iteration(now);
 			return true;
 		}
 
 		void process_idle_fds()
-		{
-			auto const now = std::chrono::steady_clock::now();
-			auto i = std::begin(m_fd_activity_timestamps);
-			auto const i_end = std::end(m_fd_activity_timestamps);
-			while(i != i_end)
-			{
-				if(i->first > now)
-				{ break; }
-
-				auto const item = m_listeners.find(i->second);
-				assert(item != std::end(m_listeners));
-				item->second.fd_is_idle(fd_callback_registry(), item->first, m_fd_activity_timestamps);
-
-				++i;
-			}
-		}
+		{ process_idle_fds([](listener const&, fd_ref, callback_kind){}); }
 
 		template<class FdEventListener>
-		fd_event_monitor& add(fd_ref fd, FdEventListener&& l, listen_on events = listen_on::readwrite_is_possible)
+		basic_fd_event_monitor& add(fd_ref fd, FdEventListener&& l, listen_on events = listen_on::readwrite_is_possible)
 		{
-			assert(!m_listeners.contains(fd));
+			auto& slot = m_listeners.get(fd);
+			assert(!slot.current.has_value());
 
-			auto const now = std::chrono::steady_clock::now();
-			m_fd_activity_timestamps.push_back(std::pair{now + inactivity_period, fd});
-			auto const timer = std::prev(m_fd_activity_timestamps.end());
+			auto& item = slot.current.emplace(std::forward<FdEventListener>(l),
+				to_ticks(inactivity_period),
+				slot.storage);
 
-			auto const i = m_listeners.insert(std::pair{
-				fd,
-				listener{std::forward<FdEventListener>(l), timer}
-			});
-
-			epoll_event event{
-				.events = static_cast<uint32_t>(events),
-				.data = &(*i.first)
-			};
-
-			if(::epoll_ctl(m_fd.get(), EPOLL_CTL_ADD, fd, &event) == -1)
+			try
+			{ m_poller.add(fd, events, to_token(item)); }
+			catch(...)
 			{
-				auto const saved_errno = errno;
-				m_listeners.erase(i.first);
-				throw system_error{"Failed to add event listener for file descriptor", saved_errno};
+				slot.current.reset();
+				throw;
 			}
+			++m_listener_count;
+
+			// NOTE: add may be called from outside the event loop, so the cached time cannot be used
+			auto& timer = item.timer();
+			timer.fd = fd;
+			m_timers.arm(timer, to_tick(clock::now()) + item.timeout());
 
 			return *this;
 		}
 
 		void modify(fd_ref fd, listen_on new_events)
 		{
-			auto const i = m_listeners.find(fd);
-			assert(i != std::end(m_listeners));
-			epoll_event event{
-				.events = static_cast<uint32_t>(new_events),
-				.data = &(*i)
-			};
-			if(::epoll_ctl(m_fd.get(), EPOLL_CTL_MOD, fd, &event) == -1)
-			{ throw system_error{"Failed to modify event listener", errno}; }
+			m_poller.modify(fd, new_events, to_token(get_listener(fd)));
+		}
+
+		// Sets the time `fd` may be inactive before its listener is notified. The new timeout is
+		// counted from the most recent event loop wakeup. With timeout_mode::fixed_deadline, activity
+		// on `fd` does not extend the deadline.
+		void set_timeout(fd_ref fd, clock::duration timeout, timeout_mode mode = timeout_mode::restart_on_activity)
+		{
+			auto& item = get_listener(fd);
+			item.set_timeout(to_ticks(timeout), mode);
+			m_timers.arm(item.timer(), m_now + item.timeout());
 		}
 
 		void deferred_remove(fd_ref fd)
@@ -240,33 +478,153 @@ namespace west::io
 		void flush_fds_to_remove()
 		{
 			if(m_reg_should_be_cleared)
-			{ *this = fd_event_monitor{}; }
+			{
+				m_listeners.for_each([this](fd_ref, slot& item) {
+					if(item.current.has_value())
+					{ m_timers.disarm(item.current->timer()); }
+				});
+				m_listeners.clear();
+				m_listener_count = 0;
+				m_fds_to_remove.clear();
+				m_poller = Poller{};
+				m_reg_should_be_cleared = false;
+			}
 			else
 			{
 				for(auto fd : m_fds_to_remove)
 				{
-					epoll_event event{};
-					::epoll_ctl(m_fd.get(), EPOLL_CTL_DEL, fd , &event);
-					auto const i = m_listeners.find(fd);
-					assert(i != std::end(m_listeners));
-					i->second.remove_from(m_fd_activity_timestamps);
-					m_listeners.erase(fd);
+					m_poller.remove(fd);
+					auto& item = *m_listeners.find(fd);
+					assert(item.current.has_value());
+					m_timers.disarm(item.current->timer());
+					item.current.reset();
+					item.storage.release_if_larger_than(max_kept_listener_storage);
+					--m_listener_count;
 				}
 
 				m_fds_to_remove.clear();
 			}
 		}
 
+		// Returns the number of bytes held for listener objects that do not fit inline
+		[[nodiscard]] size_t listener_storage_capacity() const
+		{
+			size_t ret = 0;
+			m_listeners.for_each([&ret](fd_ref, slot const& item) {
+				ret += item.storage.capacity();
+			});
+			return ret;
+		}
+
 	private:
-		fd_owner m_fd;
+		// NOTE: The storage is kept when the listener is removed, so it can be reused by the next
+		//       listener for the same fd. See max_kept_listener_storage.
+		struct slot
+		{
+			detail::listener_storage storage;
+			std::optional<listener> current;
+		};
 
-		std::unique_ptr<epoll_event[]> m_events;
-		size_t m_event_buffer_capacity;
-		std::unordered_map<fd_ref, listener> m_listeners;
+		static uint64_t to_token(listener& item)
+		{ return reinterpret_cast<uint64_t>(&item); }
+
+		listener& get_listener(fd_ref fd)
+		{
+			auto const item = m_listeners.find(fd);
+			assert(item != nullptr && item->current.has_value());
+			return *item->current;
+		}
+
+		// NOTE: on_callback_returned is called after every callback. The listener is still alive,
+		//       since fds are removed after all callbacks have returned.
+		template<class OnCallbackReturned>
+		void dispatch_events(size_t max_events, OnCallbackReturned&& on_callback_returned)
+		{
+			m_poller.wait_for_events(max_events, wait_time(), [this, &on_callback_returned](uint64_t token) {
+				if(!m_clock_is_fresh)
+				{
+					update_clock();
+					m_clock_is_fresh = true;
+				}
+				++m_stats.events;
+				auto& l = *reinterpret_cast<listener*>(token);
+				auto const fd = l.timer().fd;
+				l.fd_is_ready(*this, fd);
+				on_callback_returned(std::as_const(l), fd, callback_kind::fd_is_ready);
+			});
+
+			process_idle_fds(on_callback_returned);
+			flush_fds_to_remove();
+		}
+
+		template<class OnCallbackReturned>
+		void process_idle_fds(OnCallbackReturned&& on_callback_returned)
+		{
+			if(!m_clock_is_fresh)
+			{ update_clock(); }
+			m_clock_is_fresh = false;
+
+			m_timers.advance(m_now, [this, &on_callback_returned](timer_wheel::entry& timer) {
+				++m_stats.idle_events;
+				auto const fd = timer.fd;
+				auto& l = get_listener(fd);
+				l.fd_is_idle(*this, fd);
+				on_callback_returned(std::as_const(l), fd, callback_kind::fd_is_idle);
+			});
+		}
+
+		// NOTE: m_wakeup_time was set by process_idle_fds, if there were no events
+		void record_iteration(clock::time_point now)
+		{
+			auto const busy_time = now - m_wakeup_time;
+			++m_stats.iterations;
+			m_stats.busy_time += busy_time;
+			m_stats.max_busy_time = std::max(m_stats.max_busy_time, busy_time);
+		}
+
+		static uint64_t to_ns(clock::duration d)
+		{ return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()); }
+
+		void update_clock()
+		{
+			m_wakeup_time = clock::now();
+			m_now = to_tick(m_wakeup_time);
+		}
+
+		uint64_t to_tick(clock::time_point t) const
+		{ return static_cast<uint64_t>(t.time_since_epoch()/m_tick); }
+
+		// NOTE: Rounds up, and adds one tick since the current time may be anywhere within the
+		//       current tick. Thus, a timer never fires early.
+		uint64_t to_ticks(clock::duration d) const
+		{ return static_cast<uint64_t>((std::max(d, clock::duration{}) + m_tick - clock::duration{1})/m_tick) + 1; }
+
+		int wait_time() const
+		{
+			auto const next = m_timers.next_expiry();
+			if(!next.has_value())
+			{ return static_cast<int>(max_wait_time.count()); }
+
+			auto const remaining = clock::time_point{*next*m_tick} - clock::now();
+			auto const ret = std::chrono::ceil<std::chrono::milliseconds>(remaining);
+			return static_cast<int>(std::clamp(ret, std::chrono::milliseconds{0}, max_wait_time).count());
+		}
+
+		Poller m_poller;
+		clock::duration m_tick;
+		uint64_t m_now;
+		timer_wheel m_timers;
+		fd_table<slot> m_listeners;
+		size_t m_listener_count{0};
 		std::vector<fd_ref> m_fds_to_remove;
-		fd_activity_list m_fd_activity_timestamps;
 		bool m_reg_should_be_cleared;
+		bool m_clock_is_fresh{false};
+		clock::time_point m_wakeup_time;
+		statistics m_stats{};
+		std::unique_ptr<event_loop_metrics> m_loop_metrics;
 	};
+
+	using fd_event_monitor = basic_fd_event_monitor<epoll_poller>;
 }
 
 #endif
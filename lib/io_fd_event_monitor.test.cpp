@@ -6,9 +6,14 @@
 
 #include <thread>
 #include <chrono>
+#include <cstdlib>
+#include <new>
+#include <utility>
 
 namespace
 {
+	size_t allocation_count = 0;
+
 	struct callback
 	{
 		std::atomic<int> ready_callcount{0};
@@ -35,6 +40,23 @@ namespace
 	}
 }
 
+// NOTE: GCC does not know that the global operator new has been replaced
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(size_t size)
+{
+	++allocation_count;
+	if(auto const ret = malloc(size); ret != nullptr)
+	{ return ret; }
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{ free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept
+{ free(ptr); }
+
 TESTCASE(west_io_fd_event_monitor_monitor_pipe_read_end)
 {
 	west::io::fd_event_monitor monitor{};
@@ -180,4 +202,213 @@ TESTCASE(west_io_fd_event_monitor_idle_fd)
 	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
 	EXPECT_EQ(cb.idle_callcount, 1);
 	EXPECT_EQ(cb.ready_callcount, 0);
-}
\ No newline at end of file
+}
+TESTCASE(west_io_fd_event_monitor_set_timeout)
+{
+	west::io::fd_event_monitor monitor{std::chrono::milliseconds{5}};
+	EXPECT_EQ(monitor.timer_tick(), std::chrono::milliseconds{5});
+
+	callback cb{};
+	auto pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+	monitor.add(pipe.read_end.get(), west::io::fd_event_listener_ref{cb}, west::io::listen_on::read_is_possible);
+	monitor.set_timeout(pipe.read_end.get(), std::chrono::milliseconds{100});
+
+	// The wait time is derived from the deadline, so the callback should be called after roughly
+	// 100 ms, and never before
+	auto const t0 = std::chrono::steady_clock::now();
+	while(cb.idle_callcount == 0)
+	{ EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true); }
+	auto const t1 = std::chrono::steady_clock::now();
+	EXPECT_GE(t1 - t0, std::chrono::milliseconds{100});
+	EXPECT_LT(t1 - t0, std::chrono::milliseconds{500});
+	EXPECT_EQ(cb.idle_callcount, 1);
+	EXPECT_EQ(cb.ready_callcount, 0);
+}
+
+TESTCASE(west_io_fd_event_monitor_stats)
+{
+	west::io::fd_event_monitor monitor{std::chrono::milliseconds{5}};
+	EXPECT_EQ(monitor.stats(), west::io::fd_event_monitor::statistics{});
+
+	callback cb{};
+	auto pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+	monitor.add(pipe.read_end.get(), west::io::fd_event_listener_ref{cb}, west::io::listen_on::read_is_possible);
+	EXPECT_EQ(monitor.listener_count(), 1);
+	monitor.set_timeout(pipe.read_end.get(), std::chrono::milliseconds{20});
+
+	while(cb.idle_callcount == 0)
+	{ EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true); }
+	auto const iterations = monitor.stats().iterations;
+	EXPECT_GT(iterations, 0);
+	EXPECT_EQ(monitor.stats().events, 0);
+	EXPECT_EQ(monitor.stats().idle_events, 1);
+
+	REQUIRE_EQ(::write(pipe.write_end.get(), "x", 1), 1);
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(monitor.stats().iterations, iterations + 1);
+	EXPECT_EQ(monitor.stats().events, 1);
+	EXPECT_EQ(cb.ready_callcount, 1);
+	EXPECT_LE(monitor.stats().max_busy_time, monitor.stats().busy_time);
+}
+
+namespace
+{
+	struct slow_listener
+	{
+		int ready_callcount{0};
+
+		template<class... T>
+		void fd_is_ready(T&&...)
+		{
+			++ready_callcount;
+			std::this_thread::sleep_for(std::chrono::milliseconds{5});
+		}
+
+		template<class... T>
+		void fd_is_idle(T&&...)
+		{}
+	};
+}
+
+TESTCASE(west_io_fd_event_monitor_loop_metrics)
+{
+	west::io::fd_event_monitor monitor{};
+	EXPECT_EQ(monitor.loop_metrics(), nullptr);
+	monitor.enable_loop_metrics(std::chrono::milliseconds{2});
+	REQUIRE_NE(monitor.loop_metrics(), nullptr);
+	auto const& metrics = *monitor.loop_metrics();
+
+	callback fast{};
+	slow_listener slow{};
+	auto fast_pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+	auto slow_pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+	monitor.add(fast_pipe.read_end.get(), west::io::fd_event_listener_ref{fast}, west::io::listen_on::read_is_possible);
+	monitor.add(slow_pipe.read_end.get(), slow, west::io::listen_on::read_is_possible);
+
+	REQUIRE_EQ(::write(fast_pipe.write_end.get(), "x", 1), 1);
+	REQUIRE_EQ(::write(slow_pipe.write_end.get(), "x", 1), 1);
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+
+	EXPECT_EQ(metrics.wait_time_ns.count(), 1);
+	EXPECT_EQ(metrics.dispatch_time_ns.count(), 1);
+	EXPECT_GE(metrics.dispatch_time_ns.max(), 5000000);
+	EXPECT_EQ(metrics.callback_time_ns.count(), 2);
+	EXPECT_EQ(metrics.events_per_wakeup.max(), 2);
+	EXPECT_EQ(metrics.slow_callbacks.total_count(), 1);
+
+	auto const recent = metrics.slow_callbacks.recent();
+	REQUIRE_EQ(std::size(recent), 1);
+	EXPECT_EQ(recent[0].fd, slow_pipe.read_end.get());
+	EXPECT_EQ(recent[0].kind, west::io::callback_kind::fd_is_ready);
+	EXPECT_GE(recent[0].duration, std::chrono::milliseconds{5});
+	EXPECT_EQ(west::io::listener_type_name(recent[0]), "(anonymous namespace)::slow_listener");
+
+	monitor.disable_loop_metrics();
+	EXPECT_EQ(monitor.loop_metrics(), nullptr);
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(monitor.stats().events, 4);
+}
+
+TESTCASE(west_io_fd_event_monitor_set_timeout_fixed_deadline)
+{
+	west::io::fd_event_monitor monitor{};
+	callback cb{};
+	auto pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+
+	// The write end is always ready, but activity must not extend the deadline
+	monitor.add(pipe.write_end.get(), west::io::fd_event_listener_ref{cb}, west::io::listen_on::write_is_possible);
+	monitor.set_timeout(pipe.write_end.get(), std::chrono::milliseconds{100}, west::io::timeout_mode::fixed_deadline);
+
+	auto const t0 = std::chrono::steady_clock::now();
+	while(cb.idle_callcount == 0)
+	{ EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true); }
+	auto const t1 = std::chrono::steady_clock::now();
+	EXPECT_GE(t1 - t0, std::chrono::milliseconds{100});
+	EXPECT_LT(t1 - t0, std::chrono::milliseconds{500});
+	EXPECT_GT(cb.ready_callcount, 1);
+}
+
+namespace
+{
+	template<size_t Size>
+	struct sized_listener
+	{
+		sized_listener(int& destroyed):m_destroyed{&destroyed}, data{}{}
+
+		sized_listener(sized_listener&& other) noexcept:
+			m_destroyed{std::exchange(other.m_destroyed, nullptr)},
+			data{other.data}
+		{}
+
+		~sized_listener()
+		{
+			if(m_destroyed != nullptr)
+			{ ++*m_destroyed; }
+		}
+
+		void fd_is_ready(auto, west::io::fd_ref){}
+		void fd_is_idle(auto, west::io::fd_ref){}
+
+		int* m_destroyed;
+		std::array<char, Size> data;
+	};
+
+	using large_listener = sized_listener<4096>;
+}
+
+TESTCASE(west_io_fd_event_monitor_add_remove_reuses_listener_storage)
+{
+	west::io::fd_event_monitor monitor{};
+	auto pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+	int destroyed = 0;
+
+	monitor.add(pipe.read_end.get(), large_listener{destroyed}, west::io::listen_on::read_is_possible);
+	monitor.deferred_remove(pipe.read_end.get());
+	monitor.flush_fds_to_remove();
+	EXPECT_EQ(destroyed, 1);
+	auto const capacity = monitor.listener_storage_capacity();
+	EXPECT_GE(capacity, sizeof(large_listener));
+
+	// A new listener for the same fd reuses the storage of the previous one
+	auto const allocs_before = allocation_count;
+	size_t const num_iterations = 1000;
+	for(size_t k = 0; k != num_iterations; ++k)
+	{
+		monitor.add(pipe.read_end.get(), large_listener{destroyed}, west::io::listen_on::read_is_possible);
+		monitor.deferred_remove(pipe.read_end.get());
+		monitor.flush_fds_to_remove();
+	}
+	EXPECT_EQ(allocation_count - allocs_before, 0);
+	EXPECT_EQ(destroyed, static_cast<int>(num_iterations + 1));
+	EXPECT_EQ(monitor.listener_storage_capacity(), capacity);
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), false);
+
+	// Small listeners are stored inline
+	callback cb{};
+	monitor.add(pipe.write_end.get(), west::io::fd_event_listener_ref{cb}, west::io::listen_on::write_is_possible);
+	EXPECT_EQ(monitor.listener_storage_capacity(), capacity);
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(cb.ready_callcount, 1);
+}
+
+TESTCASE(west_io_fd_event_monitor_remove_releases_huge_listener_storage)
+{
+	west::io::fd_event_monitor monitor{};
+	auto pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+	int destroyed = 0;
+
+	using huge_listener = sized_listener<2*west::io::fd_event_monitor::max_kept_listener_storage>;
+	monitor.add(pipe.read_end.get(), huge_listener{destroyed}, west::io::listen_on::read_is_possible);
+	EXPECT_GE(monitor.listener_storage_capacity(), sizeof(huge_listener));
+	monitor.deferred_remove(pipe.read_end.get());
+	monitor.flush_fds_to_remove();
+	EXPECT_EQ(destroyed, 1);
+	EXPECT_EQ(monitor.listener_storage_capacity(), 0);
+
+	// Storage that is small enough is kept
+	monitor.add(pipe.read_end.get(), large_listener{destroyed}, west::io::listen_on::read_is_possible);
+	monitor.deferred_remove(pipe.read_end.get());
+	monitor.flush_fds_to_remove();
+	EXPECT_EQ(destroyed, 2);
+	EXPECT_GE(monitor.listener_storage_capacity(), sizeof(large_listener));
+}
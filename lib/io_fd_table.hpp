@@ -0,0 +1,85 @@
+#ifndef WEST_IO_FD_TABLE_HPP
+#define WEST_IO_FD_TABLE_HPP
+
+#include "./io_fd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+#include <cassert>
+
+namespace west::io
+{
+	// NOTE: Maps file descriptors to values of T. Since file descriptors are small integers, the
+	//       values are stored in pages indexed by fd, rather than in a hash table. Pages are never
+	//       moved, so a reference to a value stays valid until clear() is called, and the value of
+	//       an fd that has been closed is reused for the next fd with the same number.
+	template<class T, size_t PageSize = 256>
+	class fd_table
+	{
+	public:
+		static constexpr size_t page_size = PageSize;
+
+		// Returns the value for `fd`, or nullptr if no value has been created for `fd`
+		[[nodiscard]] T* find(fd_ref fd)
+		{
+			assert(fd.value >= 0);
+			auto const page_index = static_cast<size_t>(fd.value)/page_size;
+			if(page_index >= std::size(m_pages) || m_pages[page_index] == nullptr)
+			{ return nullptr; }
+			return &(*m_pages[page_index])[static_cast<size_t>(fd.value)%page_size];
+		}
+
+		[[nodiscard]] T const* find(fd_ref fd) const
+		{ return const_cast<fd_table*>(this)->find(fd); }
+
+		// Returns the value for `fd`. A default constructed value is created if needed.
+		[[nodiscard]] T& get(fd_ref fd)
+		{
+			assert(fd.value >= 0);
+			auto const page_index = static_cast<size_t>(fd.value)/page_size;
+			if(page_index >= std::size(m_pages))
+			{ m_pages.resize(page_index + 1); }
+
+			auto& page = m_pages[page_index];
+			if(page == nullptr)
+			{ page = std::make_unique<std::array<T, page_size>>(); }
+
+			return (*page)[static_cast<size_t>(fd.value)%page_size];
+		}
+
+		// Calls `f` with the fd and value of every created value
+		template<class Func>
+		void for_each(Func&& f)
+		{
+			for(size_t k = 0; k != std::size(m_pages); ++k)
+			{
+				if(m_pages[k] == nullptr)
+				{ continue; }
+
+				for(size_t l = 0; l != page_size; ++l)
+				{ f(fd_ref{static_cast<int>(k*page_size + l)}, (*m_pages[k])[l]); }
+			}
+		}
+
+		template<class Func>
+		void for_each(Func&& f) const
+		{ const_cast<fd_table*>(this)->for_each([&f](fd_ref fd, T const& value){ f(fd, value); }); }
+
+		void clear()
+		{ m_pages.clear(); }
+
+		[[nodiscard]] size_t page_count() const
+		{
+			return static_cast<size_t>(std::ranges::count_if(m_pages, [](auto const& item) {
+				return item != nullptr;
+			}));
+		}
+
+	private:
+		std::vector<std::unique_ptr<std::array<T, page_size>>> m_pages;
+	};
+}
+
+#endif
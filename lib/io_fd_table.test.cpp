@@ -0,0 +1,66 @@
+//@	{"target":{"name":"io_fd_table.test"}}
+
+#include "./io_fd_table.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <string>
+
+TESTCASE(west_io_fd_table_get_and_find)
+{
+	west::io::fd_table<std::string, 4> table;
+	EXPECT_EQ(table.find(west::io::fd_ref{0}), nullptr);
+	EXPECT_EQ(table.page_count(), 0);
+
+	table.get(west::io::fd_ref{9}) = "Nine";
+	EXPECT_EQ(table.page_count(), 1);
+	REQUIRE_NE(table.find(west::io::fd_ref{9}), nullptr);
+	EXPECT_EQ(*table.find(west::io::fd_ref{9}), "Nine");
+
+	// Values on the same page exist, but have not been assigned
+	REQUIRE_NE(table.find(west::io::fd_ref{8}), nullptr);
+	EXPECT_EQ(*table.find(west::io::fd_ref{8}), "");
+
+	// No page for these fds
+	EXPECT_EQ(table.find(west::io::fd_ref{0}), nullptr);
+	EXPECT_EQ(table.find(west::io::fd_ref{12}), nullptr);
+
+	table.get(west::io::fd_ref{1}) = "One";
+	EXPECT_EQ(table.page_count(), 2);
+	EXPECT_EQ(*table.find(west::io::fd_ref{1}), "One");
+
+	table.clear();
+	EXPECT_EQ(table.page_count(), 0);
+	EXPECT_EQ(table.find(west::io::fd_ref{9}), nullptr);
+}
+
+TESTCASE(west_io_fd_table_references_are_stable)
+{
+	west::io::fd_table<int, 4> table;
+	auto& first = table.get(west::io::fd_ref{2});
+	first = 2;
+
+	for(int k = 0; k != 1024; ++k)
+	{ table.get(west::io::fd_ref{k}) = k; }
+
+	EXPECT_EQ(&first, table.find(west::io::fd_ref{2}));
+	EXPECT_EQ(first, 2);
+	EXPECT_EQ(table.page_count(), 256);
+}
+
+TESTCASE(west_io_fd_table_for_each)
+{
+	west::io::fd_table<int, 4> table;
+	table.get(west::io::fd_ref{1}) = 1;
+	table.get(west::io::fd_ref{10}) = 10;
+
+	int sum = 0;
+	size_t count = 0;
+	table.for_each([&sum, &count](west::io::fd_ref fd, int value) {
+		EXPECT_EQ(value == 0 || value == fd.value, true);
+		sum += value;
+		++count;
+	});
+	EXPECT_EQ(sum, 11);
+	EXPECT_EQ(count, 8);
+}
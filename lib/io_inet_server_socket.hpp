@@ -7,10 +7,14 @@
 
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/sendfile.h>
+#include <fcntl.h>
 
 #include <cstring>
 #include <ranges>
 #include <stdexcept>
+#include <vector>
+#include <optional>
 
 namespace west::io
 {
@@ -95,11 +99,13 @@ namespace west::io
 	class inet_connection
 	{
 	public:
-		explicit inet_connection(fd_owner fd, inet_address remote_address, uint16_t remote_port):
+		explicit inet_connection(fd_owner fd, inet_address remote_address, uint16_t remote_port,
+			bool is_non_blocking = false):
 			m_fd{std::move(fd)},
 			m_remote_address{remote_address},
 			m_remote_port{remote_port},
-			m_read_disabled{false}
+			m_read_disabled{false},
+			m_is_non_blocking{is_non_blocking}
 		{ }
 
 		[[nodiscard]] auto remote_port() const
@@ -109,7 +115,13 @@ namespace west::io
 		{ return m_remote_address; }
 
 		void set_non_blocking()
-		{ io::set_non_blocking(m_fd.get()); }
+		{
+			if(!m_is_non_blocking)
+			{
+				io::set_non_blocking(m_fd.get());
+				m_is_non_blocking = true;
+			}
+		}
 
 		[[nodiscard]] read_result read(std::span<char> buffer)
 		{
@@ -157,6 +169,31 @@ namespace west::io
 			};
 		}
 
+		// NOTE: sendfile does not accept pipes as input. In that case, splice is used instead, and the
+		//       offset is ignored.
+		[[nodiscard]] write_result send_file(file_range range)
+		{
+			auto offset = range.offset;
+			auto res = ::sendfile(m_fd.get(), range.fd, &offset, range.length);
+			if(res == -1 && (errno == EINVAL || errno == ESPIPE))
+			{ res = ::splice(range.fd, nullptr, m_fd.get(), nullptr, range.length, SPLICE_F_MOVE | SPLICE_F_NONBLOCK); }
+
+			if(res == -1)
+			{
+				return write_result{
+					.bytes_written = 0,
+					.ec = (errno == EAGAIN || errno == EWOULDBLOCK)?
+						operation_result::operation_would_block:
+						operation_result::error
+				};
+			}
+
+			return write_result{
+				.bytes_written = static_cast<size_t>(res),
+				.ec = operation_result::completed
+			};
+		}
+
 		void stop_reading()
 		{
 			::shutdown(m_fd.get(), SHUT_RD);
@@ -171,18 +208,29 @@ namespace west::io
 		inet_address m_remote_address;
 		uint16_t m_remote_port;
 		bool m_read_disabled;
+		bool m_is_non_blocking;
 	};
 
+	enum class port_reuse{disabled, enabled};
+
 	class inet_server_socket
 	{
 	public:
 		explicit inet_server_socket(inet_address client_address,
 			std::ranges::iota_view<int, int> ports_to_try,
 			int listen_backlock,
-			std::optional<int> conn_send_size = {}):
+			std::optional<int> conn_send_size = {},
+			port_reuse reuse = port_reuse::disabled):
 			m_fd{create_socket(AF_INET, SOCK_STREAM, 0)},
 			m_conn_send_size{conn_send_size}
 		{
+			if(reuse == port_reuse::enabled)
+			{
+				int const enabled = 1;
+				if(::setsockopt(m_fd.get(), SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled)) == -1)
+				{ throw system_error{"Failed to set SO_REUSEPORT", errno}; }
+			}
+
 			m_port = bind(m_fd.get(), client_address, ports_to_try);
 
 			if(::listen(m_fd.get(), listen_backlock) == -1)
@@ -194,27 +242,26 @@ namespace west::io
 
 		inet_connection accept() const
 		{
-			sockaddr_in client_addr{};
-			socklen_t addr_length = sizeof(client_addr);
-			fd_owner fd{::accept(m_fd.get(), reinterpret_cast<sockaddr*>(&client_addr), &addr_length)};
-			if(fd.get() == nullptr)
+			auto ret = accept_with_flags(SOCK_CLOEXEC);
+			if(!ret.connection.has_value())
 			{ throw system_error{"Failed to establish a connection", errno}; }
+			return std::move(*ret.connection);
+		}
 
-			if(m_conn_send_size.has_value())
-			{
-				int send_size = *m_conn_send_size;
-				auto res = setsockopt(fd.get(), SOL_SOCKET, SO_SNDBUF, &send_size, sizeof(send_size));
-				if(res == -1)
-				{ throw system_error{"Failed to set SO_SNDBUF", errno}; }
-			}
-
-			return inet_connection{
-				std::move(fd),
-				inet_address{client_addr.sin_addr},
-				client_addr.sin_port
-			};
+		// Accepts a connection, or returns nullopt if there are no pending connections, or the
+		// process has run out of file descriptors. The connection is non-blocking.
+		std::optional<inet_connection> try_accept()
+		{
+			auto ret = accept_with_flags(SOCK_NONBLOCK | SOCK_CLOEXEC);
+			m_out_of_resources = ret.out_of_resources;
+			return std::move(ret.connection);
 		}
 
+		// Returns true if the most recent call to try_accept failed because the process or the system
+		// ran out of file descriptors or memory. The pending connection is then still in the backlog.
+		[[nodiscard]] bool is_out_of_resources() const
+		{ return m_out_of_resources; }
+
 		[[nodiscard]] uint16_t port() const
 		{ return m_port; }
 
@@ -222,10 +269,110 @@ namespace west::io
 		{ return m_fd.get(); }
 
 	private:
+		struct accept_result
+		{
+			std::optional<inet_connection> connection;
+			bool out_of_resources;
+		};
+
+		accept_result accept_with_flags(int flags) const
+		{
+			sockaddr_in client_addr{};
+			while(true)
+			{
+				socklen_t addr_length = sizeof(client_addr);
+				auto const res = ::accept4(m_fd.get(),
+					reinterpret_cast<sockaddr*>(&client_addr),
+					&addr_length,
+					flags);
+				if(res != -1)
+				{
+					fd_owner fd{fd_ref{res}};
+					if(m_conn_send_size.has_value())
+					{
+						int send_size = *m_conn_send_size;
+						if(setsockopt(fd.get(), SOL_SOCKET, SO_SNDBUF, &send_size, sizeof(send_size)) == -1)
+						{ throw system_error{"Failed to set SO_SNDBUF", errno}; }
+					}
+
+					return accept_result{
+						.connection = inet_connection{
+							std::move(fd),
+							inet_address{client_addr.sin_addr},
+							client_addr.sin_port,
+							(flags & SOCK_NONBLOCK) != 0
+						},
+						.out_of_resources = false
+					};
+				}
+
+				switch(errno)
+				{
+					case EAGAIN:
+#if EAGAIN != EWOULDBLOCK
+					case EWOULDBLOCK:
+#endif
+						return accept_result{.connection = std::nullopt, .out_of_resources = false};
+
+					// NOTE: Running out of file descriptors is not fatal. The pending connection is
+					//       accepted later, when some connections have been closed.
+					case EMFILE:
+					case ENFILE:
+					case ENOBUFS:
+					case ENOMEM:
+						return accept_result{.connection = std::nullopt, .out_of_resources = true};
+
+					// NOTE: The connection was aborted by the client before it was accepted
+					case ECONNABORTED:
+					case EPROTO:
+					case EINTR:
+						break;
+
+					default:
+						throw system_error{"Failed to establish a connection", errno};
+				}
+			}
+		}
+
 		fd_owner m_fd;
 		uint16_t m_port;
 		std::optional<int> m_conn_send_size;
+		bool m_out_of_resources{false};
 	};
+
+	// NOTE: All sockets share the same port. The kernel distributes incoming connections between
+	//       them.
+	[[nodiscard]] inline auto create_sharded_server_sockets(inet_address client_address,
+		std::ranges::iota_view<int, int> ports_to_try,
+		int listen_backlock,
+		size_t count,
+		std::optional<int> conn_send_size = {})
+	{
+		std::vector<inet_server_socket> ret;
+		if(count == 0)
+		{ return ret; }
+
+		ret.reserve(count);
+		ret.push_back(inet_server_socket{client_address,
+			ports_to_try,
+			listen_backlock,
+			conn_send_size,
+			port_reuse::enabled
+		});
+
+		auto const port = static_cast<int>(ret.front().port());
+		for(size_t k = 1; k != count; ++k)
+		{
+			ret.push_back(inet_server_socket{client_address,
+				std::ranges::iota_view{port, port + 1},
+				listen_backlock,
+				conn_send_size,
+				port_reuse::enabled
+			});
+		}
+
+		return ret;
+	}
 }
 
 #endif
@@ -6,6 +6,9 @@
 
 #include <thread>
 
+#include <sys/mman.h>
+#include <sys/resource.h>
+
 TESTCASE(west_io_inet_server_socket_bind_succesful)
 {
 	auto socket = west::io::create_socket(AF_INET, SOCK_STREAM, 0);
@@ -81,3 +84,145 @@ TESTCASE(west_io_inet_server_socket_accept_connection)
 	auto const write_res = connection.write(msg_out);
 	EXPECT_EQ(write_res.bytes_written, std::size(msg_out));
 }
+
+TESTCASE(west_io_inet_server_socket_try_accept)
+{
+	west::io::inet_address address{"127.0.0.1"};
+
+	west::io::inet_server_socket server{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+	server.set_non_blocking();
+
+	EXPECT_EQ(server.try_accept().has_value(), false);
+
+	std::array<west::io::fd_owner, 3> clients{};
+	for(auto& item : clients)
+	{ item = connect_to(address, server.port()); }
+
+	for(size_t k = 0; k != std::size(clients); ++k)
+	{
+		auto connection = server.try_accept();
+		REQUIRE_EQ(connection.has_value(), true);
+		EXPECT_NE(::fcntl(connection->fd(), F_GETFL) & O_NONBLOCK, 0);
+		EXPECT_NE(::fcntl(connection->fd(), F_GETFD) & FD_CLOEXEC, 0);
+	}
+
+	EXPECT_EQ(server.try_accept().has_value(), false);
+}
+
+TESTCASE(west_io_inet_server_socket_try_accept_out_of_fds)
+{
+	west::io::inet_address address{"127.0.0.1"};
+
+	west::io::inet_server_socket server{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+	server.set_non_blocking();
+	auto const client = connect_to(address, server.port());
+
+	// Lower the fd limit to the lowest free fd, so the accepted connection would exceed it
+	rlimit old_limit{};
+	REQUIRE_EQ(getrlimit(RLIMIT_NOFILE, &old_limit), 0);
+	auto const lowest_free_fd = ::dup(0);
+	REQUIRE_NE(lowest_free_fd, -1);
+	::close(lowest_free_fd);
+	rlimit new_limit{old_limit};
+	new_limit.rlim_cur = static_cast<rlim_t>(lowest_free_fd);
+	REQUIRE_EQ(setrlimit(RLIMIT_NOFILE, &new_limit), 0);
+
+	auto const res = server.try_accept();
+	auto const out_of_resources = server.is_out_of_resources();
+	REQUIRE_EQ(setrlimit(RLIMIT_NOFILE, &old_limit), 0);
+
+	EXPECT_EQ(res.has_value(), false);
+	EXPECT_EQ(out_of_resources, true);
+
+	// The connection is still pending
+	EXPECT_EQ(server.try_accept().has_value(), true);
+	EXPECT_EQ(server.is_out_of_resources(), false);
+}
+
+TESTCASE(west_io_inet_server_socket_send_file)
+{
+	west::io::inet_address address{"127.0.0.1"};
+
+	west::io::inet_server_socket server{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+
+	std::string_view const file_content{"Some file content. Sent from a file and from a pipe"};
+	std::jthread client{
+		[port = server.port(), address, file_content](){
+			auto socket = connect_to(address, port);
+			std::string received;
+			std::array<char, 64> buffer{};
+			while(true)
+			{
+				auto const n = ::read(socket.get(), std::data(buffer), std::size(buffer));
+				if(n <= 0)
+				{ break; }
+				received.append(std::data(buffer), static_cast<size_t>(n));
+			}
+			EXPECT_EQ(received, std::string{file_content.substr(5)}.append(file_content.substr(0, 10)));
+		}
+	};
+
+	// NOTE: The connection must be closed before the client is joined
+	{
+		auto connection = server.accept();
+		static_assert(west::io::file_sink<decltype(connection)>);
+
+		west::io::fd_owner file{west::io::fd_ref{::memfd_create("send_file_test", 0)}};
+		REQUIRE_EQ(::write(file.get(), std::data(file_content), std::size(file_content)),
+			static_cast<ssize_t>(std::size(file_content)));
+
+		auto const file_res = connection.send_file(west::io::file_range{
+			.fd = file.get(),
+			.offset = 5,
+			.length = std::size(file_content) - 5
+		});
+		EXPECT_EQ(file_res.ec, west::io::operation_result::completed);
+		EXPECT_EQ(file_res.bytes_written, std::size(file_content) - 5);
+
+		std::array<int, 2> pipe_fds{};
+		REQUIRE_EQ(::pipe(std::data(pipe_fds)), 0);
+		west::io::fd_owner pipe_read_end{west::io::fd_ref{pipe_fds[0]}};
+		west::io::fd_owner pipe_write_end{west::io::fd_ref{pipe_fds[1]}};
+		REQUIRE_EQ(::write(pipe_write_end.get(), std::data(file_content), 10), 10);
+
+		auto const pipe_res = connection.send_file(west::io::file_range{
+			.fd = pipe_read_end.get(),
+			.offset = 0,
+			.length = 10
+		});
+		EXPECT_EQ(pipe_res.ec, west::io::operation_result::completed);
+		EXPECT_EQ(pipe_res.bytes_written, 10);
+	}
+}
+
+TESTCASE(west_io_inet_server_socket_create_sharded_server_sockets)
+{
+	west::io::inet_address address{"127.0.0.1"};
+
+	auto sockets = west::io::create_sharded_server_sockets(address,
+		std::ranges::iota_view{49152, 65536},
+		128,
+		4);
+
+	EXPECT_EQ(std::size(sockets), 4);
+	auto const port = sockets.front().port();
+	for(auto const& item : sockets)
+	{ EXPECT_EQ(item.port(), port); }
+
+	EXPECT_EQ(std::size(west::io::create_sharded_server_sockets(address,
+		std::ranges::iota_view{49152, 65536},
+		128,
+		0)), 0);
+}
@@ -4,6 +4,9 @@
 #include <concepts>
 #include <cstddef>
 #include <span>
+#include <chrono>
+
+#include <sys/types.h>
 
 namespace west::io
 {
@@ -36,6 +39,31 @@ namespace west::io
 		{x.write(y)} -> std::same_as<write_result>;
 	};
 
+	// A range of bytes within a file, that a file_sink can write without copying it to user space
+	struct file_range
+	{
+		int fd;
+		off_t offset;
+		size_t length;
+	};
+
+	template<class T>
+	concept file_sink = requires(T x, file_range y)
+	{
+		{x.send_file(y)} -> std::same_as<write_result>;
+	};
+
+	enum class timeout_mode{restart_on_activity, fixed_deadline};
+
+	struct fd_timeout
+	{
+		std::chrono::milliseconds duration;
+		timeout_mode mode;
+
+		constexpr bool operator==(fd_timeout const&) const = default;
+		constexpr bool operator!=(fd_timeout const&) const = default;
+	};
+
 	template<class T>
 	concept socket = requires(T x, std::span<char> y, std::span<char const> z)
 	{
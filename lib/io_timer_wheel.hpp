@@ -0,0 +1,198 @@
+#ifndef WEST_IO_TIMER_WHEEL_HPP
+#define WEST_IO_TIMER_WHEEL_HPP
+
+#include "./io_fd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+
+namespace west::io
+{
+	// NOTE: Time is measured in ticks. A deadline is never reported before its tick has been
+	//       reached, but it may be reported up to one tick late.
+	class timer_wheel
+	{
+	public:
+		static constexpr size_t slot_bits = 6;
+		static constexpr size_t slots_per_level = static_cast<size_t>(1) << slot_bits;
+		static constexpr size_t num_levels = 4;
+		static constexpr uint64_t max_delay = (static_cast<uint64_t>(1) << (slot_bits*num_levels)) - 1;
+
+		struct entry
+		{
+			entry* prev{nullptr};
+			entry* next{nullptr};
+			uint64_t deadline{0};
+			fd_ref fd;
+
+			bool is_armed() const
+			{ return prev != nullptr; }
+		};
+
+		explicit timer_wheel(uint64_t current_tick = 0):
+			m_current_tick{current_tick},
+			m_occupied{}
+		{
+			for(auto& level : m_slots)
+			{
+				for(auto& slot : level)
+				{ slot.prev = slot.next = &slot; }
+			}
+		}
+
+		timer_wheel(timer_wheel const&) = delete;
+		timer_wheel& operator=(timer_wheel const&) = delete;
+
+		[[nodiscard]] uint64_t current_tick() const
+		{ return m_current_tick; }
+
+		void arm(entry& e, uint64_t deadline)
+		{
+			if(e.is_armed())
+			{ unlink(e); }
+
+			e.deadline = std::max(deadline, m_current_tick + 1);
+			link(e);
+		}
+
+		void disarm(entry& e)
+		{
+			if(e.is_armed())
+			{ unlink(e); }
+		}
+
+		// Moves the wheel forward to `tick`, calling `on_expired` for every entry that expires. The
+		// entry is disarmed before the callback is called, so it can be re-armed by the callback.
+		template<class Callback>
+		void advance(uint64_t tick, Callback&& on_expired)
+		{
+			while(m_current_tick < tick)
+			{
+				// Nothing happens before the next expiry, so there is no need to step through those ticks
+				auto const next = next_expiry();
+				if(!next.has_value() || *next > tick)
+				{
+					m_current_tick = tick;
+					return;
+				}
+
+				m_current_tick = *next;
+				for(size_t level = num_levels - 1; level != 0; --level)
+				{
+					auto const shift = slot_bits*level;
+					if((m_current_tick & ((static_cast<uint64_t>(1) << shift) - 1)) == 0)
+					{ cascade(level, (m_current_tick >> shift) & (slots_per_level - 1)); }
+				}
+
+				auto const slot_index = m_current_tick & (slots_per_level - 1);
+				auto& slot = m_slots[0][slot_index];
+				while(slot.next != &slot)
+				{
+					auto& e = *slot.next;
+					assert(e.deadline <= m_current_tick);
+					unlink(e);
+					on_expired(e);
+				}
+			}
+		}
+
+		// Returns the earliest tick at which advance may report an expired entry
+		[[nodiscard]] std::optional<uint64_t> next_expiry() const
+		{
+			std::optional<uint64_t> ret;
+			for(size_t level = 0; level != num_levels; ++level)
+			{
+				auto const occupied = m_occupied[level];
+				if(occupied == 0)
+				{ continue; }
+
+				auto const shift = slot_bits*level;
+				auto const cursor = (m_current_tick >> shift) & (slots_per_level - 1);
+				auto const rotated = std::rotr(occupied, static_cast<int>(cursor + 1));
+				auto const distance = static_cast<uint64_t>(std::countr_zero(rotated)) + 1;
+
+				// Start of the window covered by the first occupied slot. At level 0 this is the
+				// deadline. At higher levels it is when the slot is cascaded.
+				auto const window_start = ((m_current_tick >> shift) + distance) << shift;
+				ret = std::min(ret.value_or(window_start), window_start);
+			}
+			return ret;
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			for(auto const item : m_occupied)
+			{
+				if(item != 0)
+				{ return false; }
+			}
+			return true;
+		}
+
+	private:
+		void link(entry& e)
+		{
+			auto const delay = std::min(e.deadline - m_current_tick, max_delay);
+			auto const deadline = m_current_tick + delay;
+			size_t level = 0;
+			while(delay >= (static_cast<uint64_t>(1) << (slot_bits*(level + 1))))
+			{ ++level; }
+
+			auto const slot_index = (deadline >> (slot_bits*level)) & (slots_per_level - 1);
+			auto& slot = m_slots[level][slot_index];
+			e.prev = slot.prev;
+			e.next = &slot;
+			slot.prev->next = &e;
+			slot.prev = &e;
+			m_occupied[level] |= static_cast<uint64_t>(1) << slot_index;
+		}
+
+		void unlink(entry& e)
+		{
+			auto const next = e.next;
+			e.prev->next = next;
+			next->prev = e.prev;
+			e.prev = nullptr;
+			e.next = nullptr;
+
+			// If the slot became empty, `next` is the slot head. Its own links point to itself.
+			if(next->next == next)
+			{ clear_occupied(*next); }
+		}
+
+		void clear_occupied(entry const& slot)
+		{
+			for(size_t level = 0; level != num_levels; ++level)
+			{
+				auto const& slots = m_slots[level];
+				if(&slot >= std::data(slots) && &slot < std::data(slots) + std::size(slots))
+				{
+					auto const index = static_cast<size_t>(&slot - std::data(slots));
+					m_occupied[level] &= ~(static_cast<uint64_t>(1) << index);
+					return;
+				}
+			}
+		}
+
+		void cascade(size_t level, uint64_t slot_index)
+		{
+			auto& slot = m_slots[level][slot_index];
+			while(slot.next != &slot)
+			{
+				auto& e = *slot.next;
+				unlink(e);
+				link(e);
+			}
+		}
+
+		uint64_t m_current_tick;
+		std::array<uint64_t, num_levels> m_occupied;
+		std::array<std::array<entry, slots_per_level>, num_levels> m_slots;
+	};
+}
+
+#endif
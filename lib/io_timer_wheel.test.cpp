@@ -0,0 +1,127 @@
+//@	{"target":{"name":"io_timer_wheel.test"}}
+
+#include "./io_timer_wheel.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <vector>
+#include <random>
+
+TESTCASE(west_io_timer_wheel_empty)
+{
+	west::io::timer_wheel wheel{123};
+	EXPECT_EQ(wheel.empty(), true);
+	EXPECT_EQ(wheel.current_tick(), 123);
+	EXPECT_EQ(wheel.next_expiry().has_value(), false);
+
+	wheel.advance(456, [](auto&){ abort(); });
+	EXPECT_EQ(wheel.current_tick(), 456);
+}
+
+TESTCASE(west_io_timer_wheel_arm_and_expire)
+{
+	west::io::timer_wheel wheel{0};
+	west::io::timer_wheel::entry a{};
+	west::io::timer_wheel::entry b{};
+	a.fd = west::io::fd_ref{1};
+	b.fd = west::io::fd_ref{2};
+
+	wheel.arm(a, 10);
+	wheel.arm(b, 5000);
+	EXPECT_EQ(a.is_armed(), true);
+	EXPECT_EQ(wheel.next_expiry(), 10);
+
+	std::vector<int> expired;
+	auto const on_expired = [&expired](west::io::timer_wheel::entry& e){
+		EXPECT_EQ(e.is_armed(), false);
+		expired.push_back(e.fd.value);
+	};
+
+	wheel.advance(9, on_expired);
+	EXPECT_EQ(std::size(expired), 0);
+
+	wheel.advance(10, on_expired);
+	REQUIRE_EQ(std::size(expired), 1);
+	EXPECT_EQ(expired[0], 1);
+
+	wheel.advance(4999, on_expired);
+	EXPECT_EQ(std::size(expired), 1);
+
+	wheel.advance(5000, on_expired);
+	REQUIRE_EQ(std::size(expired), 2);
+	EXPECT_EQ(expired[1], 2);
+	EXPECT_EQ(wheel.empty(), true);
+}
+
+TESTCASE(west_io_timer_wheel_rearm_and_disarm)
+{
+	west::io::timer_wheel wheel{0};
+	west::io::timer_wheel::entry a{};
+	west::io::timer_wheel::entry b{};
+
+	wheel.arm(a, 10);
+	wheel.arm(b, 20);
+	wheel.arm(a, 30);
+	wheel.disarm(b);
+	EXPECT_EQ(b.is_armed(), false);
+	EXPECT_EQ(wheel.next_expiry(), 30);
+
+	size_t callcount = 0;
+	wheel.advance(29, [&callcount](auto&){ ++callcount; });
+	EXPECT_EQ(callcount, 0);
+
+	// An entry re-armed from the callback is not reported again during the same call
+	wheel.advance(100, [&callcount, &wheel](auto& e){
+		++callcount;
+		wheel.arm(e, 1000);
+	});
+	EXPECT_EQ(callcount, 1);
+	EXPECT_EQ(a.is_armed(), true);
+	EXPECT_EQ(a.deadline, 1000);
+}
+
+TESTCASE(west_io_timer_wheel_deadline_in_the_past)
+{
+	west::io::timer_wheel wheel{100};
+	west::io::timer_wheel::entry a{};
+	wheel.arm(a, 50);
+	EXPECT_EQ(a.deadline, 101);
+	EXPECT_EQ(wheel.next_expiry(), 101);
+}
+
+TESTCASE(west_io_timer_wheel_never_early_never_late)
+{
+	std::mt19937 rng;
+	std::uniform_int_distribution<uint64_t> delay{1, 300000};
+	std::uniform_int_distribution<uint64_t> step{1, 5000};
+
+	west::io::timer_wheel wheel{1234567};
+	std::vector<west::io::timer_wheel::entry> entries(1024);
+	for(auto& item : entries)
+	{ wheel.arm(item, wheel.current_tick() + delay(rng)); }
+
+	size_t num_expired = 0;
+	while(!wheel.empty())
+	{
+		auto const next = wheel.next_expiry();
+		REQUIRE_EQ(next.has_value(), true);
+		EXPECT_GT(*next, wheel.current_tick());
+
+		auto const target = wheel.current_tick() + step(rng);
+		wheel.advance(target, [&num_expired, target](auto const& e){
+			EXPECT_LE(e.deadline, target);
+			++num_expired;
+		});
+
+		// Everything that is still armed must expire later
+		for(auto const& item : entries)
+		{
+			if(item.is_armed())
+			{
+				EXPECT_GT(item.deadline, target);
+				EXPECT_LE(*wheel.next_expiry(), item.deadline);
+			}
+		}
+	}
+	EXPECT_EQ(num_expired, std::size(entries));
+}
@@ -0,0 +1,305 @@
+#ifndef WEST_IO_URING_EVENT_MONITOR_HPP
+#define WEST_IO_URING_EVENT_MONITOR_HPP
+
+#include "./io_fd_event_monitor.hpp"
+#include "./io_fd_table.hpp"
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <poll.h>
+
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+namespace west::io
+{
+	class mapped_memory
+	{
+	public:
+		mapped_memory() = default;
+
+		explicit mapped_memory(fd_ref fd, size_t size, off_t offset):
+			m_size{size}
+		{
+			auto const ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+			if(ptr == MAP_FAILED)
+			{ throw system_error{"Failed to map io_uring memory", errno}; }
+			m_ptr = static_cast<std::byte*>(ptr);
+		}
+
+		mapped_memory(mapped_memory&& other) noexcept:
+			m_ptr{std::exchange(other.m_ptr, nullptr)},
+			m_size{std::exchange(other.m_size, 0)}
+		{}
+
+		mapped_memory& operator=(mapped_memory&& other) noexcept
+		{
+			std::swap(m_ptr, other.m_ptr);
+			std::swap(m_size, other.m_size);
+			return *this;
+		}
+
+		~mapped_memory()
+		{
+			if(m_ptr != nullptr)
+			{ ::munmap(m_ptr, m_size); }
+		}
+
+		template<class T>
+		T* at(size_t offset) const
+		{ return reinterpret_cast<T*>(m_ptr + offset); }
+
+	private:
+		std::byte* m_ptr{nullptr};
+		size_t m_size{0};
+	};
+
+	// NOTE: Uses one-shot IORING_OP_POLL_ADD requests, which are re-armed before the next wait. This
+	//       gives the same level-triggered semantics as epoll, while all (re-)registrations and the
+	//       wait itself are batched into a single io_uring_enter call.
+	class io_uring_poller
+	{
+	public:
+		static constexpr unsigned int queue_depth = 4096;
+
+		// NOTE: One-shot polls are always level-triggered
+		static constexpr bool supports_edge_triggered = false;
+
+		io_uring_poller():
+			m_next_generation{1}
+		{
+			io_uring_params params{};
+			m_fd = fd_owner{fd_ref{static_cast<int>(::syscall(__NR_io_uring_setup, queue_depth, &params))}};
+			if(m_fd == nullptr)
+			{ throw system_error{"Failed to create io_uring instance", errno}; }
+
+			if(!(params.features & IORING_FEAT_EXT_ARG))
+			{ throw std::runtime_error{"io_uring does not support IORING_FEAT_EXT_ARG"}; }
+
+			auto const sq_size = params.sq_off.array + params.sq_entries*sizeof(uint32_t);
+			auto const cq_size = params.cq_off.cqes + params.cq_entries*sizeof(io_uring_cqe);
+			if(params.features & IORING_FEAT_SINGLE_MMAP)
+			{ m_sq_ring = mapped_memory{m_fd.get(), std::max(sq_size, cq_size), IORING_OFF_SQ_RING}; }
+			else
+			{
+				m_sq_ring = mapped_memory{m_fd.get(), sq_size, IORING_OFF_SQ_RING};
+				m_cq_ring = mapped_memory{m_fd.get(), cq_size, IORING_OFF_CQ_RING};
+			}
+			auto const& cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP)? m_sq_ring : m_cq_ring;
+			m_sqes = mapped_memory{m_fd.get(), params.sq_entries*sizeof(io_uring_sqe), IORING_OFF_SQES};
+
+			m_sq = submission_queue{
+				.head = m_sq_ring.at<unsigned int>(params.sq_off.head),
+				.tail = m_sq_ring.at<unsigned int>(params.sq_off.tail),
+				.mask = *m_sq_ring.at<unsigned int>(params.sq_off.ring_mask),
+				.entries = params.sq_entries,
+				.array = m_sq_ring.at<unsigned int>(params.sq_off.array),
+				.sqes = m_sqes.at<io_uring_sqe>(0),
+				.pending = 0
+			};
+
+			m_cq = completion_queue{
+				.head = cq_ring.at<unsigned int>(params.cq_off.head),
+				.tail = cq_ring.at<unsigned int>(params.cq_off.tail),
+				.mask = *cq_ring.at<unsigned int>(params.cq_off.ring_mask),
+				.cqes = cq_ring.at<io_uring_cqe>(params.cq_off.cqes)
+			};
+		}
+
+		void add(fd_ref fd, listen_on events, uint64_t token)
+		{
+			auto& item = m_entries.get(fd);
+			assert(!item.registered);
+			item = entry{.user_data = 0, .events = events, .token = token, .registered = true};
+			arm(fd, item);
+		}
+
+		void modify(fd_ref fd, listen_on new_events, uint64_t token)
+		{
+			auto const i = m_entries.find(fd);
+			assert(i != nullptr && i->registered);
+			auto& item = *i;
+			item.events = new_events;
+			item.token = token;
+			if(item.user_data != 0)
+			{
+				cancel(item.user_data);
+				arm(fd, item);
+			}
+		}
+
+		void remove(fd_ref fd)
+		{
+			auto const i = m_entries.find(fd);
+			if(i == nullptr || !i->registered)
+			{ return; }
+
+			if(i->user_data != 0)
+			{ cancel(i->user_data); }
+
+			*i = entry{};
+		}
+
+		// Returns the number of system calls made through this poller. Registrations are batched
+		// with the wait, so this is the number of calls to io_uring_enter.
+		[[nodiscard]] size_t syscall_count() const
+		{ return m_enter_call_count; }
+
+		template<class EventHandler>
+		void wait_for_events(size_t, int timeout, EventHandler&& on_event)
+		{
+			for(auto fd : m_fds_to_rearm)
+			{
+				if(auto const i = m_entries.find(fd); i != nullptr && i->registered && i->user_data == 0)
+				{ arm(fd, *i); }
+			}
+			m_fds_to_rearm.clear();
+
+			__kernel_timespec ts{
+				.tv_sec = timeout/1000,
+				.tv_nsec = (timeout%1000)*1000000ll
+			};
+			io_uring_getevents_arg arg{
+				.sigmask = 0,
+				.sigmask_sz = 0,
+				.pad = 0,
+				.ts = reinterpret_cast<uint64_t>(&ts)
+			};
+
+			if(enter(m_sq.pending, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg)) == -1
+				&& errno != ETIME && errno != EINTR)
+			{ throw system_error{"io_uring_enter failed", errno}; }
+			m_sq.pending = 0;
+
+			auto head = std::atomic_ref{*m_cq.head}.load(std::memory_order_relaxed);
+			auto const tail = std::atomic_ref{*m_cq.tail}.load(std::memory_order_acquire);
+			while(head != tail)
+			{
+				auto const& cqe = m_cq.cqes[head & m_cq.mask];
+				++head;
+				auto const user_data = cqe.user_data;
+				auto const res = cqe.res;
+				std::atomic_ref{*m_cq.head}.store(head, std::memory_order_release);
+
+				if(user_data == 0)
+				{ continue; }
+
+				auto const fd = fd_ref{static_cast<int>(user_data & 0xffff'ffff)};
+				auto const i = m_entries.find(fd);
+				if(i == nullptr || i->user_data != user_data)
+				{ continue; }
+
+				i->user_data = 0;
+				if(res < 0)
+				{
+					if(res != -ECANCELED)
+					{ throw system_error{"Failed to poll file descriptor", -res}; }
+					continue;
+				}
+
+				m_fds_to_rearm.push_back(fd);
+				on_event(i->token);
+			}
+		}
+
+	private:
+		struct entry
+		{
+			uint64_t user_data{0};
+			listen_on events{listen_on::read_is_possible};
+			uint64_t token{0};
+			bool registered{false};
+		};
+
+		struct submission_queue
+		{
+			unsigned int* head;
+			unsigned int* tail;
+			unsigned int mask;
+			unsigned int entries;
+			unsigned int* array;
+			io_uring_sqe* sqes;
+			unsigned int pending;
+		};
+
+		struct completion_queue
+		{
+			unsigned int* head;
+			unsigned int* tail;
+			unsigned int mask;
+			io_uring_cqe* cqes;
+		};
+
+		int enter(unsigned int to_submit, unsigned int min_complete, unsigned int flags, void* arg, size_t argsize)
+		{
+			++m_enter_call_count;
+			return static_cast<int>(::syscall(__NR_io_uring_enter,
+				m_fd.get(), to_submit, min_complete, flags, arg, argsize));
+		}
+
+		io_uring_sqe& get_sqe()
+		{
+			auto const head = std::atomic_ref{*m_sq.head}.load(std::memory_order_acquire);
+			auto const tail = *m_sq.tail;
+			if(tail - head == m_sq.entries)
+			{
+				if(enter(m_sq.pending, 0, 0, nullptr, 0) == -1)
+				{ throw system_error{"io_uring_enter failed", errno}; }
+				m_sq.pending = 0;
+			}
+
+			auto const index = tail & m_sq.mask;
+			auto& ret = m_sq.sqes[index];
+			memset(&ret, 0, sizeof(ret));
+			m_sq.array[index] = index;
+			return ret;
+		}
+
+		void push_sqe()
+		{
+			++m_sq.pending;
+			std::atomic_ref{*m_sq.tail}.store(*m_sq.tail + 1, std::memory_order_release);
+		}
+
+		void arm(fd_ref fd, entry& item)
+		{
+			item.user_data = (m_next_generation << 32) | static_cast<uint32_t>(fd.value);
+			++m_next_generation;
+
+			auto& sqe = get_sqe();
+			sqe.opcode = IORING_OP_POLL_ADD;
+			sqe.fd = fd;
+			sqe.poll32_events = static_cast<uint32_t>(item.events);
+			sqe.user_data = item.user_data;
+			push_sqe();
+		}
+
+		void cancel(uint64_t user_data)
+		{
+			auto& sqe = get_sqe();
+			sqe.opcode = IORING_OP_POLL_REMOVE;
+			sqe.fd = -1;
+			sqe.addr = user_data;
+			sqe.user_data = 0;
+			push_sqe();
+		}
+
+		fd_owner m_fd;
+		mapped_memory m_sq_ring;
+		mapped_memory m_cq_ring;
+		mapped_memory m_sqes;
+		submission_queue m_sq;
+		completion_queue m_cq;
+		uint64_t m_next_generation;
+		fd_table<entry> m_entries;
+		std::vector<fd_ref> m_fds_to_rearm;
+		size_t m_enter_call_count{0};
+	};
+
+	using io_uring_event_monitor = basic_fd_event_monitor<io_uring_poller>;
+}
+
+#endif
@@ -0,0 +1,200 @@
+//@	{"target":{"name":"io_uring_event_monitor.test"}}
+
+#include "./io_uring_event_monitor.hpp"
+#include "./service_registry.hpp"
+#include "./io_inet_server_socket.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <thread>
+#include <chrono>
+
+namespace
+{
+	struct callback
+	{
+		int ready_callcount{0};
+		int idle_callcount{0};
+
+		template<class... T>
+		void fd_is_ready(T&&...)
+		{ ++ready_callcount; }
+
+		template<class... T>
+		void fd_is_idle(T&&...)
+		{ ++idle_callcount; }
+	};
+
+	struct remove_on_ready
+	{
+		int* ready_callcount;
+
+		template<class Registry>
+		void fd_is_ready(Registry registry, west::io::fd_ref fd)
+		{
+			++(*ready_callcount);
+			registry.remove(fd);
+		}
+
+		template<class... T>
+		void fd_is_idle(T&&...)
+		{ }
+	};
+}
+
+TESTCASE(west_io_uring_event_monitor_monitor_pipe_read_end)
+{
+	west::io::io_uring_event_monitor monitor{};
+	auto pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+
+	callback read_activated{};
+
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), false);
+
+	monitor.add(pipe.read_end.get(), west::io::fd_event_listener_ref{read_activated},
+		west::io::listen_on::read_is_possible);
+
+	// Nothing to read. The monitor should time out.
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(read_activated.ready_callcount, 0);
+
+	{
+		std::string_view buffer{"Hello, World"};
+		auto res = ::write(pipe.write_end.get(), std::data(buffer), std::size(buffer));
+		EXPECT_EQ(res, std::ssize(buffer));
+	}
+
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(read_activated.ready_callcount, 1);
+
+	// Listener is still active since there is more data to read
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(read_activated.ready_callcount, 2);
+
+	std::array<char, 12> buffer{};
+	EXPECT_EQ(::read(pipe.read_end.get(), std::data(buffer), std::size(buffer)), std::ssize(buffer));
+
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(read_activated.ready_callcount, 2);
+	EXPECT_EQ(read_activated.idle_callcount, 0);
+}
+
+TESTCASE(west_io_uring_event_monitor_modify)
+{
+	west::io::io_uring_event_monitor monitor{};
+	auto pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+
+	callback cb{};
+	monitor.add(pipe.write_end.get(), west::io::fd_event_listener_ref{cb},
+		west::io::listen_on::read_is_possible);
+
+	// The write end will never become readable
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(cb.ready_callcount, 0);
+
+	monitor.modify(pipe.write_end.get(), west::io::listen_on::write_is_possible);
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(cb.ready_callcount, 1);
+}
+
+TESTCASE(west_io_uring_event_monitor_remove)
+{
+	west::io::io_uring_event_monitor monitor{};
+	auto pipe = west::io::create_pipe(O_NONBLOCK | O_DIRECT);
+
+	int ready_callcount = 0;
+	monitor.add(pipe.write_end.get(), remove_on_ready{&ready_callcount},
+		west::io::listen_on::write_is_possible);
+
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), true);
+	EXPECT_EQ(ready_callcount, 1);
+	EXPECT_EQ(monitor.wait_for_and_dispatch_events(), false);
+	EXPECT_EQ(ready_callcount, 1);
+}
+
+namespace
+{
+	enum class session_status{close_connection, keep_connection};
+
+	constexpr bool is_session_terminated(session_status status)
+	{ return status == session_status::close_connection; }
+
+	struct session
+	{
+		west::io::inet_connection connection;
+		west::io::fd_callback_registry_ref<west::io::io_uring_event_monitor> event_monitor;
+
+		session_status socket_is_ready()
+		{
+			std::array<char, 256> buffer{};
+			while(true)
+			{
+				auto res = connection.read(buffer);
+				if(res.bytes_read != 0)
+				{
+					std::string_view const str{std::data(buffer), res.bytes_read};
+					if(str == "shutdown")
+					{ event_monitor.clear(); }
+					else
+					{ (void)connection.write(str); }
+				}
+				else
+				{
+					return res.ec == west::io::operation_result::operation_would_block?
+						session_status::keep_connection : session_status::close_connection;
+				}
+			}
+		}
+
+		session_status socket_is_idle()
+		{ return session_status::close_connection; }
+	};
+
+	struct factory
+	{
+		west::io::fd_callback_registry_ref<west::io::io_uring_event_monitor> event_monitor;
+
+		auto create_session(west::io::inet_connection&& connection)
+		{ return session{std::move(connection), event_monitor}; }
+	};
+}
+
+template<>
+struct west::session_state_mapper<session_status>
+{
+	template<class T>
+	constexpr auto operator()(T) const
+	{ return io::listen_on::read_is_possible; }
+};
+
+TESTCASE(west_io_uring_event_monitor_service_registry)
+{
+	west::io::inet_address address{"127.0.0.1"};
+	west::io::inet_server_socket server_socket{
+		address,
+		std::ranges::iota_view{49152, 65536},
+		128
+	};
+
+	auto const server_port = server_socket.port();
+	std::jthread server_thread{[server_socket = std::move(server_socket)]() mutable {
+		west::basic_service_registry<west::io::io_uring_event_monitor> registry{};
+		registry
+			.enroll(std::move(server_socket), factory{registry.fd_callback_registry()})
+			.process_events();
+	}};
+
+	for(size_t k = 0; k != 16; ++k)
+	{
+		auto socket = connect_to(address, server_port);
+		std::string_view msg{"Hello, World"};
+		EXPECT_EQ(::write(socket.get(), std::data(msg), std::size(msg)), std::ssize(msg));
+		std::array<char, 12> buffer{};
+		EXPECT_EQ(::read(socket.get(), std::data(buffer), std::size(buffer)), std::ssize(msg));
+		EXPECT_EQ((std::string_view{std::data(buffer), std::size(buffer)}), msg);
+	}
+
+	auto socket = connect_to(address, server_port);
+	std::string_view buffer{"shutdown"};
+	EXPECT_EQ(::write(socket.get(), std::data(buffer), std::size(buffer)), std::ssize(buffer));
+}
@@ -0,0 +1,143 @@
+#ifndef WEST_LATENCY_HISTOGRAM_HPP
+#define WEST_LATENCY_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace west
+{
+	// NOTE: A log-linear histogram in the style of HdrHistogram. Values below 2^SubBucketBits are
+	//       recorded exactly. Larger values are recorded with SubBucketBits - 1 significant bits, so
+	//       the relative error is at most 2^(1 - SubBucketBits). The size of the histogram does not
+	//       depend on the range of recorded values, and recording a value never allocates memory.
+	template<unsigned int SubBucketBits>
+	class basic_latency_histogram
+	{
+	public:
+		static_assert(SubBucketBits >= 2 && SubBucketBits < 32);
+
+		static constexpr uint64_t sub_bucket_count = static_cast<uint64_t>(1) << SubBucketBits;
+		static constexpr uint64_t half_sub_bucket_count = sub_bucket_count/2;
+		static constexpr size_t bucket_count = sub_bucket_count + (64 - SubBucketBits)*half_sub_bucket_count;
+
+		basic_latency_histogram():
+			m_counts(bucket_count),
+			m_total_count{0},
+			m_min{std::numeric_limits<uint64_t>::max()},
+			m_max{0},
+			m_sum{0.0}
+		{}
+
+		void record(uint64_t value, uint64_t count = 1)
+		{
+			m_counts[index_of(value)] += count;
+			m_total_count += count;
+			m_min = std::min(m_min, value);
+			m_max = std::max(m_max, value);
+			m_sum += static_cast<double>(value)*static_cast<double>(count);
+		}
+
+		void merge(basic_latency_histogram const& other)
+		{
+			for(size_t k = 0; k != bucket_count; ++k)
+			{ m_counts[k] += other.m_counts[k]; }
+			m_total_count += other.m_total_count;
+			m_min = std::min(m_min, other.m_min);
+			m_max = std::max(m_max, other.m_max);
+			m_sum += other.m_sum;
+		}
+
+		void reset()
+		{
+			std::ranges::fill(m_counts, 0);
+			m_total_count = 0;
+			m_min = std::numeric_limits<uint64_t>::max();
+			m_max = 0;
+			m_sum = 0.0;
+		}
+
+		[[nodiscard]] uint64_t count() const
+		{ return m_total_count; }
+
+		[[nodiscard]] uint64_t min() const
+		{ return m_total_count == 0? 0 : m_min; }
+
+		[[nodiscard]] uint64_t max() const
+		{ return m_max; }
+
+		[[nodiscard]] double mean() const
+		{ return m_total_count == 0? 0.0 : m_sum/static_cast<double>(m_total_count); }
+
+		// Returns the smallest recorded value that is greater than or equal to `percentile` percent
+		// of all recorded values, rounded up to the end of its bucket. The result never exceeds
+		// max().
+		[[nodiscard]] uint64_t value_at_percentile(double percentile) const
+		{
+			if(m_total_count == 0)
+			{ return 0; }
+
+			auto const fraction = std::clamp(percentile, 0.0, 100.0)/100.0;
+			auto const target = std::max(
+				static_cast<uint64_t>(std::ceil(fraction*static_cast<double>(m_total_count))),
+				static_cast<uint64_t>(1));
+
+			uint64_t sum = 0;
+			for(size_t k = 0; k != bucket_count; ++k)
+			{
+				sum += m_counts[k];
+				if(sum >= target)
+				{ return std::clamp(highest_equivalent_value(k), m_min, m_max); }
+			}
+
+			return m_max;
+		}
+
+		static constexpr size_t index_of(uint64_t value)
+		{
+			if(value < sub_bucket_count)
+			{ return static_cast<size_t>(value); }
+
+			auto const shift = static_cast<unsigned int>(std::bit_width(value)) - SubBucketBits;
+			auto const top = value >> shift;
+			return static_cast<size_t>(sub_bucket_count
+				+ (shift - 1)*half_sub_bucket_count
+				+ (top - half_sub_bucket_count));
+		}
+
+		static constexpr uint64_t lowest_equivalent_value(size_t index)
+		{
+			if(index < sub_bucket_count)
+			{ return index; }
+
+			auto const offset = index - sub_bucket_count;
+			auto const shift = offset/half_sub_bucket_count + 1;
+			auto const top = offset%half_sub_bucket_count + half_sub_bucket_count;
+			return top << shift;
+		}
+
+		static constexpr uint64_t highest_equivalent_value(size_t index)
+		{
+			if(index < sub_bucket_count)
+			{ return index; }
+
+			auto const shift = (index - sub_bucket_count)/half_sub_bucket_count + 1;
+			return lowest_equivalent_value(index) + ((static_cast<uint64_t>(1) << shift) - 1);
+		}
+
+	private:
+		std::vector<uint64_t> m_counts;
+		uint64_t m_total_count;
+		uint64_t m_min;
+		uint64_t m_max;
+		double m_sum;
+	};
+
+	using latency_histogram = basic_latency_histogram<8>;
+}
+
+#endif
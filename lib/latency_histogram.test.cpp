@@ -0,0 +1,90 @@
+//@	{"target":{"name":"latency_histogram.test"}}
+
+#include "./latency_histogram.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <random>
+
+TESTCASE(west_latency_histogram_empty)
+{
+	west::latency_histogram hist;
+	EXPECT_EQ(hist.count(), 0);
+	EXPECT_EQ(hist.min(), 0);
+	EXPECT_EQ(hist.max(), 0);
+	EXPECT_EQ(hist.mean(), 0.0);
+	EXPECT_EQ(hist.value_at_percentile(50.0), 0);
+}
+
+TESTCASE(west_latency_histogram_small_values_are_exact)
+{
+	west::latency_histogram hist;
+	for(uint64_t k = 1; k != 101; ++k)
+	{ hist.record(k); }
+
+	EXPECT_EQ(hist.count(), 100);
+	EXPECT_EQ(hist.min(), 1);
+	EXPECT_EQ(hist.max(), 100);
+	EXPECT_EQ(hist.mean(), 50.5);
+	EXPECT_EQ(hist.value_at_percentile(0.0), 1);
+	EXPECT_EQ(hist.value_at_percentile(50.0), 50);
+	EXPECT_EQ(hist.value_at_percentile(99.0), 99);
+	EXPECT_EQ(hist.value_at_percentile(100.0), 100);
+}
+
+TESTCASE(west_latency_histogram_buckets_cover_all_values)
+{
+	using hist = west::latency_histogram;
+	EXPECT_EQ(hist::index_of(0), 0);
+	EXPECT_EQ(hist::index_of(std::numeric_limits<uint64_t>::max()), hist::bucket_count - 1);
+	EXPECT_EQ(hist::highest_equivalent_value(hist::bucket_count - 1), std::numeric_limits<uint64_t>::max());
+
+	// Adjacent buckets must not overlap or leave gaps
+	for(size_t k = 1; k != hist::bucket_count; ++k)
+	{
+		EXPECT_EQ(hist::lowest_equivalent_value(k), hist::highest_equivalent_value(k - 1) + 1);
+		EXPECT_EQ(hist::index_of(hist::lowest_equivalent_value(k)), k);
+		EXPECT_EQ(hist::index_of(hist::highest_equivalent_value(k)), k);
+	}
+}
+
+TESTCASE(west_latency_histogram_relative_error)
+{
+	west::latency_histogram hist;
+	std::mt19937_64 rng;
+	std::uniform_int_distribution<uint64_t> dist{0, 1'000'000'000};
+	for(size_t k = 0; k != 10000; ++k)
+	{
+		auto const value = dist(rng);
+		auto const index = west::latency_histogram::index_of(value);
+		auto const high = west::latency_histogram::highest_equivalent_value(index);
+		EXPECT_LE(west::latency_histogram::lowest_equivalent_value(index), value);
+		EXPECT_GE(high, value);
+		EXPECT_LE(static_cast<double>(high - value), static_cast<double>(value)/128.0);
+		hist.record(value);
+	}
+
+	auto const median = static_cast<double>(hist.value_at_percentile(50.0));
+	EXPECT_GT(median, 0.49e9);
+	EXPECT_LT(median, 0.51e9);
+	EXPECT_EQ(hist.value_at_percentile(100.0), hist.max());
+}
+
+TESTCASE(west_latency_histogram_merge)
+{
+	west::latency_histogram a;
+	west::latency_histogram b;
+	a.record(10, 3);
+	b.record(1000000);
+
+	a.merge(b);
+	EXPECT_EQ(a.count(), 4);
+	EXPECT_EQ(a.min(), 10);
+	EXPECT_EQ(a.max(), 1000000);
+	EXPECT_EQ(a.value_at_percentile(75.0), 10);
+	EXPECT_EQ(a.value_at_percentile(99.0), 1000000);
+
+	a.reset();
+	EXPECT_EQ(a.count(), 0);
+	EXPECT_EQ(a.max(), 0);
+}
@@ -0,0 +1,63 @@
+#ifndef WEST_PER_LOOP_SHARED_HPP
+#define WEST_PER_LOOP_SHARED_HPP
+
+#include <memory>
+#include <tuple>
+
+namespace west
+{
+	// NOTE: Refers to a shared T, that is not thread-safe. Session factories are copied once per
+	//       event loop by sharded_service_registry, so a copy of the handle refers to a new T,
+	//       constructed from the same arguments. Thus, every event loop gets its own T. A move keeps
+	//       the T. To reach the T of a single event loop, construct the handle from a shared T, and
+	//       move it into the factory.
+	template<class T, class... Args>
+	class per_loop_shared
+	{
+	public:
+		explicit per_loop_shared(Args... args):
+			m_args{std::move(args)...},
+			m_object{make_object()}
+		{}
+
+		explicit per_loop_shared(std::shared_ptr<T> object, Args... args):
+			m_args{std::move(args)...},
+			m_object{std::move(object)}
+		{}
+
+		per_loop_shared(per_loop_shared const& other):
+			m_args{other.m_args},
+			m_object{make_object()}
+		{}
+
+		per_loop_shared& operator=(per_loop_shared const& other)
+		{
+			m_args = other.m_args;
+			m_object = make_object();
+			return *this;
+		}
+
+		per_loop_shared(per_loop_shared&&) = default;
+		per_loop_shared& operator=(per_loop_shared&&) = default;
+
+		auto const& get() const
+		{ return m_object; }
+
+		auto* operator->() const
+		{ return m_object.get(); }
+
+	private:
+		std::shared_ptr<T> make_object() const
+		{
+			return std::apply([](auto const&... args){
+				return std::make_shared<T>(args...);
+			}, m_args);
+		}
+
+		// NOTE: The arguments are kept in the handle, so a moved-from handle can be copied
+		std::tuple<Args...> m_args;
+		std::shared_ptr<T> m_object;
+	};
+}
+
+#endif
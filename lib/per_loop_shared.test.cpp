@@ -0,0 +1,62 @@
+//@	{"target":{"name":"per_loop_shared.test"}}
+
+#include "./per_loop_shared.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+namespace
+{
+	struct counter
+	{
+		counter() = default;
+
+		explicit counter(size_t initial_value):value{initial_value}
+		{}
+
+		size_t value{0};
+	};
+}
+
+TESTCASE(west_per_loop_shared_copy_creates_new_object)
+{
+	west::per_loop_shared<counter, size_t> a{4};
+	a->value = 10;
+
+	auto b = a;
+	EXPECT_NE(a.get(), b.get());
+	EXPECT_EQ(b->value, 4);
+	EXPECT_EQ(a->value, 10);
+
+	auto const ptr = a.get();
+	auto c = std::move(a);
+	EXPECT_EQ(c.get(), ptr);
+
+	b = c;
+	EXPECT_NE(b.get(), c.get());
+	EXPECT_EQ(b->value, 4);
+}
+
+TESTCASE(west_per_loop_shared_copy_moved_from)
+{
+	west::per_loop_shared<counter, size_t> a{4};
+	auto b = std::move(a);
+
+	auto c = a;
+	REQUIRE_NE(c.get(), nullptr);
+	EXPECT_EQ(c->value, 4);
+
+	b = a;
+	REQUIRE_NE(b.get(), nullptr);
+	EXPECT_EQ(b->value, 4);
+}
+
+TESTCASE(west_per_loop_shared_from_shared_object)
+{
+	auto const object = std::make_shared<counter>(7);
+	west::per_loop_shared<counter> a{object};
+	EXPECT_EQ(a.get(), object);
+
+	auto const b = a;
+	EXPECT_NE(b.get(), object);
+	EXPECT_EQ(b->value, 0);
+}
@@ -5,6 +5,11 @@
 #include "./io_interfaces.hpp"
 #include "./io_fd_event_monitor.hpp"
 
+#include <stop_token>
+#include <chrono>
+#include <optional>
+#include <algorithm>
+
 namespace west
 {
 	template<class T>
@@ -20,6 +25,14 @@ namespace west
 		{ x.accept() } -> connection;
 	};
 	
+	// A server socket that can report that there are no pending connections, so that several
+	// connections can be accepted for each event
+	template<class T>
+	concept batch_server_socket = server_socket<T> && requires(T x)
+	{
+		{ x.try_accept() } -> std::same_as<std::optional<decltype(x.accept())>>;
+	};
+
 	template<class T>
 	// HACK: An input fd is not a connection, but all members will have the same semantics
 	concept input_fd = io::data_source<T> && connection<T>;
@@ -54,73 +67,240 @@ namespace west
 		};
 	}
 
+	// Sessions may provide timeout_update() to control when socket_is_idle is called
+	template<class Session>
+	std::optional<io::fd_timeout> get_timeout_update(Session& session)
+	{
+		if constexpr(requires{ { session.timeout_update() } -> std::same_as<std::optional<io::fd_timeout>>; })
+		{ return session.timeout_update(); }
+		else
+		{ return std::nullopt; }
+	}
+
+	// Sessions may report that they stopped to let other sessions run, by providing
+	// is_session_yielding for their status
+	template<session_status SessionStatus>
+	bool is_yielding(SessionStatus const& status)
+	{
+		if constexpr(requires{ { is_session_yielding(status) } -> std::same_as<bool>; })
+		{ return is_session_yielding(status); }
+		else
+		{ return false; }
+	}
+
+	// NOTE: Not thread-safe. Every event loop has its own statistics.
+	struct service_statistics
+	{
+		size_t connections_accepted;
+		size_t connections_closed;
+
+		// Number of connections closed by their session when it was notified that the connection
+		// had been idle
+		size_t idle_reaps;
+
+		// Number of times a server socket stopped accepting connections, because the process or the
+		// system ran out of file descriptors or memory
+		size_t accept_pauses;
+
+		constexpr size_t open_connections() const
+		{ return connections_accepted - connections_closed; }
+
+		constexpr bool operator==(service_statistics const&) const = default;
+		constexpr bool operator!=(service_statistics const&) const = default;
+	};
+
 	template<class Session>
 	struct connection_event_handler
 	{
 		Session session;
 		io::listen_on events;
+		service_statistics* stats{nullptr};
 
 		void fd_is_ready(auto event_monitor, io::fd_ref fd)
 		{ finalize_event(session.socket_is_ready(), event_monitor, fd); }
 
 		void fd_is_idle(auto event_monitor, io::fd_ref fd)
-		{ finalize_event(session.socket_is_idle(), event_monitor, fd); }
+		{
+			auto status = session.socket_is_idle();
+			if(stats != nullptr && is_session_terminated(status))
+			{ ++stats->idle_reaps; }
+
+			// NOTE: In edge-triggered mode, there will be no event for an fd that was already ready
+			//       when the session changed state, so the session must try to continue immediately
+			if(events == io::listen_on::readwrite_edge_triggered && !is_session_terminated(status))
+			{
+				fd_is_ready(event_monitor, fd);
+				return;
+			}
+
+			finalize_event(std::move(status), event_monitor, fd);
+		}
 
 		template<session_status SessionStatus, class EventMonitor>
 		void finalize_event(SessionStatus&& status, EventMonitor event_monitor, io::fd_ref fd)
 		{
 			if(is_session_terminated(status))
 			{
+				if(stats != nullptr)
+				{ ++stats->connections_closed; }
 				event_monitor.remove(fd);
 				return;
 			}
 
-			if(auto new_events = session_state_mapper<SessionStatus>{}(status);
+			// NOTE: An edge-triggered fd listens for both directions, and is only modified to re-arm it
+			//       when the session yields. This reports the fd again if it is still ready.
+			if(events == io::listen_on::readwrite_edge_triggered)
+			{
+				if(is_yielding(status))
+				{ event_monitor.modify(fd, events); }
+			}
+			else if(auto new_events = session_state_mapper<SessionStatus>{}(status);
 				new_events != events)
 			{
 				event_monitor.modify(fd, new_events);
 				events = new_events;
 			}
+
+			if(auto const timeout = get_timeout_update(session); timeout.has_value())
+			{ event_monitor.set_timeout(fd, timeout->duration, timeout->mode); }
 		}
 	};
 
 
+	// NOTE: With io::listen_on::readwrite_edge_triggered, the session must only report that it
+	//       needs more data after a read or write would have blocked. Otherwise, it will not be
+	//       notified again.
+	//
+	//       If `stats` is not null, the connection is counted as accepted, and is counted as closed
+	//       when the session terminates.
+	template<class EventMonitor, connection Connection, class SessionFactory, class... SessionArgs>
+		requires session_factory<SessionFactory, Connection, SessionArgs...>
+	void add_connection(
+		EventMonitor event_monitor,
+		Connection&& connection,
+		io::listen_on initial_events,
+		service_statistics* stats,
+		SessionFactory& session_factory,
+		SessionArgs&&... session_args)
+	{
+		connection.set_non_blocking();
+		auto const conn_fd = connection.fd();
+		connection_event_handler handler{
+			session_factory.create_session(std::move(connection), std::forward<SessionArgs>(session_args)...),
+			initial_events,
+			stats
+		};
+		auto const timeout = get_timeout_update(handler.session);
+		event_monitor.add(conn_fd, std::move(handler), initial_events);
+		if(stats != nullptr)
+		{ ++stats->connections_accepted; }
+
+		if(timeout.has_value())
+		{ event_monitor.set_timeout(conn_fd, timeout->duration, timeout->mode); }
+	}
+
+	// Returns false if there was no connection to accept
 	template<class EventMonitor, server_socket ServerSocket, class SessionFactory, class... SessionArgs>
 		requires session_factory<SessionFactory, typename detail::connection_type<ServerSocket>::type, SessionArgs...>
-	void accept_connection(
+	bool accept_connection(
 		EventMonitor event_monitor,
 		ServerSocket& server_socket,
+		io::listen_on initial_events,
+		service_statistics* stats,
 		SessionFactory& session_factory,
 		SessionArgs&&... session_args)
 	{
-		auto connection = server_socket.accept();
-		connection.set_non_blocking();
-		auto const conn_fd = connection.fd();
-		event_monitor.add(conn_fd,
-			connection_event_handler{
-				session_factory.create_session(std::move(connection), std::forward<SessionArgs>(session_args)...),
-				io::listen_on::read_is_possible
-			},
-			io::listen_on::read_is_possible
-		);
+		if constexpr(batch_server_socket<ServerSocket>)
+		{
+			auto connection = server_socket.try_accept();
+			if(!connection.has_value())
+			{ return false; }
+
+			add_connection(event_monitor,
+				std::move(*connection),
+				initial_events,
+				stats,
+				session_factory,
+				std::forward<SessionArgs>(session_args)...);
+		}
+		else
+		{
+			add_connection(event_monitor,
+				server_socket.accept(),
+				initial_events,
+				stats,
+				session_factory,
+				std::forward<SessionArgs>(session_args)...);
+		}
+		return true;
 	}
 
+	inline constexpr size_t default_accept_batch_size = 64;
+
+	inline constexpr std::chrono::milliseconds default_accept_backoff{100};
+
 	template<server_socket ServerSocket, class SessionFactory, class... SessionArgs>
 	struct server_event_handler
 	{
 		ServerSocket server_socket;
 		SessionFactory session_factory;
 		std::tuple<SessionArgs...>  session_args;
+		size_t accept_batch_size{default_accept_batch_size};
+		io::listen_on connection_events{io::listen_on::read_is_possible};
+		service_statistics* stats{nullptr};
+		std::chrono::steady_clock::duration accept_backoff{default_accept_backoff};
+		std::chrono::steady_clock::duration idle_timeout{io::fd_event_monitor::inactivity_period};
+		bool accept_paused{false};
 
-		void fd_is_ready(auto event_monitor, io::fd_ref)
+		// NOTE: Only one connection is accepted per event, unless the server socket can report
+		//       that there are no more pending connections
+		void fd_is_ready(auto event_monitor, io::fd_ref fd)
 		{
-			std::apply([this, event_monitor](auto... session_args){
-				accept_connection(event_monitor, server_socket, session_factory, session_args...);
-			}, session_args);
+			auto const batch_size = batch_server_socket<ServerSocket>? accept_batch_size : 1;
+			for(size_t k = 0; k != batch_size; ++k)
+			{
+				auto const accepted = std::apply([this, event_monitor](auto... session_args){
+					return accept_connection(event_monitor,
+						server_socket,
+						connection_events,
+						stats,
+						session_factory,
+						session_args...);
+				}, session_args);
+
+				if(!accepted)
+				{
+					if constexpr(requires{ { server_socket.is_out_of_resources() } -> std::same_as<bool>; })
+					{
+						if(server_socket.is_out_of_resources())
+						{ pause_accepting(event_monitor, fd); }
+					}
+					return;
+				}
+			}
 		}
 
-		void fd_is_idle(auto, io::fd_ref)
-		{}
+		// NOTE: The server socket is level-triggered, so a connection that cannot be accepted would
+		//       wake up the event loop immediately again. Instead, the socket is not monitored until
+		//       accept_backoff has passed.
+		void pause_accepting(auto event_monitor, io::fd_ref fd)
+		{
+			event_monitor.modify(fd, io::listen_on::nothing);
+			event_monitor.set_timeout(fd, accept_backoff, io::timeout_mode::fixed_deadline);
+			accept_paused = true;
+			if(stats != nullptr)
+			{ ++stats->accept_pauses; }
+		}
+
+		void fd_is_idle(auto event_monitor, io::fd_ref fd)
+		{
+			if(!accept_paused)
+			{ return; }
+
+			event_monitor.modify(fd, io::listen_on::read_is_possible);
+			event_monitor.set_timeout(fd, idle_timeout);
+			accept_paused = false;
+		}
 	};
 	
 	template<class InputFd, class InputFdEventHandler>
@@ -136,14 +316,21 @@ namespace west
 		InputFdEventHandler eh;
 	};
 
-	class service_registry
+	template<class EventMonitor>
+	class basic_service_registry
 	{
 	public:
-		static constexpr auto inactivity_period = io::fd_event_monitor::inactivity_period;
+		static constexpr auto inactivity_period = EventMonitor::inactivity_period;
+
+		basic_service_registry() = default;
+
+		explicit basic_service_registry(std::chrono::steady_clock::duration timer_tick):
+			m_event_monitor{timer_tick}
+		{}
 
 		template<server_socket ServerSocket, class SessionFactory,	class... SessionArgs>
 		requires session_factory<SessionFactory, typename detail::connection_type<ServerSocket>::type, SessionArgs...>
-		service_registry& enroll(ServerSocket&& server_socket,
+		basic_service_registry& enroll(ServerSocket&& server_socket,
 			SessionFactory&& session_factory,
 			SessionArgs&&... session_args)
 		{
@@ -153,14 +340,52 @@ namespace west
 				server_event_handler{
 					std::forward<ServerSocket>(server_socket),
 					std::forward<SessionFactory>(session_factory),
-					std::tuple{std::forward<SessionArgs>(session_args)...}
+					std::tuple{std::forward<SessionArgs>(session_args)...},
+					m_accept_batch_size,
+					m_connection_events,
+					&m_stats,
+					default_accept_backoff,
+					EventMonitor::inactivity_period
 				}
 			);
 			return *this;
 		}
 
+		// Sets the maximum number of connections to accept per event, for server sockets that are
+		// enrolled after this call
+		basic_service_registry& accept_batch_size(size_t value)
+		{
+			m_accept_batch_size = std::max(value, static_cast<size_t>(1));
+			return *this;
+		}
+
+		// Selects how connections accepted by server sockets that are enrolled after this call are
+		// monitored. Falls back to level-triggered mode if the event monitor does not support
+		// edge-triggered mode. Server sockets are always monitored in level-triggered mode.
+		basic_service_registry& connection_trigger_mode(io::trigger_mode mode)
+		{
+			m_connection_events = mode == io::trigger_mode::edge && EventMonitor::supports_edge_triggered?
+				io::listen_on::readwrite_edge_triggered : io::listen_on::read_is_possible;
+			return *this;
+		}
+
+		[[nodiscard]] io::trigger_mode connection_trigger_mode() const
+		{
+			return m_connection_events == io::listen_on::readwrite_edge_triggered?
+				io::trigger_mode::edge : io::trigger_mode::level;
+		}
+
+		// Starts recording io::event_loop_metrics in the event monitor. See
+		// basic_fd_event_monitor::enable_loop_metrics.
+		template<class... Args>
+		basic_service_registry& enable_loop_metrics(Args&&... args)
+		{
+			m_event_monitor.enable_loop_metrics(std::forward<Args>(args)...);
+			return *this;
+		}
+
 		template<input_fd InputFd, class InputFdEventHandler>
-		service_registry& enroll(InputFd&& data_source, InputFdEventHandler&& eh)
+		basic_service_registry& enroll(InputFd&& data_source, InputFdEventHandler&& eh)
 		{
 			data_source.set_non_blocking();
 			auto const data_source_fd = data_source.fd();
@@ -172,18 +397,36 @@ namespace west
 			return *this;
  		}
 
-		service_registry& process_events()
+		basic_service_registry& process_events()
 		{
 			while(m_event_monitor.wait_for_and_dispatch_events());
 			return *this;
 		}
 
+		basic_service_registry& process_events(std::stop_token stop)
+		{
+			while(!stop.stop_requested() && m_event_monitor.wait_for_and_dispatch_events());
+			return *this;
+		}
+
 		auto fd_callback_registry()
 		{ return m_event_monitor.fd_callback_registry(); }
 
+		[[nodiscard]] EventMonitor const& event_monitor() const
+		{ return m_event_monitor; }
+
+		// Returns counters for connections accepted by the enrolled server sockets
+		[[nodiscard]] service_statistics const& stats() const
+		{ return m_stats; }
+
 	private:
-		io::fd_event_monitor m_event_monitor;
+		EventMonitor m_event_monitor;
+		size_t m_accept_batch_size{default_accept_batch_size};
+		io::listen_on m_connection_events{io::listen_on::read_is_possible};
+		service_statistics m_stats{};
 	};
+
+	using service_registry = basic_service_registry<io::fd_event_monitor>;
 }
 
 #endif
@@ -185,3 +185,291 @@ TESTCASE(west_service_registry_socket_is_idle)
 	server_thread.join();
 	EXPECT_GE(std::chrono::steady_clock::now() - t0, west::service_registry::inactivity_period);
 }
+
+namespace
+{
+	struct fake_connection
+	{
+		west::io::fd_ref fd() const { return west::io::fd_ref{value}; }
+		void set_non_blocking(){}
+		int value;
+	};
+
+	struct fake_batch_server_socket
+	{
+		west::io::fd_ref fd() const { return west::io::fd_ref{}; }
+		void set_non_blocking(){}
+
+		fake_connection accept()
+		{ return *try_accept(); }
+
+		std::optional<fake_connection> try_accept()
+		{
+			if(pending == 0)
+			{ return std::nullopt; }
+			--pending;
+			return fake_connection{next_fd++};
+		}
+
+		size_t pending;
+		int next_fd{100};
+	};
+
+	struct fake_session
+	{
+		fake_connection connection;
+		session_status socket_is_ready() { return session_status::keep_connection; }
+	};
+
+	struct fake_session_factory
+	{
+		auto create_session(fake_connection&& connection)
+		{ return fake_session{connection}; }
+	};
+
+	struct fake_event_monitor
+	{
+		std::reference_wrapper<std::vector<int>> added_fds;
+
+		template<class Handler>
+		void add(west::io::fd_ref fd, Handler&&, west::io::listen_on)
+		{ added_fds.get().push_back(fd.value); }
+
+		void set_timeout(west::io::fd_ref, std::chrono::milliseconds, west::io::timeout_mode)
+		{}
+	};
+}
+
+TESTCASE(west_service_registry_server_event_handler_accepts_in_batches)
+{
+	west::server_event_handler<fake_batch_server_socket, fake_session_factory> handler{
+		fake_batch_server_socket{10},
+		fake_session_factory{},
+		std::tuple<>{},
+		4
+	};
+
+	std::vector<int> added_fds;
+	handler.fd_is_ready(fake_event_monitor{added_fds}, west::io::fd_ref{});
+	EXPECT_EQ(std::size(added_fds), 4);
+	EXPECT_EQ(handler.server_socket.pending, 6);
+
+	handler.fd_is_ready(fake_event_monitor{added_fds}, west::io::fd_ref{});
+	handler.fd_is_ready(fake_event_monitor{added_fds}, west::io::fd_ref{});
+	EXPECT_EQ(std::size(added_fds), 10);
+	EXPECT_EQ(handler.server_socket.pending, 0);
+	EXPECT_EQ(added_fds.front(), 100);
+	EXPECT_EQ(added_fds.back(), 109);
+
+	// No pending connections is not an error
+	handler.fd_is_ready(fake_event_monitor{added_fds}, west::io::fd_ref{});
+	EXPECT_EQ(std::size(added_fds), 10);
+}
+
+namespace
+{
+	struct exhausted_server_socket
+	{
+		west::io::fd_ref fd() const { return west::io::fd_ref{}; }
+		void set_non_blocking(){}
+
+		fake_connection accept()
+		{ return *try_accept(); }
+
+		std::optional<fake_connection> try_accept()
+		{
+			if(out_of_resources || pending == 0)
+			{ return std::nullopt; }
+			--pending;
+			return fake_connection{next_fd++};
+		}
+
+		bool is_out_of_resources() const
+		{ return out_of_resources; }
+
+		size_t pending;
+		bool out_of_resources;
+		int next_fd{100};
+	};
+
+	struct pausing_event_monitor
+	{
+		std::reference_wrapper<std::vector<int>> added_fds;
+		std::reference_wrapper<std::vector<west::io::listen_on>> modified_events;
+		std::reference_wrapper<std::vector<west::io::fd_timeout>> timeouts;
+
+		template<class Handler>
+		void add(west::io::fd_ref fd, Handler&&, west::io::listen_on)
+		{ added_fds.get().push_back(fd.value); }
+
+		void modify(west::io::fd_ref, west::io::listen_on events)
+		{ modified_events.get().push_back(events); }
+
+		void set_timeout(west::io::fd_ref,
+			std::chrono::steady_clock::duration timeout,
+			west::io::timeout_mode mode = west::io::timeout_mode::restart_on_activity)
+		{
+			timeouts.get().push_back(west::io::fd_timeout{
+				std::chrono::duration_cast<std::chrono::milliseconds>(timeout),
+				mode
+			});
+		}
+	};
+}
+
+TESTCASE(west_service_registry_server_event_handler_pauses_when_out_of_resources)
+{
+	west::service_statistics stats{};
+	west::server_event_handler<exhausted_server_socket, fake_session_factory> handler{
+		exhausted_server_socket{2, true},
+		fake_session_factory{},
+		std::tuple<>{},
+		4
+	};
+	handler.stats = &stats;
+
+	std::vector<int> added_fds;
+	std::vector<west::io::listen_on> modified_events;
+	std::vector<west::io::fd_timeout> timeouts;
+	pausing_event_monitor monitor{added_fds, modified_events, timeouts};
+
+	handler.fd_is_ready(monitor, west::io::fd_ref{});
+	EXPECT_EQ(std::size(added_fds), 0);
+	REQUIRE_EQ(std::size(modified_events), 1);
+	EXPECT_EQ(modified_events[0], west::io::listen_on::nothing);
+	REQUIRE_EQ(std::size(timeouts), 1);
+	EXPECT_EQ(timeouts[0], (west::io::fd_timeout{west::default_accept_backoff, west::io::timeout_mode::fixed_deadline}));
+	EXPECT_EQ(stats.accept_pauses, 1);
+
+	// The backoff has passed
+	handler.server_socket.out_of_resources = false;
+	handler.fd_is_idle(monitor, west::io::fd_ref{});
+	REQUIRE_EQ(std::size(modified_events), 2);
+	EXPECT_EQ(modified_events[1], west::io::listen_on::read_is_possible);
+	REQUIRE_EQ(std::size(timeouts), 2);
+	EXPECT_EQ(timeouts[1].mode, west::io::timeout_mode::restart_on_activity);
+	EXPECT_EQ(timeouts[1].duration, west::service_registry::inactivity_period);
+
+	handler.fd_is_ready(monitor, west::io::fd_ref{});
+	EXPECT_EQ(std::size(added_fds), 2);
+	EXPECT_EQ(std::size(modified_events), 2);
+	EXPECT_EQ(stats.accept_pauses, 1);
+
+	// An ordinary idle notification does not change anything
+	handler.fd_is_idle(monitor, west::io::fd_ref{});
+	EXPECT_EQ(std::size(modified_events), 2);
+	EXPECT_EQ(std::size(timeouts), 2);
+}
+
+namespace
+{
+	struct counting_session
+	{
+		size_t ready_calls{0};
+		size_t idle_calls{0};
+
+		session_status socket_is_ready()
+		{
+			++ready_calls;
+			return session_status::keep_connection;
+		}
+
+		session_status socket_is_idle()
+		{
+			++idle_calls;
+			return session_status::keep_connection;
+		}
+	};
+
+	struct modify_counting_event_monitor
+	{
+		std::reference_wrapper<size_t> modify_calls;
+
+		void modify(west::io::fd_ref, west::io::listen_on)
+		{ ++modify_calls.get(); }
+
+		void remove(west::io::fd_ref)
+		{}
+
+		void set_timeout(west::io::fd_ref, std::chrono::milliseconds, west::io::timeout_mode)
+		{}
+	};
+}
+
+TESTCASE(west_service_registry_connection_event_handler_edge_triggered)
+{
+	size_t modify_calls = 0;
+
+	west::connection_event_handler<counting_session> level{
+		counting_session{},
+		west::io::listen_on::read_is_possible
+	};
+	level.fd_is_ready(modify_counting_event_monitor{modify_calls}, west::io::fd_ref{});
+	EXPECT_EQ(modify_calls, 1);
+	EXPECT_EQ(level.events, west::io::listen_on::readwrite_is_possible);
+	level.fd_is_idle(modify_counting_event_monitor{modify_calls}, west::io::fd_ref{});
+	EXPECT_EQ(level.session.ready_calls, 1);
+	EXPECT_EQ(level.session.idle_calls, 1);
+
+	modify_calls = 0;
+	west::connection_event_handler<counting_session> edge{
+		counting_session{},
+		west::io::listen_on::readwrite_edge_triggered
+	};
+	edge.fd_is_ready(modify_counting_event_monitor{modify_calls}, west::io::fd_ref{});
+	EXPECT_EQ(modify_calls, 0);
+	EXPECT_EQ(edge.events, west::io::listen_on::readwrite_edge_triggered);
+
+	// The session continues directly after the idle callback, since there may be no new event
+	edge.fd_is_idle(modify_counting_event_monitor{modify_calls}, west::io::fd_ref{});
+	EXPECT_EQ(modify_calls, 0);
+	EXPECT_EQ(edge.session.ready_calls, 2);
+	EXPECT_EQ(edge.session.idle_calls, 1);
+}
+
+namespace
+{
+	struct idle_closing_session
+	{
+		session_status socket_is_ready()
+		{ return session_status::keep_connection; }
+
+		session_status socket_is_idle()
+		{ return session_status::close_connection; }
+	};
+}
+
+TESTCASE(west_service_registry_stats)
+{
+	west::service_statistics stats{};
+
+	west::server_event_handler<fake_batch_server_socket, fake_session_factory> server{
+		fake_batch_server_socket{3},
+		fake_session_factory{},
+		std::tuple<>{},
+		4
+	};
+	server.stats = &stats;
+
+	std::vector<int> added_fds;
+	server.fd_is_ready(fake_event_monitor{added_fds}, west::io::fd_ref{});
+	EXPECT_EQ(stats.connections_accepted, 3);
+	EXPECT_EQ(stats.open_connections(), 3);
+
+	size_t modify_calls = 0;
+	west::connection_event_handler<idle_closing_session> conn{
+		idle_closing_session{},
+		west::io::listen_on::read_is_possible,
+		&stats
+	};
+	conn.fd_is_ready(modify_counting_event_monitor{modify_calls}, west::io::fd_ref{});
+	EXPECT_EQ(stats.connections_closed, 0);
+
+	conn.fd_is_idle(modify_counting_event_monitor{modify_calls}, west::io::fd_ref{});
+	EXPECT_EQ(stats.connections_closed, 1);
+	EXPECT_EQ(stats.idle_reaps, 1);
+	EXPECT_EQ(stats.open_connections(), 2);
+
+	west::service_registry registry{};
+	EXPECT_EQ(registry.stats(), west::service_statistics{});
+}
@@ -0,0 +1,199 @@
+#ifndef WEST_SHARDED_SERVICE_REGISTRY_HPP
+#define WEST_SHARDED_SERVICE_REGISTRY_HPP
+
+#include "./service_registry.hpp"
+#include "./system_error.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <memory>
+#include <vector>
+#include <thread>
+#include <stop_token>
+#include <exception>
+#include <stdexcept>
+#include <mutex>
+#include <optional>
+
+namespace west
+{
+	// NOTE: Runs one service_registry per thread. Each event loop owns its own server socket and
+	//       session factory, so the loops do not share any state. Use
+	//       io::create_sharded_server_sockets to create the server sockets.
+	template<class EventMonitor>
+	class basic_sharded_service_registry
+	{
+	public:
+		explicit basic_sharded_service_registry(size_t num_event_loops)
+		{
+			if(num_event_loops == 0)
+			{ throw std::runtime_error{"A sharded service registry requires at least one event loop"}; }
+
+			m_shards.reserve(num_event_loops);
+			for(size_t k = 0; k != num_event_loops; ++k)
+			{ m_shards.push_back(shard{std::make_unique<basic_service_registry<EventMonitor>>(), std::nullopt}); }
+		}
+
+		// One event loop per entry in `cpus`. Each loop is pinned to its cpu.
+		explicit basic_sharded_service_registry(std::vector<int> const& cpus)
+		{
+			if(std::size(cpus) == 0)
+			{ throw std::runtime_error{"A sharded service registry requires at least one event loop"}; }
+
+			m_shards.reserve(std::size(cpus));
+			for(auto const cpu : cpus)
+			{
+				if(cpu < 0 || cpu >= CPU_SETSIZE)
+				{ throw std::runtime_error{"Invalid cpu index"}; }
+				m_shards.push_back(shard{std::make_unique<basic_service_registry<EventMonitor>>(), cpu});
+			}
+		}
+
+		[[nodiscard]] size_t event_loop_count() const
+		{ return std::size(m_shards); }
+
+		// Sets the maximum number of connections each event loop accepts per event, for server sockets
+		// that are enrolled after this call
+		basic_sharded_service_registry& accept_batch_size(size_t value)
+		{
+			for(auto& item : m_shards)
+			{ item.registry->accept_batch_size(value); }
+			return *this;
+		}
+
+		// Selects how each event loop monitors connections, for server sockets that are enrolled after
+		// this call
+		basic_sharded_service_registry& connection_trigger_mode(io::trigger_mode mode)
+		{
+			for(auto& item : m_shards)
+			{ item.registry->connection_trigger_mode(mode); }
+			return *this;
+		}
+
+		// Starts recording io::event_loop_metrics in every event loop. The metrics of a loop can be
+		// read through event_loop(index), from the thread of that loop, or after process_events has
+		// returned.
+		template<class... Args>
+		basic_sharded_service_registry& enable_loop_metrics(Args const&... args)
+		{
+			for(auto& item : m_shards)
+			{ item.registry->enable_loop_metrics(args...); }
+			return *this;
+		}
+
+		// Each event loop gets its own copy of `session_factory` and `session_args`
+		template<server_socket ServerSocket, class SessionFactory, class... SessionArgs>
+		requires session_factory<SessionFactory, typename detail::connection_type<ServerSocket>::type, SessionArgs...>
+		basic_sharded_service_registry& enroll(std::vector<ServerSocket>&& server_sockets,
+			SessionFactory const& session_factory,
+			SessionArgs const&... session_args)
+		{
+			if(std::size(server_sockets) != std::size(m_shards))
+			{ throw std::runtime_error{"There must be exactly one server socket per event loop"}; }
+
+			for(size_t k = 0; k != std::size(m_shards); ++k)
+			{
+				m_shards[k].registry->enroll(std::move(server_sockets[k]),
+					SessionFactory{session_factory},
+					session_args...);
+			}
+			return *this;
+		}
+
+		// Input fds are handled by the first event loop
+		template<input_fd InputFd, class InputFdEventHandler>
+		basic_sharded_service_registry& enroll(InputFd&& data_source, InputFdEventHandler&& eh)
+		{
+			m_shards.front().registry->enroll(std::forward<InputFd>(data_source),
+				std::forward<InputFdEventHandler>(eh));
+			return *this;
+		}
+
+		// Runs until any of the event loops runs out of listeners, or stop() is called. The registry
+		// may be run again after it has returned.
+		basic_sharded_service_registry& process_events()
+		{
+			std::stop_source stop;
+			{
+				std::lock_guard lock{m_stop_mtx};
+				stop = m_stop;
+			}
+
+			std::exception_ptr failure;
+			std::mutex failure_mtx;
+			{
+				std::vector<std::jthread> threads;
+				threads.reserve(std::size(m_shards));
+				for(auto& item : m_shards)
+				{
+					threads.push_back(std::jthread{[&item, &failure, &failure_mtx, stop]() mutable {
+						try
+						{
+							if(item.cpu.has_value())
+							{ pin_current_thread_to(*item.cpu); }
+							item.registry->process_events(stop.get_token());
+						}
+						catch(...)
+						{
+							std::lock_guard lock{failure_mtx};
+							if(failure == nullptr)
+							{ failure = std::current_exception(); }
+						}
+						stop.request_stop();
+					}});
+				}
+			}
+
+			// NOTE: The stop source has been used, either by stop() or by the loop that returned first
+			{
+				std::lock_guard lock{m_stop_mtx};
+				m_stop = std::stop_source{};
+			}
+
+			if(failure != nullptr)
+			{ std::rethrow_exception(failure); }
+
+			return *this;
+		}
+
+		// NOTE: The request is checked between calls to epoll_wait, so it may take up to one
+		//       epoll timeout before all loops have returned. If the registry is not running, the
+		//       next call to process_events returns immediately.
+		void stop()
+		{
+			std::lock_guard lock{m_stop_mtx};
+			m_stop.request_stop();
+		}
+
+		[[nodiscard]] auto& event_loop(size_t index)
+		{ return *m_shards[index].registry; }
+
+		auto fd_callback_registry()
+		{ return m_shards.front().registry->fd_callback_registry(); }
+
+	private:
+		static void pin_current_thread_to(int cpu)
+		{
+			cpu_set_t cpus{};
+			CPU_ZERO(&cpus);
+			CPU_SET(cpu, &cpus);
+			if(auto const res = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus); res != 0)
+			{ throw system_error{"Failed to set cpu affinity", res}; }
+		}
+
+		struct shard
+		{
+			std::unique_ptr<basic_service_registry<EventMonitor>> registry;
+			std::optional<int> cpu;
+		};
+
+		std::vector<shard> m_shards;
+		std::mutex m_stop_mtx;
+		std::stop_source m_stop;
+	};
+
+	using sharded_service_registry = basic_sharded_service_registry<io::fd_event_monitor>;
+}
+
+#endif
@@ -0,0 +1,207 @@
+//@	{"target":{"name":"sharded_service_registry.test"}}
+
+#include "./sharded_service_registry.hpp"
+#include "./io_inet_server_socket.hpp"
+
+#include <testfwk/testfwk.hpp>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+	enum class session_status{close_connection, keep_connection};
+
+	constexpr bool is_session_terminated(session_status status)
+	{ return status == session_status::close_connection; }
+
+	struct session
+	{
+		west::io::inet_connection connection;
+		std::atomic<size_t>* sessions_created;
+
+		session_status socket_is_ready()
+		{
+			std::array<char, 65536> buffer{};
+			while(true)
+			{
+				auto res = connection.read(buffer);
+				if(res.bytes_read != 0)
+				{
+					EXPECT_EQ((std::string_view{std::data(buffer), res.bytes_read}), "give me some data");
+					(void)connection.write(std::string_view{"here are some data"});
+				}
+				else
+				{
+					switch(res.ec)
+					{
+						case west::io::operation_result::operation_would_block:
+							return session_status::keep_connection;
+						case west::io::operation_result::completed:
+							return session_status::close_connection;
+						case west::io::operation_result::error:
+							return session_status::close_connection;
+					}
+				}
+			}
+		}
+
+		session_status socket_is_idle()
+		{ return session_status::close_connection; }
+	};
+
+	struct factory
+	{
+		std::atomic<size_t>* sessions_created;
+		std::thread::id creating_thread{};
+
+		auto create_session(west::io::inet_connection&& connection)
+		{
+			// Each event loop has its own copy of the factory, so it is always used from the same
+			// thread
+			if(creating_thread == std::thread::id{})
+			{ creating_thread = std::this_thread::get_id(); }
+			EXPECT_EQ(creating_thread, std::this_thread::get_id());
+
+			++(*sessions_created);
+			return session{std::move(connection), sessions_created};
+		}
+	};
+}
+
+template<>
+struct west::session_state_mapper<session_status>
+{
+	template<class T>
+	constexpr auto operator()(T) const
+	{ return io::listen_on::read_is_possible; }
+};
+
+TESTCASE(west_sharded_service_registry_create)
+{
+	west::sharded_service_registry registry{3};
+	EXPECT_EQ(registry.event_loop_count(), 3);
+
+	try
+	{
+		west::sharded_service_registry{0};
+		abort();
+	}
+	catch(std::runtime_error const&)
+	{}
+
+	try
+	{
+		west::sharded_service_registry{std::vector{0, -1}};
+		abort();
+	}
+	catch(std::runtime_error const&)
+	{}
+}
+
+TESTCASE(west_sharded_service_registry_enroll_wrong_number_of_sockets)
+{
+	west::sharded_service_registry registry{3};
+	std::atomic<size_t> sessions_created{0};
+	try
+	{
+		registry.enroll(west::io::create_sharded_server_sockets(west::io::inet_address{"127.0.0.1"},
+			std::ranges::iota_view{49152, 65536},
+			128,
+			2), factory{&sessions_created});
+		abort();
+	}
+	catch(std::runtime_error const& err)
+	{ EXPECT_EQ(err.what(), std::string_view{"There must be exactly one server socket per event loop"}); }
+}
+
+TESTCASE(west_sharded_service_registry_process_events)
+{
+	west::io::inet_address address{"127.0.0.1"};
+	west::sharded_service_registry registry{std::vector{0, 0, 0, 0}};
+
+	auto server_sockets = west::io::create_sharded_server_sockets(address,
+		std::ranges::iota_view{49152, 65536},
+		128,
+		registry.event_loop_count());
+	auto const server_port = server_sockets.front().port();
+
+	std::atomic<size_t> sessions_created{0};
+	registry.enroll(std::move(server_sockets), factory{&sessions_created});
+
+	std::jthread server_thread{[&registry](){
+		registry.process_events();
+	}};
+
+	std::array<west::io::fd_owner, 64> clients{};
+	for(auto& client : clients)
+	{ client = connect_to(address, server_port); }
+
+	for(auto& client : clients)
+	{
+		std::string_view buffer{"give me some data"};
+		EXPECT_EQ(::write(client.get(), std::data(buffer), std::size(buffer)), std::ssize(buffer));
+	}
+
+	for(auto& client : clients)
+	{
+		std::string_view expected_result{"here are some data"};
+		std::array<char, 65536> buffer{};
+		EXPECT_EQ(::read(client.get(), std::data(buffer), std::size(buffer)), std::ssize(expected_result));
+		EXPECT_EQ((std::string_view{std::data(buffer), std::size(expected_result)}), expected_result);
+	}
+
+	EXPECT_EQ(sessions_created, std::size(clients));
+
+	registry.stop();
+}
+
+namespace
+{
+	// NOTE: Every run uses new threads, so the factory cannot check the creating thread
+	struct multi_run_factory
+	{
+		std::atomic<size_t>* sessions_created;
+
+		auto create_session(west::io::inet_connection&& connection)
+		{
+			++(*sessions_created);
+			return session{std::move(connection), sessions_created};
+		}
+	};
+}
+
+TESTCASE(west_sharded_service_registry_process_events_after_stop)
+{
+	west::io::inet_address address{"127.0.0.1"};
+	west::sharded_service_registry registry{2};
+
+	auto server_sockets = west::io::create_sharded_server_sockets(address,
+		std::ranges::iota_view{49152, 65536},
+		128,
+		registry.event_loop_count());
+	auto const server_port = server_sockets.front().port();
+
+	std::atomic<size_t> sessions_created{0};
+	registry.enroll(std::move(server_sockets), multi_run_factory{&sessions_created});
+
+	for(size_t run = 0; run != 2; ++run)
+	{
+		std::jthread server_thread{[&registry](){
+			registry.process_events();
+		}};
+
+		// A registry that has been stopped before must still serve clients
+		auto client = connect_to(address, server_port);
+		std::string_view request{"give me some data"};
+		EXPECT_EQ(::write(client.get(), std::data(request), std::size(request)), std::ssize(request));
+
+		std::string_view expected_result{"here are some data"};
+		std::array<char, 65536> buffer{};
+		EXPECT_EQ(::read(client.get(), std::data(buffer), std::size(buffer)), std::ssize(expected_result));
+
+		registry.stop();
+	}
+
+	EXPECT_EQ(sessions_created, 2);
+}
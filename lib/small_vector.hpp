@@ -0,0 +1,149 @@
+#ifndef WEST_SMALL_VECTOR_HPP
+#define WEST_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace west
+{
+	// NOTE: Stores up to N elements inline, and moves all elements to the heap when it grows beyond
+	//       that. Elements must be default constructible. Unused inline slots hold default
+	//       constructed elements, so removed elements do not keep any resources.
+	template<class T, size_t N>
+	requires(std::is_default_constructible_v<T>)
+	class small_vector
+	{
+	public:
+		small_vector():m_size{0}{}
+
+		small_vector(small_vector const& other):m_size{0}
+		{
+			for(auto const& item : other)
+			{ push_back(item); }
+		}
+
+		small_vector(small_vector&& other) noexcept:
+			m_inline{std::move(other.m_inline)},
+			m_heap{std::move(other.m_heap)},
+			m_size{std::exchange(other.m_size, 0)}
+		{ other.m_heap.clear(); }
+
+		small_vector& operator=(small_vector const& other)
+		{
+			if(this != &other)
+			{
+				clear();
+				for(auto const& item : other)
+				{ push_back(item); }
+			}
+			return *this;
+		}
+
+		small_vector& operator=(small_vector&& other) noexcept
+		{
+			m_inline = std::move(other.m_inline);
+			m_heap = std::move(other.m_heap);
+			other.m_heap.clear();
+			m_size = std::exchange(other.m_size, 0);
+			return *this;
+		}
+
+		template<class... Args>
+		T& emplace_back(Args&&... args)
+		{
+			if(m_size < N && m_heap.empty())
+			{
+				auto& ret = m_inline[m_size];
+				ret = T{std::forward<Args>(args)...};
+				++m_size;
+				return ret;
+			}
+
+			if(m_heap.empty())
+			{
+				m_heap.reserve(2*N);
+				for(auto& item : m_inline)
+				{
+					m_heap.push_back(std::move(item));
+					item = T{};
+				}
+			}
+
+			++m_size;
+			return m_heap.emplace_back(std::forward<Args>(args)...);
+		}
+
+		T& push_back(T const& value)
+		{ return emplace_back(value); }
+
+		T& push_back(T&& value)
+		{ return emplace_back(std::move(value)); }
+
+		void clear()
+		{
+			if(m_heap.empty())
+			{
+				for(size_t k = 0; k != m_size; ++k)
+				{ m_inline[k] = T{}; }
+			}
+			m_heap.clear();
+			m_size = 0;
+		}
+
+		// Removes the element at `pos`, and moves the elements after it one step towards the front
+		void erase(T* pos)
+		{
+			assert(pos >= begin() && pos < end());
+			std::move(pos + 1, end(), pos);
+			if(m_heap.empty())
+			{ m_inline[m_size - 1] = T{}; }
+			else
+			{ m_heap.pop_back(); }
+			--m_size;
+		}
+
+		T* data()
+		{ return m_heap.empty()? std::data(m_inline) : std::data(m_heap); }
+
+		T const* data() const
+		{ return m_heap.empty()? std::data(m_inline) : std::data(m_heap); }
+
+		size_t size() const
+		{ return m_size; }
+
+		bool empty() const
+		{ return m_size == 0; }
+
+		bool is_inline() const
+		{ return m_heap.empty(); }
+
+		T* begin() { return data(); }
+		T* end() { return data() + m_size; }
+		T const* begin() const { return data(); }
+		T const* end() const { return data() + m_size; }
+
+		T& operator[](size_t index)
+		{
+			assert(index < m_size);
+			return data()[index];
+		}
+
+		T const& operator[](size_t index) const
+		{
+			assert(index < m_size);
+			return data()[index];
+		}
+
+	private:
+		std::array<T, N> m_inline;
+		std::vector<T> m_heap;
+		size_t m_size;
+	};
+}
+
+#endif
@@ -0,0 +1,83 @@
+//@	{"target":{"name":"small_vector.test"}}
+
+#include "./small_vector.hpp"
+
+#include <testfwk/testfwk.hpp>
+
+#include <memory>
+#include <string>
+
+TESTCASE(west_small_vector_push_back)
+{
+	west::small_vector<std::string, 2> vec;
+	EXPECT_EQ(vec.empty(), true);
+
+	vec.push_back("Foo");
+	vec.push_back("Bar");
+	EXPECT_EQ(vec.is_inline(), true);
+	EXPECT_EQ(std::size(vec), 2);
+
+	vec.push_back("Kaka");
+	EXPECT_EQ(vec.is_inline(), false);
+	REQUIRE_EQ(std::size(vec), 3);
+	EXPECT_EQ(vec[0], "Foo");
+	EXPECT_EQ(vec[1], "Bar");
+	EXPECT_EQ(vec[2], "Kaka");
+
+	auto copy = vec;
+	EXPECT_EQ(std::size(copy), 3);
+	EXPECT_EQ(copy[2], "Kaka");
+
+	auto moved = std::move(vec);
+	EXPECT_EQ(std::size(moved), 3);
+	EXPECT_EQ(std::size(vec), 0);
+	EXPECT_EQ(vec.is_inline(), true);
+
+	moved.clear();
+	EXPECT_EQ(moved.empty(), true);
+	moved.push_back("Bulle");
+	EXPECT_EQ(moved.is_inline(), true);
+	EXPECT_EQ(moved[0], "Bulle");
+}
+
+TESTCASE(west_small_vector_clear_releases_elements)
+{
+	auto const resource = std::make_shared<int>(1);
+
+	west::small_vector<std::shared_ptr<int>, 2> vec;
+	vec.push_back(resource);
+	vec.push_back(resource);
+	EXPECT_EQ(resource.use_count(), 3);
+	vec.clear();
+	EXPECT_EQ(resource.use_count(), 1);
+
+	vec.push_back(resource);
+	vec.push_back(resource);
+	vec.push_back(resource);
+	EXPECT_EQ(vec.is_inline(), false);
+	EXPECT_EQ(resource.use_count(), 4);
+	vec.clear();
+	EXPECT_EQ(resource.use_count(), 1);
+}
+
+TESTCASE(west_small_vector_erase)
+{
+	auto const resource = std::make_shared<int>(1);
+
+	west::small_vector<std::shared_ptr<int>, 2> vec;
+	vec.push_back(resource);
+	vec.push_back(nullptr);
+	vec.erase(std::begin(vec));
+	REQUIRE_EQ(std::size(vec), 1);
+	EXPECT_EQ(vec[0], nullptr);
+	EXPECT_EQ(resource.use_count(), 1);
+
+	vec.push_back(resource);
+	vec.push_back(nullptr);
+	EXPECT_EQ(vec.is_inline(), false);
+	vec.erase(std::begin(vec) + 1);
+	REQUIRE_EQ(std::size(vec), 2);
+	EXPECT_EQ(vec[0], nullptr);
+	EXPECT_EQ(vec[1], nullptr);
+	EXPECT_EQ(resource.use_count(), 1);
+}